@@ -156,6 +156,10 @@ static bool audio_driver_use_float                       = false;
 static bool audio_driver_active                          = false;
 static bool audio_driver_data_own                        = false;
 
+/* Set while frames are run that will never be heard,
+ * e.g. by run-ahead. */
+static bool audio_driver_suppressed                      = false;
+
 /**
  * compute_audio_buffer_statistics:
  *
@@ -305,7 +309,8 @@ static bool audio_driver_init_resampler(void)
          &audio_driver_resampler_data,
          &audio_driver_resampler,
          settings->audio.resampler,
-         audio_driver_data.source_ratio.original);
+         audio_driver_data.source_ratio.original,
+         (enum resampler_quality)settings->audio.resampler_quality);
 }
 
 static bool audio_driver_init_internal(bool audio_cb_inited)
@@ -466,6 +471,11 @@ error:
    return audio_driver_deinit();
 }
 
+void audio_driver_set_suppressed(bool state)
+{
+   audio_driver_suppressed = state;
+}
+
 void audio_driver_set_nonblocking_state(bool enable)
 {
    settings_t *settings = config_get_ptr();
@@ -627,6 +637,9 @@ static bool audio_driver_flush(const int16_t *data, size_t samples)
  **/
 void audio_driver_sample(int16_t left, int16_t right)
 {
+   if (audio_driver_suppressed)
+      return;
+
    audio_driver_output_samples_conv_buf[audio_driver_data_ptr++] = left;
    audio_driver_output_samples_conv_buf[audio_driver_data_ptr++] = right;
 
@@ -651,6 +664,9 @@ void audio_driver_sample(int16_t left, int16_t right)
  **/
 size_t audio_driver_sample_batch(const int16_t *data, size_t frames)
 {
+   if (audio_driver_suppressed)
+      return frames;
+
    if (frames > (AUDIO_CHUNK_SIZE_NONBLOCKING >> 1))
       frames = AUDIO_CHUNK_SIZE_NONBLOCKING >> 1;
 
@@ -712,8 +728,10 @@ void audio_driver_dsp_filter_free(void)
 
 void audio_driver_dsp_filter_init(const char *device)
 {
+   settings_t *settings = config_get_ptr();
+
    audio_driver_dsp = rarch_dsp_filter_new(
-         device, audio_driver_data.input);
+         device, audio_driver_data.input, settings->audio.dsp_threaded);
 
    if (!audio_driver_dsp)
       RARCH_ERR("[DSP]: Failed to initialize DSP filter \"%s\".\n", device);
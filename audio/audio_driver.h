@@ -145,6 +145,8 @@ void audio_driver_sample_rewind(int16_t left, int16_t right);
 
 size_t audio_driver_sample_batch_rewind(const int16_t *data, size_t frames);
 
+void audio_driver_set_suppressed(bool state);
+
 void audio_driver_set_volume_gain(float gain);
 
 void audio_driver_dsp_filter_free(void);
@@ -15,6 +15,8 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include <retro_miscellaneous.h>
 
@@ -26,6 +28,11 @@
 #include <features/features_cpu.h>
 #include <string/stdstring.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <queues/fifo_spsc.h>
+#endif
+
 #include "audio_dsp_filter.h"
 #include "audio_filters/dspfilter.h"
 
@@ -42,11 +49,62 @@ struct rarch_dsp_plug
    const struct dspfilter_implementation *impl;
 };
 
+/* Filters further down the chain are not counted separately. */
+#define DSP_PERF_COUNTERS 8
+
+/* Larger blocks are not queued to the worker,
+ * but processed on the calling thread. */
+#define DSP_THREAD_MAX_FRAMES 8192
+
 struct rarch_dsp_instance
 {
    const struct dspfilter_implementation *impl;
    void *impl_data;
+
+   /* NULL unless the plug implements API version 2 and
+    * can process its channels separately. */
+   dspfilter_process_channel_t process_channel;
+   struct retro_perf_counter *perf;
+};
+
+#ifdef HAVE_THREADS
+struct rarch_dsp_thread
+{
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+
+   /* Frame count followed by the samples of each block,
+    * and the output of the chain as a plain stream. */
+   fifo_spsc_t *in;
+   fifo_spsc_t *out;
+
+   /* Blocks handed to the worker, and blocks it finished. */
+   unsigned pushed;
+   unsigned done;
+   bool quit;
+
+   /* Block the worker currently runs the chain on. */
+   float *work;
+
+   /* Output collected for the caller. */
+   float *output;
+   size_t output_frames;
+   size_t output_capacity;
+
+   /* Right channel of filters with process_channel(). */
+   sthread_t *channel_thread;
+   slock_t *channel_lock;
+   scond_t *channel_cond;
+   const struct rarch_dsp_instance *channel_job;
+   float *channel_samples;
+   unsigned channel_frames;
+   bool channel_quit;
+
+   float *planar;
+   size_t planar_frames;
 };
+#endif
 
 struct rarch_dsp_filter
 {
@@ -57,8 +115,17 @@ struct rarch_dsp_filter
 
    struct rarch_dsp_instance *instances;
    unsigned num_instances;
+
+#ifdef HAVE_THREADS
+   struct rarch_dsp_thread *thread;
+#endif
 };
 
+/* Counters are registered for the lifetime of the process,
+ * so they can not live in the filter chain itself. */
+static struct retro_perf_counter dsp_perf[DSP_PERF_COUNTERS];
+static char dsp_perf_ident[DSP_PERF_COUNTERS][64];
+
 static const struct dspfilter_implementation *find_implementation(
       rarch_dsp_filter_t *dsp, const char *ident)
 {
@@ -121,6 +188,23 @@ static bool create_filter_graph(rarch_dsp_filter_t *dsp, float sample_rate)
       dsp->instances[i].impl_data = dsp->instances[i].impl->init(&info, &dspfilter_config, &userdata);
       if (!dsp->instances[i].impl_data)
          return false;
+
+      if (dsp->instances[i].impl->api_version >= 2)
+         dsp->instances[i].process_channel =
+            dsp->instances[i].impl->process_channel;
+
+      if (i < DSP_PERF_COUNTERS)
+      {
+         struct retro_perf_counter *perf = &dsp_perf[i];
+
+         snprintf(dsp_perf_ident[i], sizeof(dsp_perf_ident[i]),
+               "audio_dsp_%u_%s", i, dsp->instances[i].impl->short_ident);
+
+         perf->total    = 0;
+         perf->call_cnt = 0;
+         performance_counter_init(perf, dsp_perf_ident[i]);
+         dsp->instances[i].perf = perf;
+      }
    }
 
    return true;
@@ -198,7 +282,8 @@ static bool append_plugs(rarch_dsp_filter_t *dsp, struct string_list *list)
          continue;
       }
 
-      if (impl->api_version != DSPFILTER_API_VERSION)
+      /* Version 2 only added fields at the end. */
+      if (impl->api_version < 1 || impl->api_version > DSPFILTER_API_VERSION)
       {
          dylib_close(lib);
          continue;
@@ -224,8 +309,378 @@ static bool append_plugs(rarch_dsp_filter_t *dsp, struct string_list *list)
 }
 #endif
 
+#ifdef HAVE_THREADS
+static bool dsp_thread_reserve(float **buf, size_t *capacity, size_t frames)
+{
+   float *new_buf = NULL;
+
+   if (frames <= *capacity)
+      return true;
+
+   new_buf = (float*)realloc(*buf, frames * 2 * sizeof(float));
+   if (!new_buf)
+      return false;
+
+   *buf      = new_buf;
+   *capacity = frames;
+   return true;
+}
+
+static void dsp_channel_thread_loop(void *data)
+{
+   struct rarch_dsp_thread *t = (struct rarch_dsp_thread*)data;
+
+   slock_lock(t->channel_lock);
+
+   for (;;)
+   {
+      const struct rarch_dsp_instance *inst = NULL;
+
+      while (!t->channel_job && !t->channel_quit)
+         scond_wait(t->channel_cond, t->channel_lock);
+
+      if (t->channel_quit)
+         break;
+
+      inst = t->channel_job;
+      slock_unlock(t->channel_lock);
+
+      inst->process_channel(inst->impl_data, 1,
+            t->channel_samples, t->channel_frames);
+
+      slock_lock(t->channel_lock);
+      t->channel_job = NULL;
+      scond_signal(t->channel_cond);
+   }
+
+   slock_unlock(t->channel_lock);
+}
+
+/* Splits the block into planar channels and runs
+ * the right one on the channel thread. */
+static bool dsp_process_channels(struct rarch_dsp_thread *t,
+      const struct rarch_dsp_instance *inst, float *samples, unsigned frames)
+{
+   unsigned i;
+   float *left, *right;
+
+   if (!dsp_thread_reserve(&t->planar, &t->planar_frames, frames))
+      return false;
+
+   left  = t->planar;
+   right = t->planar + frames;
+
+   for (i = 0; i < frames; i++)
+   {
+      left[i]  = samples[2 * i + 0];
+      right[i] = samples[2 * i + 1];
+   }
+
+   slock_lock(t->channel_lock);
+   t->channel_job     = inst;
+   t->channel_samples = right;
+   t->channel_frames  = frames;
+   scond_signal(t->channel_cond);
+   slock_unlock(t->channel_lock);
+
+   inst->process_channel(inst->impl_data, 0, left, frames);
+
+   slock_lock(t->channel_lock);
+   while (t->channel_job)
+      scond_wait(t->channel_cond, t->channel_lock);
+   slock_unlock(t->channel_lock);
+
+   for (i = 0; i < frames; i++)
+   {
+      samples[2 * i + 0] = left[i];
+      samples[2 * i + 1] = right[i];
+   }
+
+   return true;
+}
+#endif
+
+static void dsp_run_chain(rarch_dsp_filter_t *dsp,
+      struct dspfilter_output *output)
+{
+   unsigned i;
+   struct dspfilter_input input = {0};
+
+   for (i = 0; i < dsp->num_instances; i++)
+   {
+      const struct rarch_dsp_instance *inst = &dsp->instances[i];
+
+      input.samples = output->samples;
+      input.frames  = output->frames;
+
+      performance_counter_start(inst->perf);
+
+#ifdef HAVE_THREADS
+      if (dsp->thread && inst->process_channel && input.frames
+            && dsp_process_channels(dsp->thread, inst,
+               input.samples, input.frames))
+      {
+         performance_counter_stop(inst->perf);
+         continue;
+      }
+#endif
+
+      inst->impl->process(inst->impl_data, output, &input);
+      performance_counter_stop(inst->perf);
+   }
+}
+
+#ifdef HAVE_THREADS
+static void dsp_thread_write_output(struct rarch_dsp_thread *t,
+      const float *samples, unsigned frames)
+{
+   const uint8_t *src = (const uint8_t*)samples;
+   size_t size        = frames * 2 * sizeof(float);
+
+   for (;;)
+   {
+      size_t written = fifo_spsc_write(t->out, src, size);
+
+      src  += written;
+      size -= written;
+
+      if (!size)
+         return;
+
+      /* The caller drains the ring while it waits for us. */
+      slock_lock(t->lock);
+      while (!t->quit && !fifo_spsc_write_avail(t->out))
+      {
+         scond_broadcast(t->cond);
+         scond_wait(t->cond, t->lock);
+      }
+      if (t->quit)
+      {
+         slock_unlock(t->lock);
+         return;
+      }
+      slock_unlock(t->lock);
+   }
+}
+
+static void dsp_thread_loop(void *data)
+{
+   rarch_dsp_filter_t *dsp    = (rarch_dsp_filter_t*)data;
+   struct rarch_dsp_thread *t = dsp->thread;
+
+   slock_lock(t->lock);
+
+   for (;;)
+   {
+      unsigned frames = 0;
+      struct dspfilter_output output;
+
+      while (!t->quit && t->done == t->pushed)
+         scond_wait(t->cond, t->lock);
+
+      if (t->quit)
+         break;
+
+      slock_unlock(t->lock);
+
+      fifo_spsc_read(t->in, &frames, sizeof(frames));
+      fifo_spsc_read(t->in, t->work, frames * 2 * sizeof(float));
+
+      output.samples = t->work;
+      output.frames  = frames;
+      dsp_run_chain(dsp, &output);
+
+      dsp_thread_write_output(t, output.samples, output.frames);
+
+      slock_lock(t->lock);
+      t->done++;
+      scond_broadcast(t->cond);
+   }
+
+   slock_unlock(t->lock);
+}
+
+/* Moves whatever the worker produced so far to the output buffer. */
+static void dsp_thread_drain(struct rarch_dsp_thread *t)
+{
+   size_t frames = fifo_spsc_read_avail(t->out) / (2 * sizeof(float));
+
+   if (!frames)
+      return;
+
+   if (!dsp_thread_reserve(&t->output, &t->output_capacity,
+            t->output_frames + frames))
+      return;
+
+   fifo_spsc_read(t->out, t->output + t->output_frames * 2,
+         frames * 2 * sizeof(float));
+   t->output_frames += frames;
+}
+
+/* Waits until the worker finished block @target.
+ * Must be called with the lock held. */
+static void dsp_thread_wait(struct rarch_dsp_thread *t, unsigned target)
+{
+   while ((int)(t->done - target) < 0)
+   {
+      slock_unlock(t->lock);
+      dsp_thread_drain(t);
+      slock_lock(t->lock);
+
+      /* The worker might be waiting for room in the output ring. */
+      scond_broadcast(t->cond);
+
+      if ((int)(t->done - target) < 0)
+         scond_wait(t->cond, t->lock);
+   }
+}
+
+static void dsp_thread_process(rarch_dsp_filter_t *dsp,
+      struct rarch_dsp_data *data)
+{
+   struct rarch_dsp_thread *t = dsp->thread;
+   unsigned frames            = data->input_frames;
+
+   t->output_frames           = 0;
+
+   if (frames <= DSP_THREAD_MAX_FRAMES)
+   {
+      /* At most one block is still queued, so this always fits. */
+      fifo_spsc_write(t->in, &frames, sizeof(frames));
+      fifo_spsc_write(t->in, data->input, frames * 2 * sizeof(float));
+
+      slock_lock(t->lock);
+      t->pushed++;
+      scond_broadcast(t->cond);
+
+      /* Only wait for the previous block. This one
+       * is returned on the next call. */
+      dsp_thread_wait(t, t->pushed - 1);
+      slock_unlock(t->lock);
+
+      dsp_thread_drain(t);
+   }
+   else
+   {
+      struct dspfilter_output output;
+
+      slock_lock(t->lock);
+      dsp_thread_wait(t, t->pushed);
+      slock_unlock(t->lock);
+
+      dsp_thread_drain(t);
+
+      output.samples = data->input;
+      output.frames  = frames;
+      dsp_run_chain(dsp, &output);
+
+      if (dsp_thread_reserve(&t->output, &t->output_capacity,
+               t->output_frames + output.frames))
+      {
+         memcpy(t->output + t->output_frames * 2, output.samples,
+               output.frames * 2 * sizeof(float));
+         t->output_frames += output.frames;
+      }
+   }
+
+   data->output        = t->output;
+   data->output_frames = t->output_frames;
+}
+
+static void dsp_thread_free(struct rarch_dsp_thread *t)
+{
+   if (t->thread)
+   {
+      slock_lock(t->lock);
+      t->quit = true;
+      scond_broadcast(t->cond);
+      slock_unlock(t->lock);
+      sthread_join(t->thread);
+   }
+
+   if (t->channel_thread)
+   {
+      slock_lock(t->channel_lock);
+      t->channel_quit = true;
+      scond_signal(t->channel_cond);
+      slock_unlock(t->channel_lock);
+      sthread_join(t->channel_thread);
+   }
+
+   if (t->cond)
+      scond_free(t->cond);
+   if (t->lock)
+      slock_free(t->lock);
+   if (t->channel_cond)
+      scond_free(t->channel_cond);
+   if (t->channel_lock)
+      slock_free(t->channel_lock);
+
+   fifo_spsc_free(t->in);
+   fifo_spsc_free(t->out);
+
+   free(t->work);
+   free(t->output);
+   free(t->planar);
+   free(t);
+}
+
+static bool dsp_thread_init(rarch_dsp_filter_t *dsp)
+{
+   unsigned i;
+   bool separable             = false;
+   size_t block               = sizeof(unsigned) +
+      DSP_THREAD_MAX_FRAMES * 2 * sizeof(float);
+   struct rarch_dsp_thread *t = (struct rarch_dsp_thread*)
+      calloc(1, sizeof(*t));
+
+   if (!t)
+      return false;
+
+   dsp->thread = t;
+
+   t->lock     = slock_new();
+   t->cond     = scond_new();
+   /* Room for the block the worker is on and the next one. */
+   t->in       = fifo_spsc_new(2 * block);
+   t->out      = fifo_spsc_new(4 * DSP_THREAD_MAX_FRAMES * 2 * sizeof(float));
+   t->work     = (float*)malloc(DSP_THREAD_MAX_FRAMES * 2 * sizeof(float));
+
+   if (!t->lock || !t->cond || !t->in || !t->out || !t->work)
+      goto error;
+
+   for (i = 0; i < dsp->num_instances; i++)
+      if (dsp->instances[i].process_channel)
+         separable = true;
+
+   if (separable)
+   {
+      t->channel_lock   = slock_new();
+      t->channel_cond   = scond_new();
+
+      if (!t->channel_lock || !t->channel_cond)
+         goto error;
+
+      t->channel_thread = sthread_create(dsp_channel_thread_loop, t);
+      if (!t->channel_thread)
+         goto error;
+   }
+
+   t->thread = sthread_create(dsp_thread_loop, dsp);
+   if (!t->thread)
+      goto error;
+
+   return true;
+
+error:
+   dsp_thread_free(t);
+   dsp->thread = NULL;
+   return false;
+}
+#endif
+
 rarch_dsp_filter_t *rarch_dsp_filter_new(
-      const char *filter_config, float sample_rate)
+      const char *filter_config, float sample_rate, bool threaded)
 {
 #if !defined(HAVE_FILTERS_BUILTIN) && defined(HAVE_DYLIB)
    char basedir[PATH_MAX_LENGTH];
@@ -265,6 +720,14 @@ rarch_dsp_filter_t *rarch_dsp_filter_new(
    if (!create_filter_graph(dsp, sample_rate))
       goto error;
 
+#ifdef HAVE_THREADS
+   /* Not fatal, the chain then just runs on the caller. */
+   if (threaded && dsp->num_instances)
+      dsp_thread_init(dsp);
+#else
+   (void)threaded;
+#endif
+
    return dsp;
 
 error:
@@ -280,6 +743,11 @@ void rarch_dsp_filter_free(rarch_dsp_filter_t *dsp)
    if (!dsp)
       return;
 
+#ifdef HAVE_THREADS
+   if (dsp->thread)
+      dsp_thread_free(dsp->thread);
+#endif
+
    for (i = 0; i < dsp->num_instances; i++)
    {
       if (dsp->instances[i].impl_data && dsp->instances[i].impl)
@@ -305,20 +773,20 @@ void rarch_dsp_filter_free(rarch_dsp_filter_t *dsp)
 void rarch_dsp_filter_process(rarch_dsp_filter_t *dsp,
       struct rarch_dsp_data *data)
 {
-   unsigned i;
    struct dspfilter_output output = {0};
-   struct dspfilter_input input   = {0};
+
+#ifdef HAVE_THREADS
+   if (dsp->thread)
+   {
+      dsp_thread_process(dsp, data);
+      return;
+   }
+#endif
 
    output.samples = data->input;
    output.frames  = data->input_frames;
 
-   for (i = 0; i < dsp->num_instances; i++)
-   {
-      input.samples = output.samples;
-      input.frames  = output.frames;
-      dsp->instances[i].impl->process(
-            dsp->instances[i].impl_data, &output, &input);
-   }
+   dsp_run_chain(dsp, &output);
 
    data->output        = output.samples;
    data->output_frames = output.frames;
@@ -18,13 +18,29 @@
 #define __AUDIO_DSP_FILTER_H__
 
 #include <retro_common_api.h>
+#include <boolean.h>
 
 RETRO_BEGIN_DECLS
 
 typedef struct rarch_dsp_filter rarch_dsp_filter_t;
 
+/**
+ * rarch_dsp_filter_new:
+ * @filter_config      : path to the .dsp filter chain config.
+ * @sample_rate        : input sample rate.
+ * @threaded           : run the chain on a worker thread.
+ *
+ * When @threaded is set, rarch_dsp_filter_process() hands each
+ * block to a worker thread and returns the output of the previous
+ * block, so the chain costs one block of latency but barely any
+ * time on the calling thread. Filters which can process their
+ * channels separately then also do so on two threads. Without
+ * threading support, @threaded is ignored.
+ *
+ * Returns: new DSP filter chain, or NULL on failure.
+ **/
 rarch_dsp_filter_t *rarch_dsp_filter_new(const char *filter_config,
-      float sample_rate);
+      float sample_rate, bool threaded);
 
 void rarch_dsp_filter_free(rarch_dsp_filter_t *dsp);
 
@@ -53,7 +53,7 @@ typedef const struct dspfilter_implementation *(
 const struct dspfilter_implementation *dspfilter_get_implementation(
       dspfilter_simd_mask_t mask);
 
-#define DSPFILTER_API_VERSION 1
+#define DSPFILTER_API_VERSION 2
 
 struct dspfilter_info
 {
@@ -160,6 +160,13 @@ typedef void (*dspfilter_free_t)(void *data);
 typedef void (*dspfilter_process_t)(void *data,
       struct dspfilter_output *output, const struct dspfilter_input *input);
 
+/* Processes a single channel in place.
+ * @channel is 0 for the left and 1 for the right channel.
+ * @samples holds @frames samples of that channel only,
+ * not interleaved. */
+typedef void (*dspfilter_process_channel_t)(void *data,
+      unsigned channel, float *samples, unsigned frames);
+
 struct dspfilter_implementation
 {
    dspfilter_init_t     init;
@@ -175,6 +182,15 @@ struct dspfilter_implementation
    /* Computer-friendly short version of ident.
     * Lower case, no spaces and special characters, etc. */
    const char *short_ident; 
+
+   /* Since API version 2. Optional, can be NULL.
+    *
+    * Filters which treat the two channels independently and
+    * output exactly one frame per input frame can implement this.
+    * The host may then process both channels at the same time
+    * on different threads. Both calls must give the same result
+    * as process() would have. */
+   dspfilter_process_channel_t process_channel;
 };
 
 RETRO_END_DECLS
@@ -154,6 +154,65 @@ static void make_poly_from_roots(
          poly[j] -= poly[j - 1] * roots[i];
 }
 
+static void iir_process_channel(void *data, unsigned channel,
+      float *samples, unsigned frames)
+{
+   unsigned i;
+   float b0, b1, b2, a0, a1, a2;
+   float xn1, xn2, yn1, yn2;
+   struct iir_data *iir = (struct iir_data*)data;
+
+   b0  = iir->b0;
+   b1  = iir->b1;
+   b2  = iir->b2;
+   a0  = iir->a0;
+   a1  = iir->a1;
+   a2  = iir->a2;
+
+   if (channel)
+   {
+      xn1 = iir->r.xn1;
+      xn2 = iir->r.xn2;
+      yn1 = iir->r.yn1;
+      yn2 = iir->r.yn2;
+   }
+   else
+   {
+      xn1 = iir->l.xn1;
+      xn2 = iir->l.xn2;
+      yn1 = iir->l.yn1;
+      yn2 = iir->l.yn2;
+   }
+
+   for (i = 0; i < frames; i++)
+   {
+      float in  = samples[i];
+      float out = (b0 * in + b1 * xn1 + b2 * xn2 - a1 * yn1 - a2 * yn2) / a0;
+
+      xn2 = xn1;
+      xn1 = in;
+      yn2 = yn1;
+      yn1 = out;
+
+      samples[i] = out;
+   }
+
+   if (channel)
+   {
+      iir->r.xn1 = xn1;
+      iir->r.xn2 = xn2;
+      iir->r.yn1 = yn1;
+      iir->r.yn2 = yn2;
+   }
+   else
+   {
+      iir->l.xn1 = xn1;
+      iir->l.xn2 = xn2;
+      iir->l.yn1 = yn1;
+      iir->l.yn2 = yn2;
+   }
+}
+
 static void iir_filter_init(struct iir_data *iir,
       float sample_rate, float freq, float qual, float gain, enum IIRFilter filter_type)
 {
@@ -353,6 +412,7 @@ static const struct dspfilter_implementation iir_plug = {
    DSPFILTER_API_VERSION,
    "IIR",
    "iir",
+   iir_process_channel,
 };
 
 #ifdef HAVE_FILTERS_BUILTIN
@@ -261,6 +261,17 @@ static void reverb_process(void *data, struct dspfilter_output *output,
    }
 }
 
+static void reverb_process_channel(void *data, unsigned channel,
+      float *samples, unsigned frames)
+{
+   unsigned i;
+   struct reverb_data *rev = (struct reverb_data*)data;
+   struct revmodel *model  = channel ? &rev->right : &rev->left;
+
+   for (i = 0; i < frames; i++)
+      samples[i] = revmodel_process(model, samples[i]);
+}
+
 static void *reverb_init(const struct dspfilter_info *info,
       const struct dspfilter_config *config, void *userdata)
 {
@@ -302,6 +313,7 @@ static const struct dspfilter_implementation reverb_plug = {
    DSPFILTER_API_VERSION,
    "Reverb",
    "reverb",
+   reverb_process_channel,
 };
 
 #ifdef HAVE_FILTERS_BUILTIN
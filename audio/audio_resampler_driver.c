@@ -131,6 +131,7 @@ static resampler_simd_mask_t resampler_get_cpu_features(void)
  * @re                         : Resampler handle
  * @backend                    : Resampler backend that is about to be set.
  * @bw_ratio                   : Bandwidth ratio.
+ * @quality                    : Requested quality level.
  *
  * Initializes resampler driver based on queried CPU features.
  *
@@ -138,11 +139,11 @@ static resampler_simd_mask_t resampler_get_cpu_features(void)
  **/
 static bool resampler_append_plugs(void **re,
       const rarch_resampler_t **backend,
-      double bw_ratio)
+      double bw_ratio, enum resampler_quality quality)
 {
    resampler_simd_mask_t mask = resampler_get_cpu_features();
 
-   *re = (*backend)->init(&resampler_config, bw_ratio, mask);
+   *re = (*backend)->init(&resampler_config, bw_ratio, quality, mask);
 
    if (!*re)
       return false;
@@ -155,6 +156,7 @@ static bool resampler_append_plugs(void **re,
  * @backend                    : Resampler backend that is about to be set.
  * @ident                      : Identifier name for resampler we want.
  * @bw_ratio                   : Bandwidth ratio.
+ * @quality                    : Requested quality level.
  *
  * Reallocates resampler. Will free previous handle before 
  * allocating a new one. If ident is NULL, first resampler will be used.
@@ -162,7 +164,7 @@ static bool resampler_append_plugs(void **re,
  * Returns: true (1) if successful, otherwise false (0).
  **/
 bool rarch_resampler_realloc(void **re, const rarch_resampler_t **backend,
-      const char *ident, double bw_ratio)
+      const char *ident, double bw_ratio, enum resampler_quality quality)
 {
    if (*re && *backend)
       (*backend)->free(*re);
@@ -170,7 +172,7 @@ bool rarch_resampler_realloc(void **re, const rarch_resampler_t **backend,
    *re      = NULL;
    *backend = find_resampler_driver(ident);
 
-   if (!resampler_append_plugs(re, backend, bw_ratio))
+   if (!resampler_append_plugs(re, backend, bw_ratio, quality))
       goto error;
 
    return true;
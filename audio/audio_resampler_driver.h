@@ -41,6 +41,7 @@ RETRO_BEGIN_DECLS
 #define RESAMPLER_SIMD_AVX2     (1 << 12)
 #define RESAMPLER_SIMD_VFPU     (1 << 13)
 #define RESAMPLER_SIMD_PS       (1 << 14)
+#define RESAMPLER_SIMD_FMA      (1 << 24)
 
 /* A bit-mask of all supported SIMD instruction sets.
  * Allows an implementation to pick different 
@@ -48,7 +49,20 @@ RETRO_BEGIN_DECLS
  */
 typedef unsigned resampler_simd_mask_t;
 
-#define RESAMPLER_API_VERSION 1
+#define RESAMPLER_API_VERSION 2
+
+/* Cost/quality tradeoff asked of a resampler.
+ * Backends with a single setting ignore it. */
+enum resampler_quality
+{
+   /* Whatever the backend considers its default. */
+   RESAMPLER_QUALITY_DONTCARE = 0,
+   RESAMPLER_QUALITY_LOWEST,
+   RESAMPLER_QUALITY_LOWER,
+   RESAMPLER_QUALITY_NORMAL,
+   RESAMPLER_QUALITY_HIGHER,
+   RESAMPLER_QUALITY_HIGHEST
+};
 
 struct resampler_data
 {
@@ -103,7 +117,8 @@ struct resampler_config
 /* Bandwidth factor. Will be < 1.0 for downsampling, > 1.0 for upsampling. 
  * Corresponds to expected resampling ratio. */
 typedef void *(*resampler_init_t)(const struct resampler_config *config,
-      double bandwidth_mod, resampler_simd_mask_t mask);
+      double bandwidth_mod, enum resampler_quality quality,
+      resampler_simd_mask_t mask);
 
 /* Frees the handle. */
 typedef void (*resampler_free_t)(void *data);
@@ -172,6 +187,7 @@ const char *audio_resampler_driver_find_ident(int index);
  * @backend                    : Resampler backend that is about to be set.
  * @ident                      : Identifier name for resampler we want.
  * @bw_ratio                   : Bandwidth ratio.
+ * @quality                    : Requested quality level.
  *
  * Reallocates resampler. Will free previous handle before 
  * allocating a new one. If ident is NULL, first resampler will be used.
@@ -179,7 +195,7 @@ const char *audio_resampler_driver_find_ident(int index);
  * Returns: true (1) if successful, otherwise false (0).
  **/
 bool rarch_resampler_realloc(void **re, const rarch_resampler_t **backend,
-      const char *ident, double bw_ratio);
+      const char *ident, double bw_ratio, enum resampler_quality quality);
 
 RETRO_END_DECLS
 
@@ -21,7 +21,7 @@
 #include <alsa/asoundlib.h>
 
 #include <rthreads/rthreads.h>
-#include <queues/fifo_queue.h>
+#include <queues/fifo_spsc.h>
 #include <string/stdstring.h>
 
 #include "../audio_driver.h"
@@ -44,9 +44,10 @@ typedef struct alsa_thread
    size_t period_size;
    snd_pcm_uframes_t period_frames;
 
-   fifo_buffer_t *buffer;
+   /* Lock-free, the locks below are only used for
+    * blocking writes while the FIFO is full. */
+   fifo_spsc_t *buffer;
    sthread_t *worker_thread;
-   slock_t *fifo_lock;
    scond_t *cond;
    slock_t *cond_lock;
 } alsa_thread_t;
@@ -64,15 +65,14 @@ static void alsa_worker_thread(void *data)
 
    while (!alsa->thread_dead)
    {
-      size_t avail;
       size_t fifo_size;
       snd_pcm_sframes_t frames;
-      slock_lock(alsa->fifo_lock);
-      avail = fifo_read_avail(alsa->buffer);
-      fifo_size = MIN(alsa->period_size, avail);
-      fifo_read(alsa->buffer, buf, fifo_size);
+
+      fifo_size = fifo_spsc_read(alsa->buffer, buf, alsa->period_size);
+
+      slock_lock(alsa->cond_lock);
       scond_signal(alsa->cond);
-      slock_unlock(alsa->fifo_lock);
+      slock_unlock(alsa->cond_lock);
 
       /* If underrun, fill rest with silence. */
       memset(buf + fifo_size, 0, alsa->period_size - fifo_size);
@@ -139,11 +139,9 @@ static void alsa_thread_free(void *data)
          sthread_join(alsa->worker_thread);
       }
       if (alsa->buffer)
-         fifo_free(alsa->buffer);
+         fifo_spsc_free(alsa->buffer);
       if (alsa->cond)
          scond_free(alsa->cond);
-      if (alsa->fifo_lock)
-         slock_free(alsa->fifo_lock);
       if (alsa->cond_lock)
          slock_free(alsa->cond_lock);
       if (alsa->pcm)
@@ -214,11 +212,10 @@ static void *alsa_thread_init(const char *device,
    snd_pcm_hw_params_free(params);
    snd_pcm_sw_params_free(sw_params);
 
-   alsa->fifo_lock = slock_new();
    alsa->cond_lock = slock_new();
    alsa->cond = scond_new();
-   alsa->buffer = fifo_new(alsa->buffer_size);
-   if (!alsa->fifo_lock || !alsa->cond_lock || !alsa->cond || !alsa->buffer)
+   alsa->buffer = fifo_spsc_new(alsa->buffer_size);
+   if (!alsa->cond_lock || !alsa->cond || !alsa->buffer)
       goto error;
 
    alsa->worker_thread = sthread_create(alsa_worker_thread, alsa);
@@ -251,44 +248,26 @@ static ssize_t alsa_thread_write(void *data, const void *buf, size_t size)
       return -1;
 
    if (alsa->nonblock)
-   {
-      size_t avail;
-      size_t write_amt;
-
-      slock_lock(alsa->fifo_lock);
-      avail           = fifo_write_avail(alsa->buffer);
-      write_amt       = MIN(avail, size);
-
-      fifo_write(alsa->buffer, buf, write_amt);
-      slock_unlock(alsa->fifo_lock);
-
-      return write_amt;
-   }
+      return fifo_spsc_write(alsa->buffer, buf, size);
    else
    {
       size_t written = 0;
       while (written < size && !alsa->thread_dead)
       {
-         size_t avail;
-         slock_lock(alsa->fifo_lock);
-         avail = fifo_write_avail(alsa->buffer);
+         size_t write_amt = fifo_spsc_write(alsa->buffer,
+               (const char*)buf + written, size - written);
 
-         if (avail == 0)
+         if (write_amt == 0)
          {
-            slock_unlock(alsa->fifo_lock);
+            /* Recheck under the lock, the worker signals after
+             * every read while holding it. */
             slock_lock(alsa->cond_lock);
-            if (!alsa->thread_dead)
+            if (!alsa->thread_dead && !fifo_spsc_write_avail(alsa->buffer))
                scond_wait(alsa->cond, alsa->cond_lock);
             slock_unlock(alsa->cond_lock);
          }
-         else
-         {
-            size_t write_amt = MIN(size - written, avail);
-            fifo_write(alsa->buffer,
-                  (const char*)buf + written, write_amt);
-            slock_unlock(alsa->fifo_lock);
-            written += write_amt;
-         }
+
+         written += write_amt;
       }
       return written;
    }
@@ -329,14 +308,10 @@ static bool alsa_thread_start(void *data)
 static size_t alsa_thread_write_avail(void *data)
 {
    alsa_thread_t *alsa = (alsa_thread_t*)data;
-   size_t val;
 
    if (alsa->thread_dead)
       return 0;
-   slock_lock(alsa->fifo_lock);
-   val = fifo_write_avail(alsa->buffer);
-   slock_unlock(alsa->fifo_lock);
-   return val;
+   return fifo_spsc_write_avail(alsa->buffer);
 }
 
 static size_t alsa_thread_buffer_size(void *data)
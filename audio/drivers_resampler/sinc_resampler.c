@@ -30,78 +30,78 @@
 
 #include "../audio_resampler_driver.h"
 
-/* Rough SNR values for upsampling:
- * LOWEST: 40 dB
- * LOWER: 55 dB
- * NORMAL: 70 dB
- * HIGHER: 110 dB
- * HIGHEST: 140 dB
- */
+/* The AVX kernels are built with target attributes, so one
+ * binary can use them when the CPU has them. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HAVE_SINC_AVX
+#include <immintrin.h>
+#endif
 
-/* TODO, make all this more configurable. */
+/* Intrinsics need a compiler targeting NEON. Android ARMv7 builds
+ * only define __ARM_NEON__ and fall back to the assembly kernel. */
+#if defined(__ARM_NEON)
+#define HAVE_SINC_NEON
+#include <arm_neon.h>
+#elif defined(__ARM_NEON__)
+#define HAVE_SINC_NEON_ASM
+#endif
+
+/* Builds which used to pick a quality at compile time
+ * keep it as the default. */
 #if defined(SINC_LOWEST_QUALITY)
-#define SINC_WINDOW_LANCZOS
-#define CUTOFF 0.98
-#define PHASE_BITS 12
-#define SINC_COEFF_LERP 0
-#define SUBPHASE_BITS 10
-#define SIDELOBES 2
-#define ENABLE_AVX 0
+#define SINC_DEFAULT_QUALITY RESAMPLER_QUALITY_LOWEST
 #elif defined(SINC_LOWER_QUALITY)
-#define SINC_WINDOW_LANCZOS
-#define CUTOFF 0.98
-#define PHASE_BITS 12
-#define SUBPHASE_BITS 10
-#define SINC_COEFF_LERP 0
-#define SIDELOBES 4
-#define ENABLE_AVX 0
+#define SINC_DEFAULT_QUALITY RESAMPLER_QUALITY_LOWER
 #elif defined(SINC_HIGHER_QUALITY)
-#define SINC_WINDOW_KAISER
-#define SINC_WINDOW_KAISER_BETA 10.5
-#define CUTOFF 0.90
-#define PHASE_BITS 10
-#define SUBPHASE_BITS 14
-#define SINC_COEFF_LERP 1
-#define SIDELOBES 32
-#define ENABLE_AVX 1
+#define SINC_DEFAULT_QUALITY RESAMPLER_QUALITY_HIGHER
 #elif defined(SINC_HIGHEST_QUALITY)
-#define SINC_WINDOW_KAISER
-#define SINC_WINDOW_KAISER_BETA 14.5
-#define CUTOFF 0.962
-#define PHASE_BITS 10
-#define SUBPHASE_BITS 14
-#define SINC_COEFF_LERP 1
-#define SIDELOBES 128
-#define ENABLE_AVX 1
+#define SINC_DEFAULT_QUALITY RESAMPLER_QUALITY_HIGHEST
 #else
-#define SINC_WINDOW_KAISER
-#define SINC_WINDOW_KAISER_BETA 5.5
-#define CUTOFF 0.825
-#define PHASE_BITS 8
-#define SUBPHASE_BITS 16
-#define SINC_COEFF_LERP 1
-#define SIDELOBES 8
-#define ENABLE_AVX 0
+#define SINC_DEFAULT_QUALITY RESAMPLER_QUALITY_NORMAL
 #endif
 
-/* For the little amount of taps we're using,
- * SSE1 is faster than AVX for some reason.
- * AVX code is kept here though as by increasing number
- * of sinc taps, the AVX code is clearly faster than SSE1.
- */
+/* For the little amount of taps the lower levels use,
+ * SSE1 is faster than AVX. */
+#define SINC_AVX_MIN_TAPS 32
 
-#if defined(__AVX__) && ENABLE_AVX
-#include <immintrin.h>
-#endif
+enum sinc_window
+{
+   SINC_WINDOW_LANCZOS = 0,
+   SINC_WINDOW_KAISER
+};
 
-#define PHASES (1 << (PHASE_BITS + SUBPHASE_BITS))
+struct sinc_quality
+{
+   enum sinc_window window;
+   double kaiser_beta;
+   double cutoff;
+   unsigned phase_bits;
+   unsigned subphase_bits;
+   unsigned sidelobes;
+   bool lerp;
+};
 
-#define TAPS (SIDELOBES * 2)
-#define SUBPHASE_MASK ((1 << SUBPHASE_BITS) - 1)
-#define SUBPHASE_MOD (1.0f / (1 << SUBPHASE_BITS))
+/* Indexed by resampler_quality - 1.
+ * Rough SNR values for upsampling:
+ * LOWEST: 40 dB
+ * LOWER: 55 dB
+ * NORMAL: 70 dB
+ * HIGHER: 110 dB
+ * HIGHEST: 140 dB
+ */
+static const struct sinc_quality sinc_qualities[] = {
+   { SINC_WINDOW_LANCZOS, 0.0,  0.98,  12, 10,   2, false },
+   { SINC_WINDOW_LANCZOS, 0.0,  0.98,  12, 10,   4, false },
+   { SINC_WINDOW_KAISER,  5.5,  0.825,  8, 16,   8, true  },
+   { SINC_WINDOW_KAISER,  10.5, 0.90,  10, 14,  32, true  },
+   { SINC_WINDOW_KAISER,  14.5, 0.962, 10, 14, 128, true  },
+};
 
 typedef struct rarch_sinc_resampler
 {
+   void (*process_sinc)(struct rarch_sinc_resampler *resamp,
+         float *out_buffer);
+
    float *phase_table;
    float *buffer_l;
    float *buffer_r;
@@ -111,25 +111,30 @@ typedef struct rarch_sinc_resampler
    unsigned ptr;
    uint32_t time;
 
+   unsigned subphase_bits;
+   uint32_t subphase_mask;
+   float subphase_mod;
+   uint32_t phases;
+
    /* A buffer for phase_table, buffer_l and buffer_r 
     * are created in a single calloc().
     * Ensure that we get as good cache locality as we can hope for. */
    float *main_buffer;
 } rarch_sinc_resampler_t;
 
-#if defined(SINC_WINDOW_LANCZOS)
-#define window_function(idx)  (lanzcos_window_function(idx))
-#elif defined(SINC_WINDOW_KAISER)
-#define window_function(idx)  (kaiser_window_function(idx, SINC_WINDOW_KAISER_BETA))
-#else
-#error "No SINC window function defined."
-#endif
+static double sinc_window_function(const struct sinc_quality *q,
+      double idx)
+{
+   if (q->window == SINC_WINDOW_KAISER)
+      return kaiser_window_function(idx, q->kaiser_beta);
+   return lanzcos_window_function(idx);
+}
 
-static void init_sinc_table(rarch_sinc_resampler_t *resamp, double cutoff,
+static void init_sinc_table(const struct sinc_quality *q, double cutoff,
       float *phase_table, int phases, int taps, bool calculate_delta)
 {
    int i, j;
-   double    window_mod = window_function(0.0); /* Need to normalize w(0) to 1.0. */
+   double    window_mod = sinc_window_function(q, 0.0); /* Need to normalize w(0) to 1.0. */
    int           stride = calculate_delta ? 2 : 1;
    double     sidelobes = taps / 2.0;
 
@@ -144,7 +149,7 @@ static void init_sinc_table(rarch_sinc_resampler_t *resamp, double cutoff,
          window_phase        = 2.0 * window_phase - 1.0; /* [-1, 1) */
          sinc_phase          = sidelobes * window_phase;
          val                 = cutoff * sinc(M_PI * sinc_phase * cutoff) * 
-            window_function(window_phase) / window_mod;
+            sinc_window_function(q, window_phase) / window_mod;
          phase_table[i * stride * taps + j] = val;
       }
    }
@@ -175,15 +180,41 @@ static void init_sinc_table(rarch_sinc_resampler_t *resamp, double cutoff,
          sinc_phase          = sidelobes * window_phase;
 
          val                 = cutoff * sinc(M_PI * sinc_phase * cutoff) * 
-            window_function(window_phase) / window_mod;
+            sinc_window_function(q, window_phase) / window_mod;
          delta = (val - phase_table[phase * stride * taps + j]);
          phase_table[(phase * stride + 1) * taps + j] = delta;
       }
    }
 }
 
-#if !(defined(__AVX__) && ENABLE_AVX) && !defined(__SSE__)
-static INLINE void process_sinc_C(rarch_sinc_resampler_t *resamp,
+/* Every kernel comes in two flavours: one reading a single
+ * coefficient table per phase, and one interpolating between
+ * two neighbouring phases (the "lerp" levels). */
+
+static void process_sinc_C(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   float sum_l              = 0.0f;
+   float sum_r              = 0.0f;
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps;
+
+   for (i = 0; i < taps; i++)
+   {
+      float sinc_val = phase_table[i];
+      sum_l         += buffer_l[i] * sinc_val;
+      sum_r         += buffer_r[i] * sinc_val;
+   }
+
+   out_buffer[0] = sum_l;
+   out_buffer[1] = sum_r;
+}
+
+static void process_sinc_C_lerp(rarch_sinc_resampler_t *resamp,
       float *out_buffer)
 {
    unsigned i;
@@ -192,23 +223,15 @@ static INLINE void process_sinc_C(rarch_sinc_resampler_t *resamp,
    const float *buffer_l    = resamp->buffer_l + resamp->ptr;
    const float *buffer_r    = resamp->buffer_r + resamp->ptr;
    unsigned taps            = resamp->taps;
-   unsigned phase           = resamp->time >> SUBPHASE_BITS;
-#if SINC_COEFF_LERP
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
    const float *phase_table = resamp->phase_table + phase * taps * 2;
    const float *delta_table = phase_table + taps;
    float delta              = (float)
-      (resamp->time & SUBPHASE_MASK) * SUBPHASE_MOD;
-#else
-   const float *phase_table = resamp->phase_table + phase * taps;
-#endif
+      (resamp->time & resamp->subphase_mask) * resamp->subphase_mod;
 
    for (i = 0; i < taps; i++)
    {
-#if SINC_COEFF_LERP
       float sinc_val = phase_table[i] + delta_table[i] * delta;
-#else
-      float sinc_val = phase_table[i];
-#endif
       sum_l         += buffer_l[i] * sinc_val;
       sum_r         += buffer_r[i] * sinc_val;
    }
@@ -216,11 +239,120 @@ static INLINE void process_sinc_C(rarch_sinc_resampler_t *resamp,
    out_buffer[0] = sum_l;
    out_buffer[1] = sum_r;
 }
+
+#if defined(__SSE__)
+static INLINE void process_sinc_sse_store(__m128 sum_l, __m128 sum_r,
+      float *out_buffer)
+{
+   /* Them annoying shuffles.
+    * sum_l = { l3, l2, l1, l0 }
+    * sum_r = { r3, r2, r1, r0 }
+    */
+
+   __m128 sum = _mm_add_ps(_mm_shuffle_ps(sum_l, sum_r,
+            _MM_SHUFFLE(1, 0, 1, 0)),
+         _mm_shuffle_ps(sum_l, sum_r, _MM_SHUFFLE(3, 2, 3, 2)));
+
+   /* sum   = { r1, r0, l1, l0 } + { r3, r2, l3, l2 }
+    * sum   = { R1, R0, L1, L0 }
+    */
+
+   sum = _mm_add_ps(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 1, 1)), sum);
+
+   /* sum   = {R1, R1, L1, L1 } + { R1, R0, L1, L0 }
+    * sum   = { X,  R,  X,  L } 
+    */
+
+   /* Store L */
+   _mm_store_ss(out_buffer + 0, sum);
+
+   /* movehl { X, R, X, L } == { X, R, X, R } */
+   _mm_store_ss(out_buffer + 1, _mm_movehl_ps(sum, sum));
+}
+
+static void process_sinc_sse(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   __m128 sum_l             = _mm_setzero_ps();
+   __m128 sum_r             = _mm_setzero_ps();
+
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps;
+
+   for (i = 0; i < taps; i += 4)
+   {
+      __m128 buf_l = _mm_loadu_ps(buffer_l + i);
+      __m128 buf_r = _mm_loadu_ps(buffer_r + i);
+      __m128 _sinc = _mm_load_ps(phase_table + i);
+
+      sum_l        = _mm_add_ps(sum_l, _mm_mul_ps(buf_l, _sinc));
+      sum_r        = _mm_add_ps(sum_r, _mm_mul_ps(buf_r, _sinc));
+   }
+
+   process_sinc_sse_store(sum_l, sum_r, out_buffer);
+}
+
+static void process_sinc_sse_lerp(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   __m128 sum_l             = _mm_setzero_ps();
+   __m128 sum_r             = _mm_setzero_ps();
+
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps * 2;
+   const float *delta_table = phase_table + taps;
+   __m128 delta             = _mm_set1_ps((float)
+         (resamp->time & resamp->subphase_mask) * resamp->subphase_mod);
+
+   for (i = 0; i < taps; i += 4)
+   {
+      __m128 buf_l  = _mm_loadu_ps(buffer_l + i);
+      __m128 buf_r  = _mm_loadu_ps(buffer_r + i);
+      __m128 deltas = _mm_load_ps(delta_table + i);
+      __m128 _sinc  = _mm_add_ps(_mm_load_ps(phase_table + i),
+            _mm_mul_ps(deltas, delta));
+
+      sum_l         = _mm_add_ps(sum_l, _mm_mul_ps(buf_l, _sinc));
+      sum_r         = _mm_add_ps(sum_r, _mm_mul_ps(buf_r, _sinc));
+   }
+
+   process_sinc_sse_store(sum_l, sum_r, out_buffer);
+}
 #endif
 
-#if defined(__AVX__) && ENABLE_AVX
-#define process_sinc_func process_sinc
-static void process_sinc(rarch_sinc_resampler_t *resamp, float *out_buffer)
+#ifdef HAVE_SINC_AVX
+/* hadd on AVX is weird, and acts on low-lanes 
+ * and high-lanes separately. Fold the high lanes
+ * into the low ones first and finish in SSE. */
+__attribute__((target("avx")))
+static INLINE void process_sinc_avx_store(__m256 sum_l, __m256 sum_r,
+      float *out_buffer)
+{
+   __m128 res_l = _mm_add_ps(_mm256_castps256_ps128(sum_l),
+         _mm256_extractf128_ps(sum_l, 1));
+   __m128 res_r = _mm_add_ps(_mm256_castps256_ps128(sum_r),
+         _mm256_extractf128_ps(sum_r, 1));
+
+   /* { L, R, L, R } */
+   __m128 res   = _mm_hadd_ps(res_l, res_r);
+   res          = _mm_hadd_ps(res, res);
+
+   _mm_storel_pi((__m64*)out_buffer, res);
+}
+
+__attribute__((target("avx")))
+static void process_sinc_avx(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
 {
    unsigned i;
    __m256 sum_l             = _mm256_setzero_ps();
@@ -230,122 +362,187 @@ static void process_sinc(rarch_sinc_resampler_t *resamp, float *out_buffer)
    const float *buffer_r    = resamp->buffer_r + resamp->ptr;
 
    unsigned taps            = resamp->taps;
-   unsigned phase           = resamp->time >> SUBPHASE_BITS;
-#if SINC_COEFF_LERP
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps;
+
+   for (i = 0; i < taps; i += 8)
+   {
+      __m256 buf_l  = _mm256_loadu_ps(buffer_l + i);
+      __m256 buf_r  = _mm256_loadu_ps(buffer_r + i);
+      __m256 sinc   = _mm256_load_ps(phase_table + i);
+
+      sum_l         = _mm256_add_ps(sum_l, _mm256_mul_ps(buf_l, sinc));
+      sum_r         = _mm256_add_ps(sum_r, _mm256_mul_ps(buf_r, sinc));
+   }
+
+   process_sinc_avx_store(sum_l, sum_r, out_buffer);
+}
+
+__attribute__((target("avx")))
+static void process_sinc_avx_lerp(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   __m256 sum_l             = _mm256_setzero_ps();
+   __m256 sum_r             = _mm256_setzero_ps();
+
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
    const float *phase_table = resamp->phase_table + phase * taps * 2;
    const float *delta_table = phase_table + taps;
    __m256 delta             = _mm256_set1_ps((float)
-         (resamp->time & SUBPHASE_MASK) * SUBPHASE_MOD);
-#else
-   const float *phase_table = resamp->phase_table + phase * taps;
-#endif
+         (resamp->time & resamp->subphase_mask) * resamp->subphase_mod);
 
    for (i = 0; i < taps; i += 8)
    {
       __m256 buf_l  = _mm256_loadu_ps(buffer_l + i);
       __m256 buf_r  = _mm256_loadu_ps(buffer_r + i);
-
-#if SINC_COEFF_LERP
       __m256 deltas = _mm256_load_ps(delta_table + i);
       __m256 sinc   = _mm256_add_ps(_mm256_load_ps(phase_table + i),
             _mm256_mul_ps(deltas, delta));
-#else
-      __m256 sinc   = _mm256_load_ps(phase_table + i);
-#endif
+
       sum_l         = _mm256_add_ps(sum_l, _mm256_mul_ps(buf_l, sinc));
       sum_r         = _mm256_add_ps(sum_r, _mm256_mul_ps(buf_r, sinc));
    }
 
-   /* hadd on AVX is weird, and acts on low-lanes 
-    * and high-lanes separately. */
-   __m256 res_l = _mm256_hadd_ps(sum_l, sum_l);
-   __m256 res_r = _mm256_hadd_ps(sum_r, sum_r);
-   res_l        = _mm256_hadd_ps(res_l, res_l);
-   res_r        = _mm256_hadd_ps(res_r, res_r);
-   res_l        = _mm256_add_ps(_mm256_permute2f128_ps(res_l, res_l, 1), res_l);
-   res_r        = _mm256_add_ps(_mm256_permute2f128_ps(res_r, res_r, 1), res_r);
-
-   /* This is optimized to mov %xmmN, [mem].
-    * There doesn't seem to be any _mm256_store_ss intrinsic. */
-   _mm_store_ss(out_buffer + 0, _mm256_extractf128_ps(res_l, 0));
-   _mm_store_ss(out_buffer + 1, _mm256_extractf128_ps(res_r, 0));
+   process_sinc_avx_store(sum_l, sum_r, out_buffer);
 }
-#elif defined(__SSE__)
-#define process_sinc_func process_sinc
-static void process_sinc(rarch_sinc_resampler_t *resamp, float *out_buffer)
+
+__attribute__((target("avx2,fma")))
+static void process_sinc_fma(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
 {
    unsigned i;
-   __m128 sum;
-   __m128 sum_l             = _mm_setzero_ps();
-   __m128 sum_r             = _mm_setzero_ps();
+   __m256 sum_l             = _mm256_setzero_ps();
+   __m256 sum_r             = _mm256_setzero_ps();
 
    const float *buffer_l    = resamp->buffer_l + resamp->ptr;
    const float *buffer_r    = resamp->buffer_r + resamp->ptr;
 
    unsigned taps            = resamp->taps;
-   unsigned phase           = resamp->time >> SUBPHASE_BITS;
-#if SINC_COEFF_LERP
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps;
+
+   for (i = 0; i < taps; i += 8)
+   {
+      __m256 sinc   = _mm256_load_ps(phase_table + i);
+
+      sum_l         = _mm256_fmadd_ps(_mm256_loadu_ps(buffer_l + i),
+            sinc, sum_l);
+      sum_r         = _mm256_fmadd_ps(_mm256_loadu_ps(buffer_r + i),
+            sinc, sum_r);
+   }
+
+   process_sinc_avx_store(sum_l, sum_r, out_buffer);
+}
+
+__attribute__((target("avx2,fma")))
+static void process_sinc_fma_lerp(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   __m256 sum_l             = _mm256_setzero_ps();
+   __m256 sum_r             = _mm256_setzero_ps();
+
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
    const float *phase_table = resamp->phase_table + phase * taps * 2;
    const float *delta_table = phase_table + taps;
-   __m128 delta             = _mm_set1_ps((float)
-         (resamp->time & SUBPHASE_MASK) * SUBPHASE_MOD);
-#else
-   const float *phase_table = resamp->phase_table + phase * taps;
-#endif
+   __m256 delta             = _mm256_set1_ps((float)
+         (resamp->time & resamp->subphase_mask) * resamp->subphase_mod);
 
-   for (i = 0; i < taps; i += 4)
+   for (i = 0; i < taps; i += 8)
    {
-      __m128 buf_l = _mm_loadu_ps(buffer_l + i);
-      __m128 buf_r = _mm_loadu_ps(buffer_r + i);
+      __m256 sinc   = _mm256_fmadd_ps(_mm256_load_ps(delta_table + i),
+            delta, _mm256_load_ps(phase_table + i));
 
-#if SINC_COEFF_LERP
-      __m128 deltas = _mm_load_ps(delta_table + i);
-      __m128 _sinc  = _mm_add_ps(_mm_load_ps(phase_table + i),
-            _mm_mul_ps(deltas, delta));
+      sum_l         = _mm256_fmadd_ps(_mm256_loadu_ps(buffer_l + i),
+            sinc, sum_l);
+      sum_r         = _mm256_fmadd_ps(_mm256_loadu_ps(buffer_r + i),
+            sinc, sum_r);
+   }
+
+   process_sinc_avx_store(sum_l, sum_r, out_buffer);
+}
+#endif
+
+#if defined(HAVE_SINC_NEON)
+#if defined(__aarch64__)
+#define SINC_NEON_MLA(acc, a, b) vfmaq_f32(acc, a, b)
 #else
-      __m128 _sinc = _mm_load_ps(phase_table + i);
+#define SINC_NEON_MLA(acc, a, b) vmlaq_f32(acc, a, b)
 #endif
-      sum_l        = _mm_add_ps(sum_l, _mm_mul_ps(buf_l, _sinc));
-      sum_r        = _mm_add_ps(sum_r, _mm_mul_ps(buf_r, _sinc));
-   }
 
-   /* Them annoying shuffles.
-    * sum_l = { l3, l2, l1, l0 }
-    * sum_r = { r3, r2, r1, r0 }
-    */
+static INLINE void process_sinc_neon_store(float32x4_t sum_l,
+      float32x4_t sum_r, float *out_buffer)
+{
+   float32x2_t l = vadd_f32(vget_low_f32(sum_l), vget_high_f32(sum_l));
+   float32x2_t r = vadd_f32(vget_low_f32(sum_r), vget_high_f32(sum_r));
 
-   sum = _mm_add_ps(_mm_shuffle_ps(sum_l, sum_r,
-            _MM_SHUFFLE(1, 0, 1, 0)),
-         _mm_shuffle_ps(sum_l, sum_r, _MM_SHUFFLE(3, 2, 3, 2)));
+   /* { l0 + l1, r0 + r1 } */
+   vst1_f32(out_buffer, vpadd_f32(l, r));
+}
 
-   /* sum   = { r1, r0, l1, l0 } + { r3, r2, l3, l2 }
-    * sum   = { R1, R0, L1, L0 }
-    */
+static void process_sinc_neon(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   float32x4_t sum_l        = vdupq_n_f32(0.0f);
+   float32x4_t sum_r        = vdupq_n_f32(0.0f);
 
-   sum = _mm_add_ps(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 1, 1)), sum);
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
 
-   /* sum   = {R1, R1, L1, L1 } + { R1, R0, L1, L0 }
-    * sum   = { X,  R,  X,  L } 
-    */
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps;
 
-   /* Store L */
-   _mm_store_ss(out_buffer + 0, sum);
+   for (i = 0; i < taps; i += 4)
+   {
+      float32x4_t sinc = vld1q_f32(phase_table + i);
 
-   /* movehl { X, R, X, L } == { X, R, X, R } */
-   _mm_store_ss(out_buffer + 1, _mm_movehl_ps(sum, sum));
+      sum_l            = SINC_NEON_MLA(sum_l, vld1q_f32(buffer_l + i), sinc);
+      sum_r            = SINC_NEON_MLA(sum_r, vld1q_f32(buffer_r + i), sinc);
+   }
+
+   process_sinc_neon_store(sum_l, sum_r, out_buffer);
 }
-#elif defined(__ARM_NEON__)
 
-#if SINC_COEFF_LERP
-#error "NEON asm does not support SINC lerp."
-#endif
+static void process_sinc_neon_lerp(rarch_sinc_resampler_t *resamp,
+      float *out_buffer)
+{
+   unsigned i;
+   float32x4_t sum_l        = vdupq_n_f32(0.0f);
+   float32x4_t sum_r        = vdupq_n_f32(0.0f);
 
-/* Need to make this function pointer as Android doesn't 
- * have built-in targets for NEON and plain ARMv7a.
- */
-static void (*process_sinc_func)(rarch_sinc_resampler_t *resamp,
-      float *out_buffer);
+   const float *buffer_l    = resamp->buffer_l + resamp->ptr;
+   const float *buffer_r    = resamp->buffer_r + resamp->ptr;
+
+   unsigned taps            = resamp->taps;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
+   const float *phase_table = resamp->phase_table + phase * taps * 2;
+   const float *delta_table = phase_table + taps;
+   float32x4_t delta        = vdupq_n_f32((float)
+         (resamp->time & resamp->subphase_mask) * resamp->subphase_mod);
 
+   for (i = 0; i < taps; i += 4)
+   {
+      float32x4_t sinc = SINC_NEON_MLA(vld1q_f32(phase_table + i),
+            vld1q_f32(delta_table + i), delta);
+
+      sum_l            = SINC_NEON_MLA(sum_l, vld1q_f32(buffer_l + i), sinc);
+      sum_r            = SINC_NEON_MLA(sum_r, vld1q_f32(buffer_r + i), sinc);
+   }
+
+   process_sinc_neon_store(sum_l, sum_r, out_buffer);
+}
+#elif defined(HAVE_SINC_NEON_ASM)
 /* Assumes that taps >= 8, and that taps is a multiple of 8. */
 void process_sinc_neon_asm(float *out, const float *left, 
       const float *right, const float *coeff, unsigned taps);
@@ -356,21 +553,72 @@ static void process_sinc_neon(rarch_sinc_resampler_t *resamp,
    const float *buffer_l    = resamp->buffer_l + resamp->ptr;
    const float *buffer_r    = resamp->buffer_r + resamp->ptr;
 
-   unsigned phase           = resamp->time >> SUBPHASE_BITS;
+   unsigned phase           = resamp->time >> resamp->subphase_bits;
    unsigned taps            = resamp->taps;
    const float *phase_table = resamp->phase_table + phase * taps;
 
    process_sinc_neon_asm(out_buffer, buffer_l, buffer_r, phase_table, taps);
 }
-#else /* Plain ol' C99 */
-#define process_sinc_func process_sinc_C
 #endif
 
+/* Picks the kernel for this CPU and returns the
+ * multiple the number of taps must be rounded up to. */
+static unsigned resampler_sinc_set_kernel(rarch_sinc_resampler_t *re,
+      unsigned taps, bool lerp, resampler_simd_mask_t mask)
+{
+   (void)taps;
+   (void)mask;
+
+#ifdef HAVE_SINC_AVX
+   if (taps >= SINC_AVX_MIN_TAPS)
+   {
+      if ((mask & RESAMPLER_SIMD_AVX2) && (mask & RESAMPLER_SIMD_FMA))
+      {
+         re->process_sinc = lerp ? process_sinc_fma_lerp : process_sinc_fma;
+         return 8;
+      }
+
+      if (mask & RESAMPLER_SIMD_AVX)
+      {
+         re->process_sinc = lerp ? process_sinc_avx_lerp : process_sinc_avx;
+         return 8;
+      }
+   }
+#endif
+
+#if defined(__SSE__)
+   if (mask & RESAMPLER_SIMD_SSE)
+   {
+      re->process_sinc = lerp ? process_sinc_sse_lerp : process_sinc_sse;
+      return 4;
+   }
+#endif
+
+#if defined(HAVE_SINC_NEON)
+   if (mask & RESAMPLER_SIMD_NEON)
+   {
+      re->process_sinc = lerp ? process_sinc_neon_lerp : process_sinc_neon;
+      return 4;
+   }
+#elif defined(HAVE_SINC_NEON_ASM)
+   /* The assembly kernel has no lerp variant. */
+   if ((mask & RESAMPLER_SIMD_NEON) && !lerp)
+   {
+      re->process_sinc = process_sinc_neon;
+      return 8;
+   }
+#endif
+
+   re->process_sinc = lerp ? process_sinc_C_lerp : process_sinc_C;
+   return 4;
+}
+
 static void resampler_sinc_process(void *re_, struct resampler_data *data)
 {
    rarch_sinc_resampler_t *re = (rarch_sinc_resampler_t*)re_;
 
-   uint32_t ratio        = PHASES / data->ratio;
+   uint32_t phases       = re->phases;
+   uint32_t ratio        = phases / data->ratio;
    const float *input    = data->data_in;
    float *output         = data->data_out;
    size_t frames         = data->input_frames;
@@ -378,7 +626,7 @@ static void resampler_sinc_process(void *re_, struct resampler_data *data)
 
    while (frames)
    {
-      while (frames && re->time >= PHASES)
+      while (frames && re->time >= phases)
       {
          /* Push in reverse to make filter more obvious. */
          if (!re->ptr)
@@ -388,13 +636,13 @@ static void resampler_sinc_process(void *re_, struct resampler_data *data)
          re->buffer_l[re->ptr + re->taps] = re->buffer_l[re->ptr] = *input++;
          re->buffer_r[re->ptr + re->taps] = re->buffer_r[re->ptr] = *input++;
 
-         re->time -= PHASES;
+         re->time -= phases;
          frames--;
       }
 
-      while (re->time < PHASES)
+      while (re->time < phases)
       {
-         process_sinc_func(re, output);
+         re->process_sinc(re, output);
          output += 2;
          out_frames++;
          re->time += ratio;
@@ -413,11 +661,14 @@ static void resampler_sinc_free(void *re)
 }
 
 static void *resampler_sinc_new(const struct resampler_config *config,
-      double bandwidth_mod, resampler_simd_mask_t mask)
+      double bandwidth_mod, enum resampler_quality quality,
+      resampler_simd_mask_t mask)
 {
    double cutoff;
+   unsigned align;
    size_t phase_elems, elems;
-   rarch_sinc_resampler_t *re = (rarch_sinc_resampler_t*)
+   const struct sinc_quality *q = NULL;
+   rarch_sinc_resampler_t *re   = (rarch_sinc_resampler_t*)
       calloc(1, sizeof(*re));
 
    if (!re)
@@ -425,8 +676,18 @@ static void *resampler_sinc_new(const struct resampler_config *config,
 
    (void)config;
 
-   re->taps = TAPS;
-   cutoff   = CUTOFF;
+   if (quality == RESAMPLER_QUALITY_DONTCARE
+         || quality > RESAMPLER_QUALITY_HIGHEST)
+      quality = SINC_DEFAULT_QUALITY;
+
+   q                 = &sinc_qualities[quality - RESAMPLER_QUALITY_LOWEST];
+
+   re->taps          = q->sidelobes * 2;
+   re->subphase_bits = q->subphase_bits;
+   re->subphase_mask = (1 << q->subphase_bits) - 1;
+   re->subphase_mod  = 1.0f / (1 << q->subphase_bits);
+   re->phases        = 1 << (q->phase_bits + q->subphase_bits);
+   cutoff            = q->cutoff;
 
    /* Downsampling, must lower cutoff, and extend number of 
     * taps accordingly to keep same stopband attenuation. */
@@ -437,33 +698,26 @@ static void *resampler_sinc_new(const struct resampler_config *config,
    }
 
    /* Be SIMD-friendly. */
-#if (defined(__AVX__) && ENABLE_AVX) || (defined(__ARM_NEON__))
-   re->taps     = (re->taps + 7) & ~7;
-#else
-   re->taps     = (re->taps + 3) & ~3;
-#endif
+   align        = resampler_sinc_set_kernel(re, re->taps, q->lerp, mask);
+   re->taps     = (re->taps + align - 1) & ~(align - 1);
 
-   phase_elems  = (1 << PHASE_BITS) * re->taps;
-#if SINC_COEFF_LERP
-   phase_elems *= 2;
-#endif
+   phase_elems  = (1 << q->phase_bits) * re->taps;
+   if (q->lerp)
+      phase_elems *= 2;
    elems        = phase_elems + 4 * re->taps;
 
    re->main_buffer = (float*)memalign_alloc(128, sizeof(float) * elems);
    if (!re->main_buffer)
       goto error;
 
+   memset(re->main_buffer, 0, sizeof(float) * elems);
+
    re->phase_table = re->main_buffer;
    re->buffer_l    = re->main_buffer + phase_elems;
    re->buffer_r    = re->buffer_l + 2 * re->taps;
 
-   init_sinc_table(re, cutoff, re->phase_table,
-         1 << PHASE_BITS, re->taps, SINC_COEFF_LERP);
-
-#if defined(__ARM_NEON__) 
-   process_sinc_func = mask & RESAMPLER_SIMD_NEON 
-      ? process_sinc_neon : process_sinc_C;
-#endif
+   init_sinc_table(q, cutoff, re->phase_table,
+         1 << q->phase_bits, re->taps, q->lerp);
 
    return re;
 
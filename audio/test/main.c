@@ -26,6 +26,10 @@
 #define RESAMPLER_IDENT "sinc"
 #endif
 
+#ifndef RESAMPLER_QUALITY
+#define RESAMPLER_QUALITY RESAMPLER_QUALITY_DONTCARE
+#endif
+
 int main(int argc, char *argv[])
 {
    int16_t input_i[1024];
@@ -62,7 +66,8 @@ int main(int argc, char *argv[])
       return 1;
    }
 
-   if (!rarch_resampler_realloc(&re, &resampler, RESAMPLER_IDENT, out_rate / in_rate))
+   if (!rarch_resampler_realloc(&re, &resampler, RESAMPLER_IDENT, out_rate / in_rate,
+            RESAMPLER_QUALITY))
    {
       fprintf(stderr, "Failed to allocate resampler ...\n");
       return 1;
@@ -0,0 +1,301 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs the sinc resampler at every quality level, offering it
+ * each set of SIMD extensions this CPU supports, and prints the
+ * cost per output frame and the SNR of a resampled sine. Levels
+ * with few taps stay on SSE even when AVX is offered.
+ *
+ * Usage: sinc-bench [in-rate] [out-rate]
+ *
+ * The SNR is measured by fitting a sine of the expected
+ * frequency to the output; whatever the fit does not explain
+ * is counted as noise. The "max diff" column is the largest
+ * difference to the plain C kernel. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <features/features_cpu.h>
+
+#include "../audio_resampler_driver.h"
+
+#define BENCH_SECONDS   2
+#define BENCH_RUNS      3
+#define BENCH_TONE_HZ   1000.0
+
+struct bench_kernel
+{
+   const char *name;
+   resampler_simd_mask_t mask;
+};
+
+static const struct bench_kernel kernels[] = {
+   { "C",    0 },
+   { "SSE",  RESAMPLER_SIMD_SSE },
+   { "AVX",  RESAMPLER_SIMD_SSE | RESAMPLER_SIMD_AVX },
+   { "FMA",  RESAMPLER_SIMD_SSE | RESAMPLER_SIMD_AVX |
+             RESAMPLER_SIMD_AVX2 | RESAMPLER_SIMD_FMA },
+   { "NEON", RESAMPLER_SIMD_NEON },
+};
+
+static const char *qualities[] = {
+   "lowest", "lower", "normal", "higher", "highest"
+};
+
+/* Least-squares fit of a*sin(wn) + b*cos(wn) + c to both
+ * channels, returns the energy of the residual and stores
+ * the energy of the fit in *signal. */
+static double bench_fit(const float *out, size_t frames,
+      size_t skip, double omega, double *signal)
+{
+   size_t i;
+   int ch;
+   double noise  = 0.0;
+
+   *signal       = 0.0;
+
+   for (ch = 0; ch < 2; ch++)
+   {
+      double ss = 0.0, cc = 0.0, sc = 0.0, s1 = 0.0, c1 = 0.0;
+      double ys = 0.0, yc = 0.0, y1 = 0.0;
+      double n  = (double)(frames - skip);
+      double a, b, c, m[3][4];
+      int r, k, j;
+
+      for (i = skip; i < frames; i++)
+      {
+         double s  = sin(omega * i);
+         double co = cos(omega * i);
+         double y  = out[2 * i + ch];
+
+         ss += s * s;
+         cc += co * co;
+         sc += s * co;
+         s1 += s;
+         c1 += co;
+         ys += y * s;
+         yc += y * co;
+         y1 += y;
+      }
+
+      m[0][0] = ss; m[0][1] = sc; m[0][2] = s1; m[0][3] = ys;
+      m[1][0] = sc; m[1][1] = cc; m[1][2] = c1; m[1][3] = yc;
+      m[2][0] = s1; m[2][1] = c1; m[2][2] = n;  m[2][3] = y1;
+
+      /* Gaussian elimination, the system is well conditioned
+       * as long as the window spans many periods. */
+      for (r = 0; r < 3; r++)
+      {
+         for (k = r + 1; k < 3; k++)
+         {
+            double f = m[k][r] / m[r][r];
+            for (j = r; j < 4; j++)
+               m[k][j] -= f * m[r][j];
+         }
+      }
+
+      c = m[2][3] / m[2][2];
+      b = (m[1][3] - m[1][2] * c) / m[1][1];
+      a = (m[0][3] - m[0][1] * b - m[0][2] * c) / m[0][0];
+
+      for (i = skip; i < frames; i++)
+      {
+         double fit = a * sin(omega * i) + b * cos(omega * i) + c;
+         double err = out[2 * i + ch] - fit;
+
+         *signal   += fit * fit;
+         noise     += err * err;
+      }
+   }
+
+   return noise;
+}
+
+/* The resampler steps through time in fixed point, so the output
+ * frequency is a hair off the ideal one. Search for it, or the
+ * drift would show up as noise. */
+static double bench_snr(const float *out, size_t frames,
+      size_t skip, double omega)
+{
+   unsigned i;
+   double signal;
+   const double golden = 0.6180339887498949;
+   double lo           = omega * (1.0 - 1e-5);
+   double hi           = omega * (1.0 + 1e-5);
+   double x1           = hi - golden * (hi - lo);
+   double x2           = lo + golden * (hi - lo);
+   double f1           = bench_fit(out, frames, skip, x1, &signal);
+   double f2           = bench_fit(out, frames, skip, x2, &signal);
+   double noise;
+
+   for (i = 0; i < 40; i++)
+   {
+      if (f1 < f2)
+      {
+         hi = x2;
+         x2 = x1;
+         f2 = f1;
+         x1 = hi - golden * (hi - lo);
+         f1 = bench_fit(out, frames, skip, x1, &signal);
+      }
+      else
+      {
+         lo = x1;
+         x1 = x2;
+         f1 = f2;
+         x2 = lo + golden * (hi - lo);
+         f2 = bench_fit(out, frames, skip, x2, &signal);
+      }
+   }
+
+   noise = bench_fit(out, frames, skip, 0.5 * (lo + hi), &signal);
+
+   if (noise <= 0.0)
+      return INFINITY;
+   return 10.0 * log10(signal / noise);
+}
+
+static size_t bench_run(enum resampler_quality quality,
+      resampler_simd_mask_t mask, double ratio,
+      const float *in, size_t in_frames, float *out, double *usec)
+{
+   unsigned run;
+   struct resampler_data data = {0};
+
+   /* Best of a few runs, the first one also faults in the
+    * output buffer. */
+   for (run = 0; run < BENCH_RUNS; run++)
+   {
+      retro_time_t start;
+      void *re = sinc_resampler.init(NULL, ratio, quality, mask);
+
+      if (!re)
+         return 0;
+
+      data.data_in      = in;
+      data.data_out     = out;
+      data.input_frames = in_frames;
+      data.ratio        = ratio;
+
+      start             = cpu_features_get_time_usec();
+      sinc_resampler.process(re, &data);
+      start             = cpu_features_get_time_usec() - start;
+
+      if (!run || start < *usec)
+         *usec          = (double)start;
+
+      sinc_resampler.free(re);
+   }
+
+   return data.output_frames;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned q, k;
+   size_t i, in_frames;
+   float *in, *out, *ref;
+   double in_rate               = 44100.0;
+   double out_rate              = 48000.0;
+   double ratio;
+   resampler_simd_mask_t cpu    = (resampler_simd_mask_t)cpu_features_get();
+
+   if (argc >= 2)
+      in_rate  = strtod(argv[1], NULL);
+   if (argc >= 3)
+      out_rate = strtod(argv[2], NULL);
+
+   ratio       = out_rate / in_rate;
+   if (in_rate <= 0.0 || ratio <= 0.0 || ratio >= 8.0)
+   {
+      fprintf(stderr, "Usage: %s [in-rate] [out-rate] (max ratio: 8.0)\n",
+            argv[0]);
+      return 1;
+   }
+
+   in_frames = (size_t)(in_rate * BENCH_SECONDS);
+   in        = (float*)malloc(in_frames * 2 * sizeof(float));
+   out       = (float*)malloc((size_t)(in_frames * ratio + 16) * 2 * sizeof(float));
+   ref       = (float*)malloc((size_t)(in_frames * ratio + 16) * 2 * sizeof(float));
+
+   if (!in || !out || !ref)
+      return 1;
+
+   for (i = 0; i < in_frames; i++)
+   {
+      in[2 * i + 0] = 0.5f * sin(2.0 * M_PI * BENCH_TONE_HZ * i / in_rate);
+      in[2 * i + 1] = in[2 * i + 0];
+   }
+
+   printf("%.0f Hz -> %.0f Hz, %d seconds of audio\n",
+         in_rate, out_rate, BENCH_SECONDS);
+   printf("%-8s %-5s %10s %10s %10s\n",
+         "quality", "simd", "ns/frame", "SNR (dB)", "max diff");
+
+   for (q = 0; q < sizeof(qualities) / sizeof(qualities[0]); q++)
+   {
+      enum resampler_quality quality =
+         (enum resampler_quality)(RESAMPLER_QUALITY_LOWEST + q);
+      size_t ref_frames = 0;
+
+      for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+      {
+         double usec, snr, diff = 0.0;
+         size_t frames;
+
+         if ((kernels[k].mask & cpu) != kernels[k].mask)
+            continue;
+
+         frames = bench_run(quality, kernels[k].mask, ratio,
+               in, in_frames, k ? out : ref, &usec);
+
+         if (!frames)
+         {
+            fprintf(stderr, "Failed to create resampler.\n");
+            return 1;
+         }
+
+         if (!k)
+            ref_frames = frames;
+         else if (frames == ref_frames)
+         {
+            for (i = 0; i < 2 * frames; i++)
+            {
+               double d = fabs(out[i] - ref[i]);
+               if (d > diff)
+                  diff = d;
+            }
+         }
+         else
+            diff = INFINITY;
+
+         /* Skip the start, where the filter is still filling up. */
+         snr = bench_snr(k ? out : ref, frames, (size_t)out_rate / 10,
+               2.0 * M_PI * BENCH_TONE_HZ / out_rate);
+
+         printf("%-8s %-5s %10.2f %10.1f %10.2g\n",
+               qualities[q], kernels[k].name,
+               1000.0 * usec / frames, snr, diff);
+      }
+   }
+
+   free(in);
+   free(out);
+   free(ref);
+   return 0;
+}
@@ -32,6 +32,10 @@
 #define RESAMPLER_IDENT "sinc"
 #endif
 
+#ifndef RESAMPLER_QUALITY
+#define RESAMPLER_QUALITY RESAMPLER_QUALITY_DONTCARE
+#endif
+
 static void gen_signal(float *out, double omega, double bias_samples, size_t samples)
 {
    size_t i;
@@ -302,7 +306,8 @@ int main(int argc, char *argv[])
    retro_assert(input);
    retro_assert(output);
 
-   if (!rarch_resampler_realloc(&re, &resampler, RESAMPLER_IDENT, ratio))
+   if (!rarch_resampler_realloc(&re, &resampler, RESAMPLER_IDENT, ratio,
+            RESAMPLER_QUALITY))
    {
       free(input);
       free(output);
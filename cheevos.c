@@ -31,6 +31,7 @@
 #endif
 
 #include "cheevos.h"
+#include "cheevos_eval.h"
 #include "command.h"
 #include "dynamic.h"
 #include "network/net_http_special.h"
@@ -55,6 +56,10 @@
 /* Define this macro to remove HTTP timeouts. */
 #undef CHEEVOS_NO_TIMEOUT
 
+/* Define this macro to a file name to record the conditions and the
+ * memory they read each frame, tools/cheevos_bench replays it. */
+#undef CHEEVOS_TRACE
+
 #define JSON_KEY_GAMEID       0xb4960eecU
 #define JSON_KEY_ACHIEVEMENTS 0x69749ae1U
 #define JSON_KEY_ID           0x005973f2U
@@ -85,64 +90,6 @@ enum
    CHEEVOS_CONSOLE_MASTER_SYSTEM
 };
 
-enum
-{
-   CHEEVOS_VAR_SIZE_BIT_0 = 0,
-   CHEEVOS_VAR_SIZE_BIT_1,
-   CHEEVOS_VAR_SIZE_BIT_2,
-   CHEEVOS_VAR_SIZE_BIT_3,
-   CHEEVOS_VAR_SIZE_BIT_4,
-   CHEEVOS_VAR_SIZE_BIT_5,
-   CHEEVOS_VAR_SIZE_BIT_6,
-   CHEEVOS_VAR_SIZE_BIT_7,
-   CHEEVOS_VAR_SIZE_NIBBLE_LOWER,
-   CHEEVOS_VAR_SIZE_NIBBLE_UPPER,
-   /* Byte, */
-   CHEEVOS_VAR_SIZE_EIGHT_BITS, /* =Byte, */
-   CHEEVOS_VAR_SIZE_SIXTEEN_BITS,
-   CHEEVOS_VAR_SIZE_THIRTYTWO_BITS,
-
-   CHEEVOS_VAR_SIZE_LAST
-}; /* cheevos_var_t.size */
-
-enum
-{
-   /* compare to the value of a live address in RAM */
-   CHEEVOS_VAR_TYPE_ADDRESS = 0,
-
-   /* a number. assume 32 bit */
-   CHEEVOS_VAR_TYPE_VALUE_COMP,  
-
-   /* the value last known at this address. */
-   CHEEVOS_VAR_TYPE_DELTA_MEM,   
-
-   /* a custom user-set variable */
-   CHEEVOS_VAR_TYPE_DYNAMIC_VAR,
-
-   CHEEVOS_VAR_TYPE_LAST
-}; /* cheevos_var_t.type */
-
-enum
-{
-   CHEEVOS_COND_OP_EQUALS = 0,
-   CHEEVOS_COND_OP_LESS_THAN,
-   CHEEVOS_COND_OP_LESS_THAN_OR_EQUAL,
-   CHEEVOS_COND_OP_GREATER_THAN,
-   CHEEVOS_COND_OP_GREATER_THAN_OR_EQUAL,
-   CHEEVOS_COND_OP_NOT_EQUAL_TO,
-
-   CHEEVOS_COND_OP_LAST
-}; /* cheevos_cond_t.op */
-
-enum
-{
-   CHEEVOS_COND_TYPE_STANDARD = 0,
-   CHEEVOS_COND_TYPE_PAUSE_IF,
-   CHEEVOS_COND_TYPE_RESET_IF,
-
-   CHEEVOS_COND_TYPE_LAST
-}; /* cheevos_cond_t.type */
-
 enum
 {
    CHEEVOS_DIRTY_TITLE       = 1 << 0,
@@ -158,17 +105,6 @@ enum
    CHEEVOS_DIRTY_ALL         = (1 << 9) - 1
 };
 
-typedef struct
-{
-   unsigned type;
-   unsigned req_hits;
-   unsigned curr_hits;
-
-   cheevos_var_t source;
-   unsigned      op;
-   cheevos_var_t target;
-} cheevos_cond_t;
-
 typedef struct
 {
    cheevos_cond_t *conds;
@@ -257,6 +193,13 @@ typedef struct
    char token[32];
    
    retro_ctx_memory_info_t meminfo[4];
+
+   /* The conditions of core and unofficial achievements, in that order. */
+   cheevos_eval_t *eval;
+
+#ifdef CHEEVOS_TRACE
+   FILE *trace;
+#endif
 } cheevos_locals_t;
 
 static cheevos_locals_t cheevos_locals =
@@ -737,7 +680,6 @@ static void cheevos_parse_cond(cheevos_cond_t *cond, const char **memaddr)
    cheevos_parse_var(&cond->source, &str);
    cond->op = cheevos_parse_operator(&str);
    cheevos_parse_var(&cond->target, &str);
-   cond->curr_hits = 0;
    cond->req_hits = cheevos_read_hits(&str);
 
    *memaddr = str;
@@ -1020,6 +962,168 @@ static int cheevos_read__json_end_array(void *userdata)
    return 0;
 }
 
+/*****************************************************************************
+Compile the conditions of all achievements.
+*****************************************************************************/
+
+#ifdef CHEEVOS_TRACE
+static void cheevos_trace_write(uint32_t value)
+{
+   fwrite(&value, sizeof(value), 1, cheevos_locals.trace);
+}
+
+static void cheevos_trace_write_var(const cheevos_var_t *var)
+{
+   cheevos_trace_write(var->size);
+   cheevos_trace_write(var->type);
+   cheevos_trace_write((uint32_t)var->bank_id);
+   cheevos_trace_write(var->value);
+}
+
+static void cheevos_trace_write_set(const cheevoset_t *set)
+{
+   const cheevo_t *cheevo = set->cheevos;
+   const cheevo_t *end    = cheevo + set->count;
+
+   for (; cheevo < end; cheevo++)
+   {
+      unsigned i, j;
+
+      cheevos_trace_write(cheevo->count);
+
+      for (i = 0; i < cheevo->count; i++)
+      {
+         const cheevos_condset_t *condset = cheevo->condsets + i;
+
+         cheevos_trace_write(condset->count);
+
+         for (j = 0; j < condset->count; j++)
+         {
+            const cheevos_cond_t *cond = condset->conds + j;
+
+            cheevos_trace_write(cond->type);
+            cheevos_trace_write(cond->req_hits);
+            cheevos_trace_write(cond->op);
+            cheevos_trace_write_var(&cond->source);
+            cheevos_trace_write_var(&cond->target);
+         }
+      }
+   }
+}
+
+static void cheevos_trace_begin(void)
+{
+   cheevos_locals.trace = fopen(CHEEVOS_TRACE, "wb");
+
+   if (!cheevos_locals.trace)
+   {
+      RARCH_ERR("CHEEVOS could not create trace %s.\n", CHEEVOS_TRACE);
+      return;
+   }
+
+   cheevos_trace_write(CHEEVOS_TRACE_MAGIC);
+   cheevos_trace_write(CHEEVOS_TRACE_VERSION);
+   cheevos_trace_write(cheevos_locals.core.count
+         + cheevos_locals.unofficial.count);
+   cheevos_trace_write_set(&cheevos_locals.core);
+   cheevos_trace_write_set(&cheevos_locals.unofficial);
+}
+
+static void cheevos_trace_frame_var(const cheevos_var_t *var)
+{
+   static const uint8_t zeros[4] = {0};
+   unsigned width                = cheevos_eval_var_width(var);
+   const uint8_t *memory         = NULL;
+
+   if (!width)
+      return;
+
+   if (var->bank_id >= 0)
+      memory = cheevos_get_memory(var);
+
+   fwrite(memory ? memory : zeros, 1, width, cheevos_locals.trace);
+}
+
+static void cheevos_trace_frame_set(const cheevoset_t *set)
+{
+   const cheevo_t *cheevo = set->cheevos;
+   const cheevo_t *end    = cheevo + set->count;
+
+   for (; cheevo < end; cheevo++)
+   {
+      unsigned i, j;
+
+      for (i = 0; i < cheevo->count; i++)
+      {
+         const cheevos_condset_t *condset = cheevo->condsets + i;
+
+         for (j = 0; j < condset->count; j++)
+         {
+            cheevos_trace_frame_var(&condset->conds[j].source);
+            cheevos_trace_frame_var(&condset->conds[j].target);
+         }
+      }
+   }
+}
+
+static void cheevos_trace_frame(void)
+{
+   if (!cheevos_locals.trace)
+      return;
+
+   cheevos_trace_frame_set(&cheevos_locals.core);
+   cheevos_trace_frame_set(&cheevos_locals.unofficial);
+}
+#endif
+
+static int cheevos_compile_set(const cheevoset_t *set)
+{
+   const cheevo_t *cheevo = set->cheevos;
+   const cheevo_t *end    = cheevo + set->count;
+
+   for (; cheevo < end; cheevo++)
+   {
+      const cheevos_condset_t *condset = cheevo->condsets;
+      const cheevos_condset_t *last    = condset + cheevo->count;
+
+      if (cheevos_eval_add_cheevo(cheevos_locals.eval) == ~0U)
+         return -1;
+
+      for (; condset < last; condset++)
+      {
+         if (!cheevos_eval_add_condset(cheevos_locals.eval,
+                  condset->conds, condset->count))
+            return -1;
+      }
+   }
+
+   return 0;
+}
+
+static int cheevos_compile(void)
+{
+   /* The addresses were resolved while parsing, so the host
+    * pointers are known now and don't change until unload. */
+   cheevos_locals.eval = cheevos_eval_new(cheevos_get_memory);
+
+   if (!cheevos_locals.eval)
+      return -1;
+
+   if (     cheevos_compile_set(&cheevos_locals.core) != 0
+         || cheevos_compile_set(&cheevos_locals.unofficial) != 0
+         || !cheevos_eval_compile(cheevos_locals.eval))
+   {
+      cheevos_eval_free(cheevos_locals.eval);
+      cheevos_locals.eval = NULL;
+      return -1;
+   }
+
+#ifdef CHEEVOS_TRACE
+   cheevos_trace_begin();
+#endif
+   return 0;
+}
+
 static int cheevos_parse(const char *json)
 {
    static const jsonsax_handlers_t handlers =
@@ -1083,6 +1187,9 @@ static int cheevos_parse(const char *json)
 
    if (jsonsax_parse(json, &handlers, (void*)&ud) != JSONSAX_OK)
       goto error;
+
+   if (cheevos_compile() != 0)
+      goto error;
    
    return 0;
 
@@ -1112,237 +1219,15 @@ uint8_t *cheevos_get_memory(const cheevos_var_t *var)
    return NULL;
 }
 
-static unsigned cheevos_get_var_value(cheevos_var_t *var)
-{
-   if (var->type == CHEEVOS_VAR_TYPE_VALUE_COMP)
-      return var->value;
-
-   if (     var->type == CHEEVOS_VAR_TYPE_ADDRESS 
-         || var->type == CHEEVOS_VAR_TYPE_DELTA_MEM)
-   {
-      /* TODO Check with Scott if the bank id is needed */
-      const uint8_t *memory = cheevos_get_memory(var);
-      unsigned live_val     = 0;
-      
-      if (memory)
-      {
-         live_val = memory[0];
-
-         if (var->size > CHEEVOS_VAR_SIZE_BIT_0 
-               && var->size <= CHEEVOS_VAR_SIZE_BIT_7)
-            live_val = (live_val & 
-                  (1 << (var->size - CHEEVOS_VAR_SIZE_BIT_0))) != 0;
-         else
-         {
-            switch (var->size)
-            {
-               case CHEEVOS_VAR_SIZE_NIBBLE_LOWER:
-                  live_val &= 0x0f;
-                  break;
-               case CHEEVOS_VAR_SIZE_NIBBLE_UPPER:
-                  live_val = (live_val >> 4) & 0x0f;
-                  break;
-               case CHEEVOS_VAR_SIZE_EIGHT_BITS:
-                  break;
-               case CHEEVOS_VAR_SIZE_SIXTEEN_BITS:
-                  live_val |= memory[1] << 8;
-                  break;
-               case CHEEVOS_VAR_SIZE_THIRTYTWO_BITS:
-                  live_val |= memory[1] << 8;
-                  live_val |= memory[2] << 16;
-                  live_val |= memory[3] << 24;
-                  break;
-            }
-         }
-      }
-      
-      if (var->type == CHEEVOS_VAR_TYPE_DELTA_MEM)
-      {
-         unsigned previous = var->previous;
-         var->previous     = live_val;
-         return previous;
-      }
-
-      return live_val;
-   }
-
-   /* We shouldn't get here... */
-   return 0;
-}
-
-static int cheevos_test_condition(cheevos_cond_t *cond)
-{
-   unsigned sval = cheevos_get_var_value(&cond->source);
-   unsigned tval = cheevos_get_var_value(&cond->target);
-
-   switch (cond->op)
-   {
-      case CHEEVOS_COND_OP_EQUALS:
-         return sval == tval;
-      case CHEEVOS_COND_OP_LESS_THAN:
-         return sval < tval;
-      case CHEEVOS_COND_OP_LESS_THAN_OR_EQUAL:
-         return sval <= tval;
-      case CHEEVOS_COND_OP_GREATER_THAN:
-         return sval > tval;
-      case CHEEVOS_COND_OP_GREATER_THAN_OR_EQUAL:
-         return sval >= tval;
-      case CHEEVOS_COND_OP_NOT_EQUAL_TO:
-         return sval != tval;
-      default:
-         break;
-   }
-
-   return 1;
-}
-
-static int cheevos_test_cond_set(const cheevos_condset_t *condset,
-      int *dirty_conds, int *reset_conds, int match_any)
+static int cheevos_test_cheevo(cheevo_t *cheevo, unsigned index)
 {
-   int cond_valid            = 0;
-   int set_valid             = 1;
-   const cheevos_cond_t *end = condset->conds + condset->count;
-   cheevos_cond_t *cond      = NULL;
-
-   /* Now, read all Pause conditions, and if any are true, 
-    * do not process further (retain old state). */
-
-   for (cond = condset->conds; cond < end; cond++)
-   {
-      if (cond->type == CHEEVOS_COND_TYPE_PAUSE_IF)
-      {
-         /* Reset by default, set to 1 if hit! */
-         cond->curr_hits = 0;
-
-         if (cheevos_test_condition(cond))
-         {
-            cond->curr_hits = 1;
-            *dirty_conds = 1;
-
-            /* Early out: this achievement is paused, 
-             * do not process any further! */
-            return 0;
-         }
-      }
-   }
-
-   /* Read all standard conditions, and process as normal: */
-   for (cond = condset->conds; cond < end; cond++)
-   {
-      if (     cond->type == CHEEVOS_COND_TYPE_PAUSE_IF 
-            || cond->type == CHEEVOS_COND_TYPE_RESET_IF)
-         continue;
-
-      if (cond->req_hits != 0 && cond->curr_hits >= cond->req_hits)
-         continue;
+   bool dirty = false;
+   bool valid = cheevos_eval_test(cheevos_locals.eval, index, &dirty);
 
-      cond_valid = cheevos_test_condition(cond);
-
-      if (cond_valid)
-      {
-         cond->curr_hits++;
-         *dirty_conds = 1;
-
-         /* Process this logic, if this condition is true: */
-         if (cond->req_hits == 0)
-            ; /* Not a hit-based requirement: ignore any additional logic! */
-         else if (cond->curr_hits < cond->req_hits)
-            cond_valid = 0; /* Not entirely valid yet! */
-
-         if (match_any)
-            break;
-      }
-
-      /* Sequential or non-sequential? */
-      set_valid &= cond_valid;
-   }
-
-   /* Now, ONLY read reset conditions! */
-   for (cond = condset->conds; cond < end; cond++)
-   {
-      if (cond->type == CHEEVOS_COND_TYPE_RESET_IF)
-      {
-         cond_valid = cheevos_test_condition(cond);
-
-         if (cond_valid)
-         {
-            *reset_conds = 1; /* Resets all hits found so far */
-            set_valid = 0;    /* Cannot be valid if we've hit a reset condition. */
-            break;            /* No point processing any further reset conditions. */
-         }
-      }
-   }
-
-   return set_valid;
-}
-
-static int cheevos_reset_cond_set(cheevos_condset_t *condset, int deltas)
-{
-   int dirty                 = 0;
-   const cheevos_cond_t *end = condset->conds + condset->count;
-   cheevos_cond_t *cond      = NULL;
-
-   if (deltas)
-   {
-      for (cond = condset->conds; cond < end; cond++)
-      {
-         dirty |= cond->curr_hits != 0;
-         cond->curr_hits = 0;
-
-         cond->source.previous = cond->source.value;
-         cond->target.previous = cond->target.value;
-      }
-   }
-   else
-   {
-      for (cond = condset->conds; cond < end; cond++)
-      {
-         dirty |= cond->curr_hits != 0;
-         cond->curr_hits = 0;
-      }
-   }
-
-   return dirty;
-}
-
-static int cheevos_test_cheevo(cheevo_t *cheevo)
-{
-   int dirty;
-   int dirty_conds              = 0;
-   int reset_conds              = 0;
-   int ret_val                  = 0;
-   int ret_val_sub_cond         = cheevo->count == 1;
-   cheevos_condset_t *condset   = cheevo->condsets;
-   const cheevos_condset_t *end = condset + cheevo->count;
-
-   if (condset < end)
-   {
-      ret_val = cheevos_test_cond_set(condset, &dirty_conds, &reset_conds, 0);
-      condset++;
-   }
-
-   while (condset < end)
-   {
-      int res = cheevos_test_cond_set(condset, &dirty_conds, &reset_conds, 0);
-      ret_val_sub_cond |= res;
-      condset++;
-   }
-
-   if (dirty_conds)
+   if (dirty)
       cheevo->dirty |= CHEEVOS_DIRTY_CONDITIONS;
 
-   if (reset_conds)
-   {
-      dirty = 0;
-
-      for (condset = cheevo->condsets; condset < end; condset++)
-         dirty |= cheevos_reset_cond_set(condset, 0);
-
-      if (dirty)
-         cheevo->dirty |= CHEEVOS_DIRTY_CONDITIONS;
-   }
-
-   return ret_val && ret_val_sub_cond;
+   return valid;
 }
 
 static void cheevos_url_encode(const char *str, char *encoded, size_t len)
@@ -1480,14 +1365,15 @@ static void cheevos_unlocked(void *task_data, void *user_data, const char *error
    }
 }
 
-static void cheevos_test_cheevo_set(const cheevoset_t *set)
+static void cheevos_test_cheevo_set(const cheevoset_t *set, unsigned first)
 {
    cheevo_t *cheevo    = NULL;
    const cheevo_t *end = set->cheevos + set->count;
 
    for (cheevo = set->cheevos; cheevo < end; cheevo++)
    {
-      if (cheevo->active && cheevos_test_cheevo(cheevo))
+      if (cheevo->active && cheevos_test_cheevo(cheevo,
+               first + (unsigned)(cheevo - set->cheevos)))
       {
          char url[256];
 
@@ -2336,8 +2222,16 @@ bool cheevos_unload(void)
    cheevos_free_cheevo_set(&cheevos_locals.core);
    cheevos_free_cheevo_set(&cheevos_locals.unofficial);
 
+   cheevos_eval_free(cheevos_locals.eval);
+   cheevos_locals.eval   = NULL;
    cheevos_locals.loaded = 0;
 
+#ifdef CHEEVOS_TRACE
+   if (cheevos_locals.trace)
+      fclose(cheevos_locals.trace);
+   cheevos_locals.trace  = NULL;
+#endif
+
    return true;
 }
 
@@ -2377,10 +2271,17 @@ bool cheevos_test(void)
       if (!settings->cheevos.enable)
          return false;
 
-      cheevos_test_cheevo_set(&cheevos_locals.core);
+      cheevos_eval_snapshot(cheevos_locals.eval);
+
+#ifdef CHEEVOS_TRACE
+      cheevos_trace_frame();
+#endif
+
+      cheevos_test_cheevo_set(&cheevos_locals.core, 0);
 
       if (settings->cheevos.test_unofficial)
-         cheevos_test_cheevo_set(&cheevos_locals.unofficial);
+         cheevos_test_cheevo_set(&cheevos_locals.unofficial,
+               cheevos_locals.core.count);
    }
 
    return true;
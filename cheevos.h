@@ -30,15 +30,82 @@ typedef struct cheevos_ctx_desc
    size_t len;
 } cheevos_ctx_desc_t;
 
+enum
+{
+   CHEEVOS_VAR_SIZE_BIT_0 = 0,
+   CHEEVOS_VAR_SIZE_BIT_1,
+   CHEEVOS_VAR_SIZE_BIT_2,
+   CHEEVOS_VAR_SIZE_BIT_3,
+   CHEEVOS_VAR_SIZE_BIT_4,
+   CHEEVOS_VAR_SIZE_BIT_5,
+   CHEEVOS_VAR_SIZE_BIT_6,
+   CHEEVOS_VAR_SIZE_BIT_7,
+   CHEEVOS_VAR_SIZE_NIBBLE_LOWER,
+   CHEEVOS_VAR_SIZE_NIBBLE_UPPER,
+   /* Byte, */
+   CHEEVOS_VAR_SIZE_EIGHT_BITS, /* =Byte, */
+   CHEEVOS_VAR_SIZE_SIXTEEN_BITS,
+   CHEEVOS_VAR_SIZE_THIRTYTWO_BITS,
+
+   CHEEVOS_VAR_SIZE_LAST
+}; /* cheevos_var_t.size */
+
+enum
+{
+   /* compare to the value of a live address in RAM */
+   CHEEVOS_VAR_TYPE_ADDRESS = 0,
+
+   /* a number. assume 32 bit */
+   CHEEVOS_VAR_TYPE_VALUE_COMP,  
+
+   /* the value last known at this address. */
+   CHEEVOS_VAR_TYPE_DELTA_MEM,   
+
+   /* a custom user-set variable */
+   CHEEVOS_VAR_TYPE_DYNAMIC_VAR,
+
+   CHEEVOS_VAR_TYPE_LAST
+}; /* cheevos_var_t.type */
+
+enum
+{
+   CHEEVOS_COND_OP_EQUALS = 0,
+   CHEEVOS_COND_OP_LESS_THAN,
+   CHEEVOS_COND_OP_LESS_THAN_OR_EQUAL,
+   CHEEVOS_COND_OP_GREATER_THAN,
+   CHEEVOS_COND_OP_GREATER_THAN_OR_EQUAL,
+   CHEEVOS_COND_OP_NOT_EQUAL_TO,
+
+   CHEEVOS_COND_OP_LAST
+}; /* cheevos_cond_t.op */
+
+enum
+{
+   CHEEVOS_COND_TYPE_STANDARD = 0,
+   CHEEVOS_COND_TYPE_PAUSE_IF,
+   CHEEVOS_COND_TYPE_RESET_IF,
+
+   CHEEVOS_COND_TYPE_LAST
+}; /* cheevos_cond_t.type */
+
 typedef struct
 {
    unsigned size;
    unsigned type;
    int      bank_id;
    unsigned value;
-   unsigned previous;
 } cheevos_var_t;
 
+typedef struct
+{
+   unsigned type;
+   unsigned req_hits;
+
+   cheevos_var_t source;
+   unsigned      op;
+   cheevos_var_t target;
+} cheevos_cond_t;
+
 bool cheevos_load(const void *data);
 
 void cheevos_populate_menu(void *data);
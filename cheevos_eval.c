@@ -0,0 +1,542 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+
+#include "cheevos_eval.h"
+
+/* Operands are read as 32 bits and then shifted and masked,
+ * so the snapshot ends with this many zero bytes. They also
+ * stand in for memory which isn't mapped. */
+#define CHEEVOS_EVAL_PADDING 4
+
+typedef struct
+{
+   /* Points into the snapshot once compiled, into the
+    * emulated memory before that. */
+   const uint8_t *live;
+   uint32_t shift;
+   uint32_t mask;
+   uint32_t constant;
+   /* All ones for delta operands, which yield the value
+    * of the previous test. */
+   uint32_t delta;
+   uint32_t previous;
+   unsigned width;
+} cheevos_eval_operand_t;
+
+typedef struct
+{
+   cheevos_eval_operand_t source;
+   cheevos_eval_operand_t target;
+   /* Which outcomes pass: bit 0 is less than, bit 1 equal
+    * and bit 2 greater than. */
+   uint32_t accept;
+   unsigned req_hits;
+   unsigned curr_hits;
+} cheevos_eval_op_t;
+
+typedef struct
+{
+   /* Pause conditions come first, then the standard ones,
+    * then the resets. */
+   unsigned first;
+   unsigned pauses;
+   unsigned standards;
+   unsigned resets;
+} cheevos_eval_set_t;
+
+typedef struct
+{
+   unsigned first;
+   unsigned count;
+} cheevos_eval_cheevo_t;
+
+typedef struct
+{
+   const uint8_t *src;
+   size_t offset;
+   size_t size;
+} cheevos_eval_run_t;
+
+typedef struct
+{
+   const uint8_t *ptr;
+   cheevos_eval_operand_t *operand;
+} cheevos_eval_ref_t;
+
+struct cheevos_eval
+{
+   cheevos_eval_memory_t get_memory;
+
+   cheevos_eval_op_t *ops;
+   unsigned op_count;
+   unsigned op_capacity;
+
+   cheevos_eval_set_t *sets;
+   unsigned set_count;
+   unsigned set_capacity;
+
+   cheevos_eval_cheevo_t *cheevos;
+   unsigned cheevo_count;
+   unsigned cheevo_capacity;
+
+   cheevos_eval_run_t *runs;
+   unsigned run_count;
+
+   uint8_t *snapshot;
+};
+
+static const uint32_t cheevos_eval_accept[CHEEVOS_COND_OP_LAST] =
+{
+   1 << 1,              /* CHEEVOS_COND_OP_EQUALS */
+   1 << 0,              /* CHEEVOS_COND_OP_LESS_THAN */
+   1 << 0 | 1 << 1,     /* CHEEVOS_COND_OP_LESS_THAN_OR_EQUAL */
+   1 << 2,              /* CHEEVOS_COND_OP_GREATER_THAN */
+   1 << 1 | 1 << 2,     /* CHEEVOS_COND_OP_GREATER_THAN_OR_EQUAL */
+   1 << 0 | 1 << 2,     /* CHEEVOS_COND_OP_NOT_EQUAL_TO */
+};
+
+/* Returns the array with room for one more element, or NULL. */
+static void *cheevos_eval_grow(void *data, unsigned *capacity,
+      unsigned count, size_t size)
+{
+   void *grown;
+   unsigned new_capacity;
+
+   if (count < *capacity)
+      return data;
+
+   new_capacity = *capacity ? *capacity * 2 : 64;
+   grown        = realloc(data, new_capacity * size);
+
+   if (grown)
+      *capacity = new_capacity;
+   return grown;
+}
+
+unsigned cheevos_eval_var_width(const cheevos_var_t *var)
+{
+   if (     var->type != CHEEVOS_VAR_TYPE_ADDRESS
+         && var->type != CHEEVOS_VAR_TYPE_DELTA_MEM)
+      return 0;
+
+   switch (var->size)
+   {
+      case CHEEVOS_VAR_SIZE_SIXTEEN_BITS:
+         return 2;
+      case CHEEVOS_VAR_SIZE_THIRTYTWO_BITS:
+         return 4;
+      default:
+         break;
+   }
+
+   return 1;
+}
+
+static void cheevos_eval_compile_var(cheevos_eval_t *eval,
+      cheevos_eval_operand_t *operand, const cheevos_var_t *var)
+{
+   memset(operand, 0, sizeof(*operand));
+
+   switch (var->type)
+   {
+      case CHEEVOS_VAR_TYPE_VALUE_COMP:
+         operand->constant = var->value;
+         return;
+      case CHEEVOS_VAR_TYPE_ADDRESS:
+      case CHEEVOS_VAR_TYPE_DELTA_MEM:
+         break;
+      default:
+         return;
+   }
+
+   operand->delta = var->type == CHEEVOS_VAR_TYPE_DELTA_MEM ? ~0U : 0;
+   operand->width = cheevos_eval_var_width(var);
+
+   switch (var->size)
+   {
+      case CHEEVOS_VAR_SIZE_NIBBLE_LOWER:
+         operand->mask  = 0x0f;
+         break;
+      case CHEEVOS_VAR_SIZE_NIBBLE_UPPER:
+         operand->shift = 4;
+         operand->mask  = 0x0f;
+         break;
+      case CHEEVOS_VAR_SIZE_EIGHT_BITS:
+         operand->mask  = 0xff;
+         break;
+      case CHEEVOS_VAR_SIZE_SIXTEEN_BITS:
+         operand->mask  = 0xffff;
+         break;
+      case CHEEVOS_VAR_SIZE_THIRTYTWO_BITS:
+         operand->mask  = 0xffffffff;
+         break;
+      default:
+         operand->shift = var->size - CHEEVOS_VAR_SIZE_BIT_0;
+         operand->mask  = 1;
+         break;
+   }
+
+   if (var->bank_id >= 0)
+      operand->live = eval->get_memory(var);
+}
+
+cheevos_eval_t *cheevos_eval_new(cheevos_eval_memory_t get_memory)
+{
+   cheevos_eval_t *eval = (cheevos_eval_t*)calloc(1, sizeof(*eval));
+
+   if (!eval)
+      return NULL;
+
+   eval->get_memory = get_memory;
+   return eval;
+}
+
+void cheevos_eval_free(cheevos_eval_t *eval)
+{
+   if (!eval)
+      return;
+
+   free(eval->ops);
+   free(eval->sets);
+   free(eval->cheevos);
+   free(eval->runs);
+   free(eval->snapshot);
+   free(eval);
+}
+
+unsigned cheevos_eval_add_cheevo(cheevos_eval_t *eval)
+{
+   cheevos_eval_cheevo_t *cheevo = (cheevos_eval_cheevo_t*)
+      cheevos_eval_grow(eval->cheevos, &eval->cheevo_capacity,
+            eval->cheevo_count, sizeof(*eval->cheevos));
+
+   if (!cheevo)
+      return ~0U;
+
+   eval->cheevos = cheevo;
+   cheevo        = eval->cheevos + eval->cheevo_count;
+   cheevo->first = eval->set_count;
+   cheevo->count = 0;
+
+   return eval->cheevo_count++;
+}
+
+bool cheevos_eval_add_condset(cheevos_eval_t *eval,
+      const cheevos_cond_t *conds, unsigned count)
+{
+   unsigned i, type;
+   cheevos_eval_set_t *set = NULL;
+   cheevos_eval_op_t *op   = NULL;
+
+   if (!eval->cheevo_count)
+      return false;
+
+   set = (cheevos_eval_set_t*)cheevos_eval_grow(eval->sets,
+         &eval->set_capacity, eval->set_count, sizeof(*eval->sets));
+
+   if (!set)
+      return false;
+
+   eval->sets = set;
+   set        = eval->sets + eval->set_count;
+   memset(set, 0, sizeof(*set));
+   set->first = eval->op_count;
+
+   /* Group the conditions by the order they are tested in, this
+    * doesn't change the order within each group. */
+   for (type = 0; type < CHEEVOS_COND_TYPE_LAST; type++)
+   {
+      static const unsigned order[CHEEVOS_COND_TYPE_LAST] =
+      {
+         CHEEVOS_COND_TYPE_PAUSE_IF,
+         CHEEVOS_COND_TYPE_STANDARD,
+         CHEEVOS_COND_TYPE_RESET_IF,
+      };
+
+      for (i = 0; i < count; i++)
+      {
+         if (conds[i].type != order[type])
+            continue;
+
+         op = (cheevos_eval_op_t*)cheevos_eval_grow(eval->ops,
+               &eval->op_capacity, eval->op_count, sizeof(*eval->ops));
+
+         if (!op)
+            return false;
+
+         eval->ops     = op;
+         op            = eval->ops + eval->op_count++;
+         cheevos_eval_compile_var(eval, &op->source, &conds[i].source);
+         cheevos_eval_compile_var(eval, &op->target, &conds[i].target);
+         op->accept    = conds[i].op < CHEEVOS_COND_OP_LAST
+            ? cheevos_eval_accept[conds[i].op] : 7;
+         op->req_hits  = conds[i].req_hits;
+         op->curr_hits = 0;
+
+         switch (order[type])
+         {
+            case CHEEVOS_COND_TYPE_PAUSE_IF:
+               set->pauses++;
+               break;
+            case CHEEVOS_COND_TYPE_STANDARD:
+               set->standards++;
+               break;
+            default:
+               set->resets++;
+               break;
+         }
+      }
+   }
+
+   eval->set_count++;
+   eval->cheevos[eval->cheevo_count - 1].count++;
+   return true;
+}
+
+static int cheevos_eval_ref_cmp(const void *a, const void *b)
+{
+   uintptr_t pa = (uintptr_t)((const cheevos_eval_ref_t*)a)->ptr;
+   uintptr_t pb = (uintptr_t)((const cheevos_eval_ref_t*)b)->ptr;
+
+   return pa < pb ? -1 : pa > pb;
+}
+
+bool cheevos_eval_compile(cheevos_eval_t *eval)
+{
+   unsigned i, count;
+   size_t size                = 0;
+   cheevos_eval_ref_t *refs   = NULL;
+   size_t *offsets            = NULL;
+   cheevos_eval_run_t *run    = NULL;
+
+   refs    = (cheevos_eval_ref_t*)malloc(
+         (2 * eval->op_count + 1) * sizeof(*refs));
+   offsets = (size_t*)malloc((2 * eval->op_count + 1) * sizeof(*offsets));
+   /* There can't be more runs than referencing operands. */
+   eval->runs = (cheevos_eval_run_t*)malloc(
+         (2 * eval->op_count + 1) * sizeof(*eval->runs));
+
+   if (!refs || !offsets || !eval->runs)
+      goto error;
+
+   for (i = 0, count = 0; i < eval->op_count; i++)
+   {
+      cheevos_eval_op_t *op = eval->ops + i;
+
+      if (op->source.live)
+      {
+         refs[count].ptr       = op->source.live;
+         refs[count++].operand = &op->source;
+      }
+
+      if (op->target.live)
+      {
+         refs[count].ptr       = op->target.live;
+         refs[count++].operand = &op->target;
+      }
+   }
+
+   /* Sort the referenced addresses and merge the ones that touch
+    * or overlap, so each byte is only copied once per frame. */
+   qsort(refs, count, sizeof(*refs), cheevos_eval_ref_cmp);
+
+   for (i = 0; i < count; i++)
+   {
+      const uint8_t *ptr = refs[i].ptr;
+      size_t width       = refs[i].operand->width;
+
+      if (run && (uintptr_t)ptr <= (uintptr_t)(run->src + run->size))
+      {
+         size_t end = (size_t)(ptr - run->src) + width;
+
+         if (end > run->size)
+         {
+            size     += end - run->size;
+            run->size = end;
+         }
+      }
+      else
+      {
+         run         = eval->runs + eval->run_count++;
+         run->src    = ptr;
+         run->offset = size;
+         run->size   = width;
+         size       += width;
+      }
+
+      offsets[i] = run->offset + (size_t)(ptr - run->src);
+   }
+
+   eval->snapshot = (uint8_t*)calloc(size + CHEEVOS_EVAL_PADDING, 1);
+
+   if (!eval->snapshot)
+      goto error;
+
+   for (i = 0; i < count; i++)
+      refs[i].operand->live = eval->snapshot + offsets[i];
+
+   /* Constants and unmapped memory read the zeros at the end. */
+   for (i = 0; i < eval->op_count; i++)
+   {
+      cheevos_eval_op_t *op = eval->ops + i;
+
+      if (!op->source.live)
+         op->source.live = eval->snapshot + size;
+      if (!op->target.live)
+         op->target.live = eval->snapshot + size;
+   }
+
+   free(refs);
+   free(offsets);
+   return true;
+
+error:
+   free(refs);
+   free(offsets);
+   free(eval->runs);
+   eval->runs      = NULL;
+   eval->run_count = 0;
+   return false;
+}
+
+void cheevos_eval_snapshot(cheevos_eval_t *eval)
+{
+   const cheevos_eval_run_t *run = eval->runs;
+   const cheevos_eval_run_t *end = run + eval->run_count;
+
+   for (; run < end; run++)
+      memcpy(eval->snapshot + run->offset, run->src, run->size);
+}
+
+static INLINE uint32_t cheevos_eval_operand(cheevos_eval_operand_t *operand)
+{
+   const uint8_t *live = operand->live;
+   uint32_t value      = (uint32_t)live[0]
+                       | (uint32_t)live[1] << 8
+                       | (uint32_t)live[2] << 16
+                       | (uint32_t)live[3] << 24;
+   uint32_t result;
+
+   value              = ((value >> operand->shift) & operand->mask)
+                      | operand->constant;
+   result             = (value & ~operand->delta)
+                      | (operand->previous & operand->delta);
+   operand->previous  = value;
+
+   return result;
+}
+
+static INLINE unsigned cheevos_eval_op(cheevos_eval_op_t *op)
+{
+   uint32_t sval = cheevos_eval_operand(&op->source);
+   uint32_t tval = cheevos_eval_operand(&op->target);
+
+   return (op->accept >> ((sval >= tval) + (sval > tval))) & 1;
+}
+
+static bool cheevos_eval_test_set(cheevos_eval_t *eval,
+      const cheevos_eval_set_t *set, bool *dirty, bool *reset)
+{
+   unsigned valid;
+   unsigned set_valid          = 1;
+   cheevos_eval_op_t *op        = eval->ops + set->first;
+   const cheevos_eval_op_t *end = op + set->pauses;
+
+   /* If any pause condition is true, retain the old state. */
+   for (; op < end; op++)
+   {
+      op->curr_hits = cheevos_eval_op(op);
+
+      if (op->curr_hits)
+      {
+         *dirty = true;
+         return false;
+      }
+   }
+
+   end += set->standards;
+
+   for (; op < end; op++)
+   {
+      /* Satisfied hit counts aren't tested anymore. */
+      if (op->req_hits != 0 && op->curr_hits >= op->req_hits)
+         continue;
+
+      valid          = cheevos_eval_op(op);
+      op->curr_hits += valid;
+      *dirty        |= valid;
+      set_valid     &= valid & (op->curr_hits >= op->req_hits);
+   }
+
+   end += set->resets;
+
+   for (; op < end; op++)
+   {
+      if (cheevos_eval_op(op))
+      {
+         *reset = true;
+         return false;
+      }
+   }
+
+   return set_valid;
+}
+
+static bool cheevos_eval_reset_set(cheevos_eval_t *eval,
+      const cheevos_eval_set_t *set)
+{
+   unsigned dirty               = 0;
+   cheevos_eval_op_t *op        = eval->ops + set->first;
+   const cheevos_eval_op_t *end = op
+      + set->pauses + set->standards + set->resets;
+
+   for (; op < end; op++)
+   {
+      dirty        |= op->curr_hits;
+      op->curr_hits = 0;
+   }
+
+   return dirty != 0;
+}
+
+bool cheevos_eval_test(cheevos_eval_t *eval, unsigned cheevo, bool *dirty)
+{
+   bool reset                     = false;
+   bool valid                     = false;
+   const cheevos_eval_cheevo_t *c = eval->cheevos + cheevo;
+   const cheevos_eval_set_t *set  = eval->sets + c->first;
+   const cheevos_eval_set_t *end  = set + c->count;
+   bool alt_valid                 = c->count == 1;
+
+   *dirty = false;
+
+   if (set < end)
+      valid = cheevos_eval_test_set(eval, set++, dirty, &reset);
+
+   for (; set < end; set++)
+      alt_valid |= cheevos_eval_test_set(eval, set, dirty, &reset);
+
+   if (reset)
+   {
+      for (set = eval->sets + c->first; set < end; set++)
+         *dirty |= cheevos_eval_reset_set(eval, set);
+   }
+
+   return valid && alt_valid;
+}
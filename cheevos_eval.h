@@ -0,0 +1,80 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RARCH_CHEEVOS_EVAL_H
+#define __RARCH_CHEEVOS_EVAL_H
+
+#include <stdint.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+#include "cheevos.h"
+
+RETRO_BEGIN_DECLS
+
+/* Achievement conditions compiled into a flat array of operations.
+ *
+ * Every operand points into a snapshot of the emulated memory, which
+ * holds each byte referenced by any condition exactly once. The
+ * snapshot is taken once per frame, after that testing a condition
+ * doesn't look anything up anymore. */
+
+typedef struct cheevos_eval cheevos_eval_t;
+
+/* Returns the host address of an operand, or NULL if it isn't mapped. */
+typedef uint8_t *(*cheevos_eval_memory_t)(const cheevos_var_t *var);
+
+cheevos_eval_t *cheevos_eval_new(cheevos_eval_memory_t get_memory);
+
+void cheevos_eval_free(cheevos_eval_t *eval);
+
+/* Starts a new achievement and returns its index. */
+unsigned cheevos_eval_add_cheevo(cheevos_eval_t *eval);
+
+/* Adds a condition set to the last achievement. The first one
+ * is the core set, the others are alternatives. */
+bool cheevos_eval_add_condset(cheevos_eval_t *eval,
+      const cheevos_cond_t *conds, unsigned count);
+
+/* Lays out the snapshot, call once after all achievements were added. */
+bool cheevos_eval_compile(cheevos_eval_t *eval);
+
+/* Copies the referenced memory, call once per frame before testing. */
+void cheevos_eval_snapshot(cheevos_eval_t *eval);
+
+/* Tests an achievement, returns true if it triggered. *dirty is
+ * set if any hit count changed. */
+bool cheevos_eval_test(cheevos_eval_t *eval, unsigned cheevo, bool *dirty);
+
+/* Returns how many bytes of memory a variable reads, 0 for constants. */
+unsigned cheevos_eval_var_width(const cheevos_var_t *var);
+
+/* Memory traces, see CHEEVOS_TRACE in cheevos.c and tools/cheevos_bench.
+ *
+ * All fields are native uint32_t. The header is the magic and the
+ * version, then the number of achievements, then for each one the
+ * number of condition sets, then for each set the number of
+ * conditions, then for each condition its type, req_hits, op and
+ * the size, type, bank_id and value of its source and target.
+ *
+ * One record per frame follows, holding the memory read by every
+ * source and target in the same order, cheevos_eval_var_width()
+ * bytes each. */
+#define CHEEVOS_TRACE_MAGIC   0x54564843 /* "CHVT" */
+#define CHEEVOS_TRACE_VERSION 1
+
+RETRO_END_DECLS
+
+#endif /* __RARCH_CHEEVOS_EVAL_H */
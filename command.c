@@ -72,6 +72,7 @@
 #include "content.h"
 #include "dirs.h"
 #include "movie.h"
+#include "runahead.h"
 #include "paths.h"
 #include "msg_hash.h"
 #include "retroarch.h"
@@ -193,6 +194,18 @@ static bool command_set_shader(const char *arg)
 }
 
 
+static bool command_rewind_seconds(const char *arg)
+{
+   struct retro_system_av_info *av_info = video_viewport_get_system_av_info();
+   float seconds                        = (float)strtod(arg, NULL);
+
+   if (seconds <= 0.0f || !av_info)
+      return false;
+
+   return state_manager_seek_back(
+         (unsigned)(seconds * av_info->timing.fps + 0.5f));
+}
+
 #ifdef HAVE_CHEEVOS
 static bool command_read_ram(const char *arg)
 {
@@ -256,6 +269,7 @@ static bool command_write_ram(const char *arg)
 
 static const struct cmd_action_map action_map[] = {
    { "SET_SHADER", command_set_shader, "<shader path>" },
+   { "REWIND_SECONDS", command_rewind_seconds, "<seconds>" },
 #ifdef HAVE_CHEEVOS
    { "READ_CORE_RAM", command_read_ram, "<address> <number of bytes>" },
    { "WRITE_CORE_RAM", command_write_ram, "<address> <byte1> <byte2> ..." },
@@ -1187,6 +1201,8 @@ static void command_event_deinit_core(bool reinit)
    cheevos_unload();
 #endif
 
+   runahead_deinit();
+
    core_unload_game();
    core_unload();
    core_uninit_symbols();
@@ -19,6 +19,7 @@
 
 #include <boolean.h>
 #include "gfx/video_driver.h"
+#include "audio/audio_resampler_driver.h"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -444,6 +445,11 @@ static const unsigned hard_sync_frames = 0;
  */
 static const unsigned frame_delay = 0;
 
+/* Picks the frame delay automatically from measured core
+ * and present times, overriding video_frame_delay.
+ */
+static const bool frame_delay_auto = false;
+
 /* Inserts a black frame inbetween frames.
  * Useful for 120 Hz monitors who want to play 60 Hz material with eliminated
  * ghosting. video_refresh_rate should still be configured as if it
@@ -472,6 +478,11 @@ static const bool threaded_data_runloop_enable = true;
 static const bool threaded_data_runloop_enable = false;
 #endif
 
+/* Number of worker threads used by the threaded data runloop.
+ * Worker threads alternate between preferring CPU bound and
+ * I/O bound tasks (e.g. HTTP transfers, image loading). */
+static const unsigned threaded_data_runloop_workers = 1;
+
 /* Set to true if HW render cores should get their private context. */
 static const bool video_shared_context = false;
 
@@ -720,6 +731,14 @@ static const float max_timing_skew = 0.05;
 /* Default audio volume in dB. (0.0 dB == unity gain). */
 static const float audio_volume = 0.0;
 
+/* Run the audio DSP filter chain on its own thread.
+ * Adds one audio block of latency. */
+static const bool audio_dsp_threaded = false;
+
+/* Audio resampler quality, one of RESAMPLER_QUALITY_*.
+ * Higher levels cost more CPU time per frame. */
+static const unsigned audio_resampler_quality_level = RESAMPLER_QUALITY_DONTCARE;
+
 /* MISC */
 
 /* Enables displaying the current frames per second. */
@@ -736,6 +755,30 @@ static const unsigned rewind_buffer_size = 20 << 20; /* 20MiB */
 /* How many frames to rewind at a time. */
 static const unsigned rewind_granularity = 1;
 
+/* Compress rewind snapshots on a worker thread instead of
+ * inside the frame. Only the core serialization stays on
+ * the main thread. */
+static const bool rewind_threaded = false;
+
+/* Store a full keyframe every N rewind entries, so that the
+ * history can be seeked without undoing every single delta.
+ * Keyframes are taken out of the rewind buffer. 0 disables them. */
+static const unsigned rewind_keyframe_interval = 0;
+
+/* Compress each rewind delta a second time with zlib at this
+ * level (1-9), to fit more history in the rewind buffer.
+ * 0 disables it. Only available when built with zlib. */
+static const unsigned rewind_compression_level = 0;
+
+/* Run the core this many frames ahead of the input, showing
+ * the last one, to hide input lag built into the game.
+ * Needs savestate support from the core. 0 disables it. */
+static const unsigned run_ahead_frames = 0;
+
+/* Run the frames ahead on a second instance of the core,
+ * so rolling back does not disturb the first one's audio. */
+static const bool run_ahead_secondary_instance = false;
+
 /* Pause gameplay when gameplay loses focus. */
 #ifdef EMSCRIPTEN
 static const bool pause_nonactive = false;
@@ -714,7 +714,10 @@ static int populate_settings_bool(settings_t *settings, struct config_bool_setti
    SETTING_BOOL("ui_menubar_enable",             &settings->ui.menubar_enable, true, true, false);
    SETTING_BOOL("suspend_screensaver_enable",    &settings->ui.suspend_screensaver_enable, true, true, false);
    SETTING_BOOL("rewind_enable",                 &settings->rewind_enable, true, rewind_enable, false);
+   SETTING_BOOL("rewind_threaded",               &settings->rewind_threaded, true, rewind_threaded, false);
+   SETTING_BOOL("run_ahead_secondary_instance",  &settings->run_ahead_secondary_instance, true, run_ahead_secondary_instance, false);
    SETTING_BOOL("audio_sync",                    &settings->audio.sync, true, audio_sync, false);
+   SETTING_BOOL("audio_dsp_threaded",            &settings->audio.dsp_threaded, true, audio_dsp_threaded, false);
    SETTING_BOOL("video_shader_enable",           &settings->video.shader_enable, true, shader_enable, false);
 
    /* Let implementation decide if automatic, or 1:1 PAR. */
@@ -736,6 +739,7 @@ static int populate_settings_bool(settings_t *settings, struct config_bool_setti
    SETTING_BOOL("video_vsync",                   &settings->video.vsync, true, vsync, false);
    SETTING_BOOL("video_hard_sync",               &settings->video.hard_sync, true, hard_sync, false);
    SETTING_BOOL("video_black_frame_insertion",   &settings->video.black_frame_insertion, true, black_frame_insertion, false);
+   SETTING_BOOL("video_frame_delay_auto",        &settings->video.frame_delay_auto, true, frame_delay_auto, false);
    SETTING_BOOL("video_disable_composition",     &settings->video.disable_composition, true, disable_composition, false);
    SETTING_BOOL("pause_nonactive",               &settings->pause_nonactive, true, pause_nonactive, false);
    SETTING_BOOL("video_gpu_screenshot",          &settings->video.gpu_screenshot, true, gpu_screenshot, false);
@@ -880,7 +884,11 @@ static int populate_settings_int(settings_t *settings, struct config_int_setting
    SETTING_INT("input_menu_toggle_gamepad_combo", &settings->input.menu_toggle_gamepad_combo, true, menu_toggle_gamepad_combo, false);
    SETTING_INT("audio_latency",                &settings->audio.latency, false, 0 /* TODO */, false);
    SETTING_INT("audio_block_frames",           &settings->audio.block_frames, true, 0, false);
+   SETTING_INT("audio_resampler_quality",      &settings->audio.resampler_quality, true, audio_resampler_quality_level, false);
    SETTING_INT("rewind_granularity",           &settings->rewind_granularity, true, rewind_granularity, false);
+   SETTING_INT("rewind_keyframe_interval",     &settings->rewind_keyframe_interval, true, rewind_keyframe_interval, false);
+   SETTING_INT("rewind_compression_level",     &settings->rewind_compression_level, true, rewind_compression_level, false);
+   SETTING_INT("run_ahead_frames",             &settings->run_ahead_frames, true, run_ahead_frames, false);
    SETTING_INT("autosave_interval",            &settings->autosave_interval,  true, autosave_interval, false);
    SETTING_INT("libretro_log_level",           &settings->libretro_log_level, true, libretro_log_level, false);
    SETTING_INT("keyboard_gamepad_mapping_type",&settings->input.keyboard_gamepad_mapping_type, true, 1, false);
@@ -896,6 +904,9 @@ static int populate_settings_int(settings_t *settings, struct config_int_setting
    SETTING_INT("video_monitor_index",          &settings->video.monitor_index, true, monitor_index, false);
    SETTING_INT("video_fullscreen_x",           &settings->video.fullscreen_x,  true, fullscreen_x, false);
    SETTING_INT("video_fullscreen_y",           &settings->video.fullscreen_y,  true, fullscreen_y, false);
+#ifdef HAVE_THREADS
+   SETTING_INT("threaded_data_runloop_workers", &settings->threaded_data_runloop_workers, true, threaded_data_runloop_workers, false);
+#endif
 #ifdef HAVE_COMMAND
    SETTING_INT("network_cmd_port",             &settings->network_cmd_port,    true, network_cmd_port, false);
 #endif
@@ -1968,6 +1979,9 @@ static bool config_load_file(const char *path, bool set_defaults,
    if (settings->video.frame_delay > 15)
       settings->video.frame_delay = 15;
 
+   if (settings->run_ahead_frames > 6)
+      settings->run_ahead_frames = 6;
+
    settings->video.swap_interval = MAX(settings->video.swap_interval, 1);
    settings->video.swap_interval = MIN(settings->video.swap_interval, 4);
 
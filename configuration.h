@@ -64,6 +64,7 @@ typedef struct settings
       unsigned swap_interval;
       unsigned hard_sync_frames;
       unsigned frame_delay;
+      bool frame_delay_auto;
 #ifdef GEKKO
       unsigned viwidth;
       bool vfilter;
@@ -205,6 +206,7 @@ typedef struct settings
 
 #ifdef HAVE_THREADS
    bool threaded_data_runloop_enable;
+   unsigned threaded_data_runloop_workers;
 #endif
 
    struct
@@ -240,8 +242,9 @@ typedef struct settings
       unsigned out_rate;
       unsigned block_frames;
       unsigned latency;
+      unsigned resampler_quality;
       bool sync;
-
+      bool dsp_threaded;
 
       bool rate_control;
       float rate_control_delta;
@@ -419,6 +422,12 @@ typedef struct settings
    bool rewind_enable;
    size_t rewind_buffer_size;
    unsigned rewind_granularity;
+   bool rewind_threaded;
+   unsigned rewind_keyframe_interval;
+   unsigned rewind_compression_level;
+
+   unsigned run_ahead_frames;
+   bool run_ahead_secondary_instance;
 
    float slowmotion_ratio;
    float fastforward_ratio;
@@ -17,11 +17,17 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <compat/strl.h>
 #include <retro_endianness.h>
+#include <retro_stat.h>
 #include <file/file_path.h>
 #include <file/archive_file.h>
+#include <lists/string_list.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
 
 #include "libretro-db/libretrodb.h"
 
@@ -686,3 +692,570 @@ const char *database_info_get_current_element_name(database_info_handle_t *handl
       return NULL;
    return handle->list->elems[handle->list_ptr].data;
 }
+
+/* Global CRC32/serial index across every database in a directory.
+ *
+ * Scanning used to open each .rdb with a query for every scanned
+ * file, which is O(files x entries). The index keeps only the fields
+ * lookups need (crc, serial, name) in two chained hash tables, and is
+ * persisted to a sidecar file so it only has to be rebuilt when one
+ * of the databases changes size or modification time. */
+
+#define DATABASE_INDEX_MAGIC   0x58445249U /* "IRDX" */
+#define DATABASE_INDEX_VERSION 1
+#define DATABASE_INDEX_NONE    0xffffffffU
+
+struct database_index_entry
+{
+   uint32_t crc32;
+   uint32_t db_index;
+   uint32_t name;    /* offset into the string pool */
+   uint32_t serial;  /* offset into the string pool */
+   uint32_t next_crc;
+   uint32_t next_serial;
+};
+
+struct database_index_source
+{
+   int64_t mtime;
+   int32_t size;
+};
+
+struct database_index
+{
+   database_index_entry_t *entries;
+   uint32_t count;
+   uint32_t capacity;
+
+   char *pool;
+   uint32_t pool_size;
+   uint32_t pool_capacity;
+
+   uint32_t *crc_buckets;
+   uint32_t *serial_buckets;
+   uint32_t bucket_mask;
+
+   struct database_index_source *sources;
+   unsigned source_count;
+};
+
+static uint32_t database_index_pool_add(database_index_t *index,
+      const char *str, size_t len)
+{
+   uint32_t offset;
+
+   if (index->pool_size + len + 1 > index->pool_capacity)
+   {
+      uint32_t new_cap = index->pool_capacity ?
+         index->pool_capacity * 2 : 64 * 1024;
+      char *new_pool   = NULL;
+
+      while (index->pool_size + len + 1 > new_cap)
+         new_cap *= 2;
+
+      new_pool = (char*)realloc(index->pool, new_cap);
+      if (!new_pool)
+         return DATABASE_INDEX_NONE;
+
+      index->pool          = new_pool;
+      index->pool_capacity = new_cap;
+   }
+
+   offset = index->pool_size;
+   memcpy(index->pool + offset, str, len);
+   index->pool[offset + len] = '\0';
+   index->pool_size += len + 1;
+
+   return offset;
+}
+
+static bool database_index_push(database_index_t *index,
+      uint32_t db_index, uint32_t crc,
+      const struct rmsgpack_dom_value *name,
+      const struct rmsgpack_dom_value *serial)
+{
+   database_index_entry_t *entry = NULL;
+
+   if (index->count == index->capacity)
+   {
+      uint32_t new_cap = index->capacity ? index->capacity * 2 : 4096;
+      database_index_entry_t *new_entries = (database_index_entry_t*)
+         realloc(index->entries, new_cap * sizeof(*new_entries));
+
+      if (!new_entries)
+         return false;
+
+      index->entries  = new_entries;
+      index->capacity = new_cap;
+   }
+
+   entry           = &index->entries[index->count];
+   entry->crc32    = crc;
+   entry->db_index = db_index;
+   entry->name     = DATABASE_INDEX_NONE;
+   entry->serial   = DATABASE_INDEX_NONE;
+
+   if (name)
+      entry->name = database_index_pool_add(index,
+            name->val.string.buff, name->val.string.len);
+   if (serial)
+      entry->serial = database_index_pool_add(index,
+            serial->val.string.buff, serial->val.string.len);
+
+   index->count++;
+
+   return true;
+}
+
+static bool database_index_add_rdb(database_index_t *index,
+      const char *rdb_path, uint32_t db_index)
+{
+   struct rmsgpack_dom_value item;
+   bool ret                 = false;
+   libretrodb_t *db         = libretrodb_new();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+   if (!db || !cur)
+      goto end;
+
+   if (database_cursor_open(db, cur, rdb_path, NULL) != 0)
+      goto end;
+
+   while (libretrodb_cursor_read_item(cur, &item) == 0)
+   {
+      unsigned i;
+      uint32_t crc                              = 0;
+      const struct rmsgpack_dom_value *name     = NULL;
+      const struct rmsgpack_dom_value *serial   = NULL;
+
+      if (item.type != RDT_MAP)
+      {
+         rmsgpack_dom_value_free(&item);
+         continue;
+      }
+
+      for (i = 0; i < item.val.map.len; i++)
+      {
+         const struct rmsgpack_dom_value *key = &item.val.map.items[i].key;
+         const struct rmsgpack_dom_value *val = &item.val.map.items[i].value;
+
+         if (key->type != RDT_STRING)
+            continue;
+
+         switch (msg_hash_calculate(key->val.string.buff))
+         {
+            case DB_CURSOR_CHECKSUM_CRC32:
+               if (val->type == RDT_BINARY && val->val.binary.len >= 4)
+                  crc = swap_if_little32(*(uint32_t*)val->val.binary.buff);
+               break;
+            case DB_CURSOR_SERIAL:
+               if (val->type == RDT_STRING || val->type == RDT_BINARY)
+                  serial = val;
+               break;
+            case DB_CURSOR_NAME:
+               if (val->type == RDT_STRING)
+                  name = val;
+               break;
+         }
+      }
+
+      if (crc || (serial && serial->val.string.len))
+      {
+         if (!database_index_push(index, db_index, crc, name, serial))
+         {
+            rmsgpack_dom_value_free(&item);
+            database_cursor_close(db, cur);
+            goto end;
+         }
+      }
+
+      rmsgpack_dom_value_free(&item);
+   }
+
+   database_cursor_close(db, cur);
+   ret = true;
+
+end:
+   if (db)
+      libretrodb_free(db);
+   if (cur)
+      libretrodb_cursor_free(cur);
+   return ret;
+}
+
+static bool database_index_build_buckets(database_index_t *index)
+{
+   uint32_t i;
+   uint32_t buckets = 1024;
+
+   while (buckets < index->count * 2)
+      buckets *= 2;
+
+   index->crc_buckets    = (uint32_t*)malloc(buckets * sizeof(uint32_t));
+   index->serial_buckets = (uint32_t*)malloc(buckets * sizeof(uint32_t));
+
+   if (!index->crc_buckets || !index->serial_buckets)
+      return false;
+
+   memset(index->crc_buckets, 0xff, buckets * sizeof(uint32_t));
+   memset(index->serial_buckets, 0xff, buckets * sizeof(uint32_t));
+   index->bucket_mask = buckets - 1;
+
+   /* Entries are pushed to the front of their chain, so walk
+    * them backwards to leave every chain in entry order. */
+   for (i = index->count; i-- > 0; )
+   {
+      database_index_entry_t *entry = &index->entries[i];
+
+      entry->next_crc    = DATABASE_INDEX_NONE;
+      entry->next_serial = DATABASE_INDEX_NONE;
+
+      if (entry->crc32)
+      {
+         uint32_t *head  = &index->crc_buckets[
+            entry->crc32 & index->bucket_mask];
+         entry->next_crc = *head;
+         *head           = i;
+      }
+
+      if (entry->serial != DATABASE_INDEX_NONE)
+      {
+         uint32_t *head     = &index->serial_buckets[
+            msg_hash_calculate(index->pool + entry->serial)
+            & index->bucket_mask];
+         entry->next_serial = *head;
+         *head              = i;
+      }
+   }
+
+   return true;
+}
+
+static bool database_index_stat_sources(database_index_t *index,
+      const struct string_list *rdb_list)
+{
+   unsigned i;
+
+   index->source_count = (unsigned)rdb_list->size;
+   index->sources      = (struct database_index_source*)
+      calloc(rdb_list->size + 1, sizeof(*index->sources));
+
+   if (!index->sources)
+      return false;
+
+   for (i = 0; i < rdb_list->size; i++)
+   {
+      index->sources[i].mtime = path_get_mtime(rdb_list->elems[i].data);
+      index->sources[i].size  = path_get_size(rdb_list->elems[i].data);
+   }
+
+   return true;
+}
+
+/* Sidecar layout (native endianness, rejected on magic mismatch):
+ *
+ *   uint32 magic, version, source count, entry count, pool size
+ *   per source: int64 mtime, int32 size, uint32 path length, path
+ *   per entry:  uint32 crc32, db index, name offset, serial offset
+ *   string pool
+ */
+static bool database_index_read(database_index_t *index,
+      const struct string_list *rdb_list, const char *path)
+{
+   unsigned i;
+   uint32_t header[5];
+   ssize_t len       = 0;
+   void *data        = NULL;
+   const uint8_t *p  = NULL;
+   const uint8_t *end = NULL;
+   bool ret          = false;
+
+   if (!filestream_read_file(path, &data, &len) || len < (ssize_t)sizeof(header))
+      goto end;
+
+   p   = (const uint8_t*)data;
+   end = p + len;
+
+   memcpy(header, p, sizeof(header));
+   p += sizeof(header);
+
+   if (     header[0] != DATABASE_INDEX_MAGIC
+         || header[1] != DATABASE_INDEX_VERSION
+         || header[2] != index->source_count)
+      goto end;
+
+   for (i = 0; i < index->source_count; i++)
+   {
+      int64_t mtime;
+      int32_t size;
+      uint32_t path_len;
+      const char *rdb_path = rdb_list->elems[i].data;
+
+      if (end - p < 16)
+         goto end;
+
+      memcpy(&mtime,    p,      sizeof(mtime));
+      memcpy(&size,     p + 8,  sizeof(size));
+      memcpy(&path_len, p + 12, sizeof(path_len));
+      p += 16;
+
+      if ((size_t)(end - p) < path_len)
+         goto end;
+
+      if (     mtime    != index->sources[i].mtime
+            || size     != index->sources[i].size
+            || path_len != strlen(rdb_path)
+            || memcmp(p, rdb_path, path_len))
+         goto end;
+
+      p += path_len;
+   }
+
+   if ((uint64_t)(end - p) != (uint64_t)header[3] * 16 + header[4])
+      goto end;
+
+   index->count    = header[3];
+   index->capacity = header[3];
+   index->entries  = (database_index_entry_t*)
+      calloc(index->count + 1, sizeof(*index->entries));
+   index->pool     = (char*)malloc(header[4] + 1);
+
+   if (!index->entries || !index->pool)
+      goto end;
+
+   for (i = 0; i < index->count; i++)
+   {
+      database_index_entry_t *entry = &index->entries[i];
+
+      memcpy(&entry->crc32,    p,      sizeof(uint32_t));
+      memcpy(&entry->db_index, p + 4,  sizeof(uint32_t));
+      memcpy(&entry->name,     p + 8,  sizeof(uint32_t));
+      memcpy(&entry->serial,   p + 12, sizeof(uint32_t));
+      p += 16;
+
+      if (     entry->db_index >= index->source_count
+            || (entry->name   != DATABASE_INDEX_NONE && entry->name   >= header[4])
+            || (entry->serial != DATABASE_INDEX_NONE && entry->serial >= header[4]))
+         goto end;
+   }
+
+   memcpy(index->pool, p, header[4]);
+   index->pool[header[4]] = '\0';
+   index->pool_size       = header[4];
+   index->pool_capacity   = header[4] + 1;
+
+   ret = true;
+
+end:
+   if (data)
+      free(data);
+   return ret;
+}
+
+static void database_index_write(const database_index_t *index,
+      const struct string_list *rdb_list, const char *path)
+{
+   unsigned i;
+   uint8_t *p       = NULL;
+   uint8_t *data    = NULL;
+   size_t len       = 5 * sizeof(uint32_t)
+      + (size_t)index->count * 16 + index->pool_size;
+   uint32_t header[5];
+
+   for (i = 0; i < index->source_count; i++)
+      len += 16 + strlen(rdb_list->elems[i].data);
+
+   data = (uint8_t*)malloc(len);
+   if (!data)
+      return;
+
+   header[0] = DATABASE_INDEX_MAGIC;
+   header[1] = DATABASE_INDEX_VERSION;
+   header[2] = index->source_count;
+   header[3] = index->count;
+   header[4] = index->pool_size;
+
+   p = data;
+   memcpy(p, header, sizeof(header));
+   p += sizeof(header);
+
+   for (i = 0; i < index->source_count; i++)
+   {
+      const char *rdb_path = rdb_list->elems[i].data;
+      uint32_t path_len    = (uint32_t)strlen(rdb_path);
+
+      memcpy(p,      &index->sources[i].mtime, sizeof(int64_t));
+      memcpy(p + 8,  &index->sources[i].size,  sizeof(int32_t));
+      memcpy(p + 12, &path_len,                sizeof(uint32_t));
+      memcpy(p + 16, rdb_path, path_len);
+      p += 16 + path_len;
+   }
+
+   for (i = 0; i < index->count; i++)
+   {
+      const database_index_entry_t *entry = &index->entries[i];
+
+      memcpy(p,      &entry->crc32,    sizeof(uint32_t));
+      memcpy(p + 4,  &entry->db_index, sizeof(uint32_t));
+      memcpy(p + 8,  &entry->name,     sizeof(uint32_t));
+      memcpy(p + 12, &entry->serial,   sizeof(uint32_t));
+      p += 16;
+   }
+
+   memcpy(p, index->pool, index->pool_size);
+
+   if (!filestream_write_file(path, data, len))
+      RARCH_WARN("Could not write database index: %s\n", path);
+
+   free(data);
+}
+
+static void database_index_reset(database_index_t *index)
+{
+   free(index->entries);
+   free(index->pool);
+   index->entries       = NULL;
+   index->pool          = NULL;
+   index->count         = 0;
+   index->capacity      = 0;
+   index->pool_size     = 0;
+   index->pool_capacity = 0;
+}
+
+database_index_t *database_index_new(const struct string_list *rdb_list,
+      const char *index_path)
+{
+   unsigned i;
+   database_index_t *index = NULL;
+
+   if (!rdb_list || !rdb_list->size)
+      return NULL;
+
+   index = (database_index_t*)calloc(1, sizeof(*index));
+   if (!index)
+      return NULL;
+
+   if (!database_index_stat_sources(index, rdb_list))
+      goto error;
+
+   if (!string_is_empty(index_path) && path_file_exists(index_path)
+         && database_index_read(index, rdb_list, index_path))
+      RARCH_LOG("Loaded database index: %s\n", index_path);
+   else
+   {
+      database_index_reset(index);
+
+      for (i = 0; i < rdb_list->size; i++)
+      {
+         if (!database_index_add_rdb(index, rdb_list->elems[i].data, i))
+            RARCH_WARN("Could not index database: %s\n",
+                  rdb_list->elems[i].data);
+      }
+
+      RARCH_LOG("Built database index with %u entries from %u databases.\n",
+            index->count, index->source_count);
+
+      if (!string_is_empty(index_path))
+         database_index_write(index, rdb_list, index_path);
+   }
+
+   if (!database_index_build_buckets(index))
+      goto error;
+
+   return index;
+
+error:
+   database_index_free(index);
+   return NULL;
+}
+
+void database_index_free(database_index_t *index)
+{
+   if (!index)
+      return;
+
+   free(index->entries);
+   free(index->pool);
+   free(index->crc_buckets);
+   free(index->serial_buckets);
+   free(index->sources);
+   free(index);
+}
+
+const database_index_entry_t *database_index_find_crc(
+      const database_index_t *index, uint32_t crc,
+      const database_index_entry_t *prev)
+{
+   uint32_t i;
+
+   if (!index || !crc)
+      return NULL;
+
+   i = prev ? prev->next_crc : index->crc_buckets[crc & index->bucket_mask];
+
+   for (; i != DATABASE_INDEX_NONE; i = index->entries[i].next_crc)
+      if (index->entries[i].crc32 == crc)
+         return &index->entries[i];
+
+   return NULL;
+}
+
+const database_index_entry_t *database_index_find_serial(
+      const database_index_t *index, const char *serial,
+      const database_index_entry_t *prev)
+{
+   uint32_t i;
+
+   if (!index || string_is_empty(serial))
+      return NULL;
+
+   i = prev ? prev->next_serial : index->serial_buckets[
+      msg_hash_calculate(serial) & index->bucket_mask];
+
+   for (; i != DATABASE_INDEX_NONE; i = index->entries[i].next_serial)
+      if (string_is_equal(index->pool + index->entries[i].serial, serial))
+         return &index->entries[i];
+
+   return NULL;
+}
+
+unsigned database_index_entry_get_db(const database_index_entry_t *entry)
+{
+   return entry ? entry->db_index : 0;
+}
+
+database_info_list_t *database_index_entry_to_list(
+      const database_index_t *index, const database_index_entry_t *entry)
+{
+   database_info_t *info                    = NULL;
+   database_info_list_t *database_info_list = NULL;
+
+   if (!index || !entry)
+      return NULL;
+
+   database_info_list = (database_info_list_t*)
+      calloc(1, sizeof(*database_info_list));
+   info               = (database_info_t*)calloc(1, sizeof(*info));
+
+   if (!database_info_list || !info)
+   {
+      free(database_info_list);
+      free(info);
+      return NULL;
+   }
+
+   info->crc32            = entry->crc32;
+   info->analog_supported = -1;
+   info->rumble_supported = -1;
+   info->coop_supported   = -1;
+
+   if (entry->name != DATABASE_INDEX_NONE)
+      info->name   = strdup(index->pool + entry->name);
+   if (entry->serial != DATABASE_INDEX_NONE)
+      info->serial = strdup(index->pool + entry->serial);
+
+   database_info_list->list  = info;
+   database_info_list->count = 1;
+
+   return database_info_list;
+}
@@ -98,10 +98,17 @@ typedef struct
    size_t count;
 } database_info_list_t;
 
+typedef struct database_index database_index_t;
+
+typedef struct database_index_entry database_index_entry_t;
+
 typedef struct database_state_handle
 {
+   database_index_t *index;
    database_info_list_t *info;
    struct string_list *list;
+   /* Playlists written by this scan, the handle is in attr.p. */
+   struct string_list *playlists;
    size_t list_index;
    size_t entry_index;
    uint32_t crc;
@@ -139,6 +146,42 @@ int database_info_build_query(
  * memory after it is no longer required. */
 char *bin_to_hex_alloc(const uint8_t *data, size_t len);
 
+/**
+ * database_index_new:
+ * @rdb_list           : List of database (.rdb) paths.
+ * @index_path         : Sidecar file to load the index from and
+ *                       save it to. Can be NULL.
+ *
+ * Builds a CRC32/serial lookup index spanning every database in
+ * @rdb_list. Entries remember the position of their database in
+ * @rdb_list. The sidecar is reused as long as every database still
+ * has the same path, size and modification time, and is rebuilt
+ * otherwise.
+ *
+ * Returns: index handle, or NULL on failure.
+ **/
+database_index_t *database_index_new(const struct string_list *rdb_list,
+      const char *index_path);
+
+void database_index_free(database_index_t *index);
+
+/* Returns the next entry matching @crc after @prev, or the first
+ * one if @prev is NULL. Matches come in the order of the entries,
+ * that is by database and then by position in it. */
+const database_index_entry_t *database_index_find_crc(
+      const database_index_t *index, uint32_t crc,
+      const database_index_entry_t *prev);
+
+const database_index_entry_t *database_index_find_serial(
+      const database_index_t *index, const char *serial,
+      const database_index_entry_t *prev);
+
+unsigned database_index_entry_get_db(const database_index_entry_t *entry);
+
+/* NOTE: Allocates memory, free with database_info_list_free. */
+database_info_list_t *database_index_entry_to_list(
+      const database_index_t *index, const database_index_entry_t *entry);
+
 RETRO_END_DECLS
 
 #endif /* CORE_INFO_H_ */
@@ -17,6 +17,7 @@
 
 #include "ShaderLang.h"
 #include "GlslangToSpv.h"
+#include "glslang/Include/revision.h"
 #include <vector>
 #include <iostream>
 #include <cstring>
@@ -386,3 +387,8 @@ bool glslang::compile_spirv(const string &source, Stage stage, std::vector<uint3
    return true;
 }
 
+const char *glslang::compiler_version()
+{
+   // Bump the last part when the resources or messages above change.
+   return "glslang " GLSLANG_REVISION " " GLSLANG_DATE ", vulkan 100, 1";
+}
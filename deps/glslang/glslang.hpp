@@ -18,6 +18,9 @@ namespace glslang
     };
 
     bool compile_spirv(const std::string &source, Stage stage, std::vector<uint32_t> *spirv);
+
+    // Changes whenever compile_spirv() may produce different code for the same source.
+    const char *compiler_version();
 }
 
 #endif
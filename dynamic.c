@@ -24,6 +24,7 @@
 #include <compat/posix_string.h>
 #include <dynamic/dylib.h>
 #include <string/stdstring.h>
+#include <streams/file_stream.h>
 #include <retro_assert.h>
 
 #include <features/features_cpu.h>
@@ -377,11 +378,6 @@ static bool load_symbols(enum rarch_core_type type, struct retro_core_t *current
    switch (type)
    {
       case CORE_TYPE_PLAIN:
-#ifdef HAVE_DYNAMIC
-         if (!load_dynamic_core())
-            return false;
-#endif
-
          SYMBOL(retro_init);
          SYMBOL(retro_deinit);
 
@@ -660,6 +656,11 @@ bool init_libretro_sym(enum rarch_core_type type, struct retro_core_t *current_c
     * Every OS that this program supports should pass this. */
    retro_assert(sizeof(void*) == sizeof(void (*)(void)));
 
+#ifdef HAVE_DYNAMIC
+   if (type == CORE_TYPE_PLAIN && !load_dynamic_core())
+      return false;
+#endif
+
    if (!load_symbols(type, current_core))
       return false;
 
@@ -695,6 +696,114 @@ void uninit_libretro_sym(struct retro_core_t *current_core)
    performance_counters_clear();
 }
 
+#ifdef HAVE_DYNAMIC
+static dylib_t secondary_lib_handle;
+static char secondary_lib_path[PATH_MAX_LENGTH];
+#endif
+
+/**
+ * init_libretro_sym_secondary:
+ * @core                        : Core to fill in.
+ *
+ * Loads a second, independent instance of the currently
+ * loaded core. The dynamic loader hands back the instance
+ * already loaded when asked for the same path twice, so the
+ * library is copied to the cache directory (or next to the
+ * core) first.
+ *
+ * Returns: true on success, or false if the core could not
+ * be copied or loaded.
+ **/
+bool init_libretro_sym_secondary(struct retro_core_t *core)
+{
+#ifdef HAVE_DYNAMIC
+   char dir[PATH_MAX_LENGTH];
+   char name[PATH_MAX_LENGTH];
+   dylib_t primary      = lib_handle;
+   void *buf            = NULL;
+   ssize_t len          = 0;
+   settings_t *settings = config_get_ptr();
+   const char *path     = path_get(RARCH_PATH_CORE);
+
+   if (!lib_handle || secondary_lib_handle || string_is_empty(path))
+      return false;
+
+   dir[0] = name[0] = '\0';
+
+   if (!string_is_empty(settings->directory.cache))
+      strlcpy(dir, settings->directory.cache, sizeof(dir));
+   else
+      fill_pathname_basedir(dir, path, sizeof(dir));
+
+   strlcpy(name, "secondary_", sizeof(name));
+   strlcat(name, path_basename(path), sizeof(name));
+   fill_pathname_join(secondary_lib_path, dir, name,
+         sizeof(secondary_lib_path));
+
+   if (!filestream_read_file(path, &buf, &len))
+      return false;
+
+   if (!filestream_write_file(secondary_lib_path, buf, len))
+   {
+      free(buf);
+      RARCH_ERR("Failed to copy core to \"%s\".\n", secondary_lib_path);
+      return false;
+   }
+
+   free(buf);
+
+   secondary_lib_handle = dylib_load(secondary_lib_path);
+   if (!secondary_lib_handle)
+   {
+      RARCH_ERR("Failed to open secondary core: \"%s\"\n",
+            secondary_lib_path);
+      RARCH_ERR("Error(s): %s\n", dylib_error());
+      remove(secondary_lib_path);
+      return false;
+   }
+
+   /* load_symbols() resolves against lib_handle. */
+   lib_handle = secondary_lib_handle;
+   if (!load_symbols(CORE_TYPE_PLAIN, core))
+   {
+      lib_handle = primary;
+      RARCH_ERR("Failed to load symbols of secondary core: \"%s\"\n",
+            secondary_lib_path);
+      uninit_libretro_sym_secondary(core);
+      return false;
+   }
+   lib_handle = primary;
+
+   RARCH_LOG("Loaded secondary core instance from: \"%s\"\n",
+         secondary_lib_path);
+   return true;
+#else
+   return false;
+#endif
+}
+
+/**
+ * uninit_libretro_sym_secondary:
+ * @core                        : Core to unload.
+ *
+ * Unloads the instance loaded by init_libretro_sym_secondary,
+ * and removes its temporary copy.
+ **/
+void uninit_libretro_sym_secondary(struct retro_core_t *core)
+{
+#ifdef HAVE_DYNAMIC
+   if (secondary_lib_handle)
+   {
+      dylib_close(secondary_lib_handle);
+      remove(secondary_lib_path);
+   }
+   secondary_lib_handle  = NULL;
+   *secondary_lib_path   = '\0';
+#endif
+
+   memset(core, 0, sizeof(struct retro_core_t));
+}
+
 static void rarch_log_libretro(enum retro_log_level level,
       const char *fmt, ...)
 {
@@ -162,6 +162,21 @@ bool init_libretro_sym(enum rarch_core_type type,
  **/
 void uninit_libretro_sym(struct retro_core_t *core);
 
+/**
+ * init_libretro_sym_secondary:
+ *
+ * Loads a second, independent instance of the currently
+ * loaded core. Returns true on success.
+ **/
+bool init_libretro_sym_secondary(struct retro_core_t *core);
+
+/**
+ * uninit_libretro_sym_secondary:
+ *
+ * Unloads the instance loaded by init_libretro_sym_secondary.
+ **/
+void uninit_libretro_sym_secondary(struct retro_core_t *core);
+
 RETRO_END_DECLS
 
 #endif
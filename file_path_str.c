@@ -35,6 +35,8 @@ const char *file_path_str(enum file_path_enum enum_idx)
          return "content.png";
       case FILE_PATH_LUTRO_PLAYLIST:
          return "Lutro.lpl";
+      case FILE_PATH_DATABASE_INDEX:
+         return "database_index.bin";
       case FILE_PATH_NUL:
          return "nul";
       case FILE_PATH_LOG_WARN:
@@ -138,6 +138,10 @@ typedef struct gl
    bool menu_texture_enable;
    bool menu_texture_full_screen;
    float menu_texture_alpha;
+   unsigned menu_texture_width;
+   unsigned menu_texture_height;
+   bool menu_texture_rgb32;
+   enum texture_filter_type menu_texture_filter;
 #endif
 
 #ifdef HAVE_GL_SYNC
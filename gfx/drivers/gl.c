@@ -930,7 +930,58 @@ static void gl_set_texture_frame(void *data,
          width, height, frame,
          base_size);
 
+   gl->menu_texture_alpha  = alpha;
+   gl->menu_texture_width  = width;
+   gl->menu_texture_height = height;
+   gl->menu_texture_rgb32  = rgb32;
+   gl->menu_texture_filter = menu_filter;
+   glBindTexture(GL_TEXTURE_2D, gl->texture[gl->tex_index]);
+
+   context_bind_hw_render(true);
+}
+
+static void gl_set_texture_frame_rows(void *data,
+      const void *frame, bool rgb32, unsigned width, unsigned height,
+      unsigned y, unsigned rows, float alpha)
+{
+   enum texture_filter_type menu_filter;
+   settings_t *settings            = config_get_ptr();
+   unsigned base_size              = rgb32 ? sizeof(uint32_t) : sizeof(uint16_t);
+   bool use_rgba                   = video_driver_supports_rgba();
+   gl_t *gl                        = (gl_t*)data;
+   if (!gl)
+      return;
+
+   menu_filter = settings->menu.linear_filter ? TEXTURE_FILTER_LINEAR : TEXTURE_FILTER_NEAREST;
+
+   /* Only a texture just like the last one can be updated in place. */
+   if (     !gl->menu_texture
+         || gl->menu_texture_width  != width
+         || gl->menu_texture_height != height
+         || gl->menu_texture_rgb32  != rgb32
+         || gl->menu_texture_filter != menu_filter
+         || y + rows > height)
+   {
+      gl_set_texture_frame(data, frame, rgb32, width, height, alpha);
+      return;
+   }
+
    gl->menu_texture_alpha = alpha;
+
+   if (!rows)
+      return;
+
+   context_bind_hw_render(false);
+
+   glBindTexture(GL_TEXTURE_2D, gl->menu_texture);
+   glPixelStorei(GL_UNPACK_ALIGNMENT,
+         video_pixel_get_alignment(width * base_size));
+   glTexSubImage2D(GL_TEXTURE_2D,
+         0, 0, y, width, rows,
+         (use_rgba || !rgb32) ? GL_RGBA : RARCH_GL_TEXTURE_TYPE32,
+         (rgb32) ? RARCH_GL_FORMAT32 : GL_UNSIGNED_SHORT_4_4_4_4,
+         (const uint8_t*)frame + y * width * base_size);
+
    glBindTexture(GL_TEXTURE_2D, gl->texture[gl->tex_index]);
 
    context_bind_hw_render(true);
@@ -2822,6 +2873,9 @@ static const video_poke_interface_t gl_poke_interface = {
    NULL,
 #ifdef HAVE_MENU
    gl_get_current_shader,
+   NULL,
+   NULL,
+   gl_set_texture_frame_rows,
 #endif
 };
 
@@ -47,7 +47,10 @@ typedef struct
 {
    gl_t *gl;
    GLuint tex;
+   /* Size texture coordinates are computed for. */
    unsigned tex_width, tex_height;
+   /* Size of the texture, lags behind while the atlas grows. */
+   unsigned tex_alloc_width, tex_alloc_height;
 
    const font_renderer_driver_t *font_driver;
    void *font_data;
@@ -58,13 +61,17 @@ typedef struct
 
 static void gl_raster_font_free_font(void *data);
 
+/* Uploads the rows of the atlas which changed. The texture is
+ * reallocated and filled completely when the atlas grew. */
 static bool gl_raster_font_upload_atlas(gl_raster_t *font)
 {
-   unsigned i, j;
+   unsigned i, j, y, height;
    GLint  gl_internal                   = GL_LUMINANCE_ALPHA;
    GLenum gl_format                     = GL_LUMINANCE_ALPHA;
    size_t ncomponents                   = 2;
    uint8_t       *tmp                   = NULL;
+   bool realloc_tex                     = font->tex_alloc_width != font->tex_width
+      || font->tex_alloc_height != font->tex_height;
 #if 0
    bool ancient                         = false; /* add a check here if needed */
 #endif
@@ -73,6 +80,9 @@ static bool gl_raster_font_upload_atlas(gl_raster_t *font)
    struct retro_hw_render_callback *hwr = video_driver_get_hw_context();
 #endif
 
+   if (!font_atlas_take_dirty(font->atlas, &y, &height) && !realloc_tex)
+      return true;
+
 #if 0
    if (ancient)
    {
@@ -96,14 +106,28 @@ static bool gl_raster_font_upload_atlas(gl_raster_t *font)
    }
 #endif
 
-   tmp = (uint8_t*)calloc(font->tex_height, font->tex_width * ncomponents);
+   if (realloc_tex)
+   {
+      y      = 0;
+      height = font->tex_height;
+   }
+   else if (y + height > font->tex_alloc_height)
+   {
+      /* Rows the atlas grew by go up with the
+       * reallocated texture, once it's in use. */
+      if (y >= font->tex_alloc_height)
+         return true;
+      height = font->tex_alloc_height - y;
+   }
+
+   tmp = (uint8_t*)calloc(height, font->tex_width * ncomponents);
 
    if (!tmp)
       return false;
 
-   for (i = 0; i < font->atlas->height; ++i)
+   for (i = 0; i < height && y + i < font->atlas->height; ++i)
    {
-      const uint8_t *src = &font->atlas->buffer[i * font->atlas->width];
+      const uint8_t *src = &font->atlas->buffer[(y + i) * font->atlas->width];
       uint8_t       *dst = &tmp[i * font->tex_width * ncomponents];
 
       switch (ncomponents)
@@ -135,14 +159,60 @@ static bool gl_raster_font_upload_atlas(gl_raster_t *font)
       }
    }
 
-   glTexImage2D(GL_TEXTURE_2D, 0, gl_internal, font->tex_width, font->tex_height,
-         0, gl_format, GL_UNSIGNED_BYTE, tmp);
+   if (realloc_tex)
+   {
+      glTexImage2D(GL_TEXTURE_2D, 0, gl_internal, font->tex_width, font->tex_height,
+            0, gl_format, GL_UNSIGNED_BYTE, tmp);
+      font->tex_alloc_width  = font->tex_width;
+      font->tex_alloc_height = font->tex_height;
+   }
+   else
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, font->tex_width, height,
+            gl_format, GL_UNSIGNED_BYTE, tmp);
 
    free(tmp);
 
    return true;
 }
 
+/* The atlas may grow while glyphs are looked up. Texture coordinates
+ * emitted since the last draw refer to the old size, so scale them. */
+static bool gl_raster_font_check_atlas_size(gl_raster_t *font,
+      GLfloat *tex_coords, unsigned vertices)
+{
+   unsigned i;
+   GLfloat scale_x, scale_y;
+   unsigned width  = next_pow2(font->atlas->width);
+   unsigned height = next_pow2(font->atlas->height);
+
+   if (width == font->tex_width && height == font->tex_height)
+      return false;
+
+   scale_x = (GLfloat)font->tex_width  / width;
+   scale_y = (GLfloat)font->tex_height / height;
+
+   for (i = 0; i < vertices; i++)
+   {
+      tex_coords[2 * i + 0] *= scale_x;
+      tex_coords[2 * i + 1] *= scale_y;
+   }
+
+   if (font->block)
+   {
+      video_mut_coords_t *coords = &font->block->carr.coords;
+
+      for (i = 0; i < coords->vertices; i++)
+      {
+         coords->tex_coord[2 * i + 0] *= scale_x;
+         coords->tex_coord[2 * i + 1] *= scale_y;
+      }
+   }
+
+   font->tex_width  = width;
+   font->tex_height = height;
+   return true;
+}
+
 static void *gl_raster_font_init_font(void *data,
       const char *font_path, float font_size)
 {
@@ -179,8 +249,6 @@ static void *gl_raster_font_init_font(void *data,
    if (!gl_raster_font_upload_atlas(font))
       goto error;
 
-   font->atlas->dirty = false;
-
    glBindTexture(GL_TEXTURE_2D, font->gl->texture[font->gl->tex_index]);
 
    return font;
@@ -249,11 +317,7 @@ static void gl_raster_font_draw_vertices(gl_raster_t *font, const video_coords_t
    video_shader_ctx_mvp_t mvp;
    video_shader_ctx_coords_t coords_data;
 
-   if (font->atlas->dirty)
-   {
-      gl_raster_font_upload_atlas(font);
-      font->atlas->dirty = false;
-   }
+   gl_raster_font_upload_atlas(font);
 
    coords_data.handle_data = NULL;
    coords_data.data        = coords;
@@ -324,6 +388,12 @@ static void gl_raster_font_render_line(
          if (!glyph)
             continue;
 
+         if (gl_raster_font_check_atlas_size(font, font_tex_coords, i * 6))
+         {
+            inv_tex_size_x = 1.0f / font->tex_width;
+            inv_tex_size_y = 1.0f / font->tex_height;
+         }
+
          off_x  = glyph->draw_offset_x;
          off_y  = glyph->draw_offset_y;
          tex_x  = glyph->atlas_offset_x;
@@ -26,9 +26,18 @@
 typedef struct
 {
    vk_t *vk;
+   /* Sampled when drawing, updated from texture_staging. */
    struct vk_texture texture;
+   struct vk_texture texture_staging;
+
+   /* Replaced when the atlas grew, but draws recorded
+    * earlier in the frame may still sample them. */
+   struct vk_texture *retired;
+   unsigned num_retired;
+
    const font_renderer_driver_t *font_driver;
    void *font_data;
+   struct font_atlas *atlas;
 
    struct vk_vertex *pv;
    struct vk_buffer_range range;
@@ -37,10 +46,169 @@ typedef struct
 
 static void vulkan_raster_font_free_font(void *data);
 
+static bool vulkan_raster_font_create_textures(vulkan_raster_t *font)
+{
+   if (font->texture.memory != VK_NULL_HANDLE)
+   {
+      struct vk_texture *retired = (struct vk_texture*)realloc(font->retired,
+            (font->num_retired + 1) * sizeof(*retired));
+
+      if (!retired)
+         return false;
+
+      font->retired                      = retired;
+      font->retired[font->num_retired++] = font->texture;
+   }
+
+   /* Only ever used by completed uploads. */
+   if (font->texture_staging.memory != VK_NULL_HANDLE)
+      vulkan_destroy_texture(font->vk->context->device,
+            &font->texture_staging);
+
+   font->texture_staging = vulkan_create_texture(font->vk, NULL,
+         font->atlas->width, font->atlas->height, VK_FORMAT_R8_UNORM,
+         NULL, NULL, VULKAN_TEXTURE_STAGING);
+   vulkan_map_persistent_texture(font->vk->context->device,
+         &font->texture_staging);
+
+   font->texture = vulkan_create_texture(font->vk, NULL,
+         font->atlas->width, font->atlas->height, VK_FORMAT_R8_UNORM,
+         NULL, NULL, VULKAN_TEXTURE_DYNAMIC);
+
+   return font->texture_staging.mapped != NULL;
+}
+
+/* Copies the rows of the atlas which changed to the texture,
+ * which is recreated first when the atlas grew. */
+static void vulkan_raster_font_update_atlas(vulkan_raster_t *font)
+{
+   unsigned i, y, height;
+   VkImageCopy region;
+   VkCommandBuffer staging;
+   VkSubmitInfo submit_info             = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+   VkCommandBufferAllocateInfo cmd_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+   VkCommandBufferBeginInfo begin_info  = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+   vk_t *vk                             = font->vk;
+   bool resized                         =
+         font->atlas->width  != font->texture.width
+      || font->atlas->height != font->texture.height;
+
+   if (!font_atlas_take_dirty(font->atlas, &y, &height) && !resized)
+      return;
+
+   if (resized)
+   {
+      if (!vulkan_raster_font_create_textures(font))
+         return;
+
+      y      = 0;
+      height = font->atlas->height;
+   }
+
+   for (i = y; i < y + height; i++)
+      memcpy((uint8_t*)font->texture_staging.mapped
+            + i * font->texture_staging.stride,
+            font->atlas->buffer + i * font->atlas->width,
+            font->atlas->width);
+
+   vulkan_sync_texture_to_gpu(vk, &font->texture_staging);
+
+   cmd_info.commandPool        = vk->staging_pool;
+   cmd_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+   cmd_info.commandBufferCount = 1;
+   vkAllocateCommandBuffers(vk->context->device, &cmd_info, &staging);
+
+   begin_info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+   vkBeginCommandBuffer(staging, &begin_info);
+
+   vulkan_image_layout_transition(vk, staging, font->texture_staging.image,
+         font->texture_staging.layout, VK_IMAGE_LAYOUT_GENERAL,
+         VK_ACCESS_HOST_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+         VK_PIPELINE_STAGE_HOST_BIT,
+         VK_PIPELINE_STAGE_TRANSFER_BIT);
+   font->texture_staging.layout = VK_IMAGE_LAYOUT_GENERAL;
+
+   /* A new texture is copied to completely, so its contents can go. */
+   vulkan_image_layout_transition(vk, staging, font->texture.image,
+         resized ? VK_IMAGE_LAYOUT_UNDEFINED
+                 : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+         resized ? 0 : VK_ACCESS_SHADER_READ_BIT,
+         VK_ACCESS_TRANSFER_WRITE_BIT,
+         resized ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                 : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+         VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+   memset(&region, 0, sizeof(region));
+   region.srcOffset.y               = y;
+   region.dstOffset.y               = y;
+   region.extent.width              = font->atlas->width;
+   region.extent.height             = height;
+   region.extent.depth              = 1;
+   region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+   region.srcSubresource.layerCount = 1;
+   region.dstSubresource            = region.srcSubresource;
+
+   vkCmdCopyImage(staging,
+         font->texture_staging.image, VK_IMAGE_LAYOUT_GENERAL,
+         font->texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+         1, &region);
+
+   vulkan_image_layout_transition(vk, staging, font->texture.image,
+         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+         VK_ACCESS_TRANSFER_WRITE_BIT,
+         VK_ACCESS_SHADER_READ_BIT,
+         VK_PIPELINE_STAGE_TRANSFER_BIT,
+         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+   font->texture.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+   vkEndCommandBuffer(staging);
+   submit_info.commandBufferCount = 1;
+   submit_info.pCommandBuffers    = &staging;
+
+#ifdef HAVE_THREADS
+   slock_lock(vk->context->queue_lock);
+#endif
+   vkQueueSubmit(vk->context->queue,
+         1, &submit_info, VK_NULL_HANDLE);
+
+   /* Crude, but the atlas only changes while new glyphs show up. */
+   vkQueueWaitIdle(vk->context->queue);
+#ifdef HAVE_THREADS
+   slock_unlock(vk->context->queue_lock);
+#endif
+
+   vkFreeCommandBuffers(vk->context->device, vk->staging_pool, 1, &staging);
+}
+
+/* The atlas may grow while glyphs are looked up. Vertices written
+ * since the last flush refer to the old size, so scale them. */
+static bool vulkan_raster_font_check_atlas_size(vulkan_raster_t *font)
+{
+   unsigned i;
+   float scale_x, scale_y;
+
+   if (     font->atlas->width  == font->texture.width
+         && font->atlas->height == font->texture.height)
+      return false;
+
+   scale_x = (float)font->texture.width  / font->atlas->width;
+   scale_y = (float)font->texture.height / font->atlas->height;
+
+   for (i = 0; i < font->vertices; i++)
+   {
+      font->pv[i].tex_x *= scale_x;
+      font->pv[i].tex_y *= scale_y;
+   }
+
+   vulkan_raster_font_update_atlas(font);
+   return true;
+}
+
 static void *vulkan_raster_font_init_font(void *data,
       const char *font_path, float font_size)
 {
-   const struct font_atlas *atlas = NULL;
    vulkan_raster_t *font = (vulkan_raster_t*)calloc(1, sizeof(*font));
 
 #if 0
@@ -65,16 +233,21 @@ static void *vulkan_raster_font_init_font(void *data,
       return NULL;
    }
 
-   atlas = font->font_driver->get_atlas(font->font_data);
-   font->texture = vulkan_create_texture(font->vk, NULL,
-         atlas->width, atlas->height, VK_FORMAT_R8_UNORM, atlas->buffer,
-         NULL /*&swizzle*/, VULKAN_TEXTURE_STATIC);
+   font->atlas = font->font_driver->get_atlas(font->font_data);
+   vulkan_raster_font_update_atlas(font);
+
+   if (!font->texture_staging.mapped)
+   {
+      vulkan_raster_font_free_font(font);
+      return NULL;
+   }
 
    return font;
 }
 
 static void vulkan_raster_font_free_font(void *data)
 {
+   unsigned i;
    vulkan_raster_t *font = (vulkan_raster_t*)data;
    if (!font)
       return;
@@ -83,8 +256,18 @@ static void vulkan_raster_font_free_font(void *data)
       font->font_driver->free(font->font_data);
 
    vkQueueWaitIdle(font->vk->context->queue);
-   vulkan_destroy_texture( 
-         font->vk->context->device, &font->texture);
+
+   if (font->texture.memory != VK_NULL_HANDLE)
+      vulkan_destroy_texture(
+            font->vk->context->device, &font->texture);
+   if (font->texture_staging.memory != VK_NULL_HANDLE)
+      vulkan_destroy_texture(
+            font->vk->context->device, &font->texture_staging);
+
+   for (i = 0; i < font->num_retired; i++)
+      vulkan_destroy_texture(
+            font->vk->context->device, &font->retired[i]);
+   free(font->retired);
 
    free(font);
 }
@@ -165,6 +348,12 @@ static void vulkan_raster_font_render_line(
       if (!glyph)
          continue;
 
+      if (vulkan_raster_font_check_atlas_size(font))
+      {
+         inv_tex_size_x = 1.0f / font->texture.width;
+         inv_tex_size_y = 1.0f / font->texture.height;
+      }
+
       off_x  = glyph->draw_offset_x;
       off_y  = glyph->draw_offset_y;
       tex_x  = glyph->atlas_offset_x;
@@ -344,6 +533,7 @@ static void vulkan_raster_font_render_msg(void *data, const char *msg,
 
    vulkan_raster_font_render_message(font, msg, scale,
          color, x, y, text_align);
+   vulkan_raster_font_update_atlas(font);
    vulkan_raster_font_flush(font);
 }
 
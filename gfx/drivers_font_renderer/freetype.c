@@ -27,26 +27,67 @@
 #include FT_FREETYPE_H
 #include "../font_driver.h"
 
-#define FT_ATLAS_ROWS 16
-#define FT_ATLAS_COLS 16
-#define FT_ATLAS_SIZE (FT_ATLAS_ROWS * FT_ATLAS_COLS)
+/* The atlas starts out with room for about FT_ATLAS_ROWS x FT_ATLAS_COLS
+ * glyphs, and doubles in height up to FT_ATLAS_MAX_GROWTH times that
+ * before glyphs get evicted. */
+#define FT_ATLAS_ROWS       16
+#define FT_ATLAS_COLS       16
+#define FT_ATLAS_MAX_GROWTH 4
+
+/* Empty space kept right of and below each glyph,
+ * so that filtering doesn't bleed into neighbours. */
+#define FT_ATLAS_PADDING    1
+
+#define FT_MAP_MIN_SIZE     256
 
 typedef struct freetype_atlas_slot
 {
    struct font_glyph glyph;
    unsigned charcode;
-   unsigned last_used;
-   struct freetype_atlas_slot* next;
-}freetype_atlas_slot_t;
+
+   /* Space reserved in the atlas, at least as large as the glyph. */
+   unsigned slot_width;
+   unsigned slot_height;
+
+   /* Next slot in the same bucket, or in the free list. */
+   struct freetype_atlas_slot *next;
+
+   /* Neighbours in the LRU list, most recently used first. */
+   struct freetype_atlas_slot *lru_prev;
+   struct freetype_atlas_slot *lru_next;
+} freetype_atlas_slot_t;
+
+/* Glyphs are packed left to right into shelves spanning the
+ * whole width of the atlas. */
+typedef struct freetype_atlas_shelf
+{
+   unsigned y;
+   unsigned height;
+   unsigned used_width;
+} freetype_atlas_shelf_t;
 
 typedef struct freetype_renderer
 {
    FT_Library lib;
    FT_Face face;
    struct font_atlas atlas;
-   freetype_atlas_slot_t atlas_slots[FT_ATLAS_SIZE];
-   freetype_atlas_slot_t* uc_map[0x100];
-   unsigned usage_counter;
+   unsigned max_height;
+
+   /* Power of two number of buckets, indexed by hashed charcode. */
+   freetype_atlas_slot_t **map;
+   unsigned map_size;
+   unsigned num_slots;
+
+   freetype_atlas_slot_t *lru_head;
+   freetype_atlas_slot_t *lru_tail;
+
+   /* Evicted slots whose space hasn't been reused yet. */
+   freetype_atlas_slot_t *free_slots;
+
+   freetype_atlas_shelf_t *shelves;
+   unsigned num_shelves;
+   unsigned cap_shelves;
+   unsigned shelves_height;
 } ft_font_renderer_t;
 
 static struct font_atlas *font_renderer_ft_get_atlas(void *data)
@@ -57,12 +98,27 @@ static struct font_atlas *font_renderer_ft_get_atlas(void *data)
    return &handle->atlas;
 }
 
+static void font_renderer_ft_free_slots(freetype_atlas_slot_t *slot,
+      bool lru)
+{
+   while (slot)
+   {
+      freetype_atlas_slot_t *next = lru ? slot->lru_next : slot->next;
+      free(slot);
+      slot = next;
+   }
+}
+
 static void font_renderer_ft_free(void *data)
 {
    ft_font_renderer_t *handle = (ft_font_renderer_t*)data;
    if (!handle)
       return;
 
+   font_renderer_ft_free_slots(handle->lru_head, true);
+   font_renderer_ft_free_slots(handle->free_slots, false);
+   free(handle->map);
+   free(handle->shelves);
    free(handle->atlas.buffer);
 
    if (handle->face)
@@ -72,35 +128,259 @@ static void font_renderer_ft_free(void *data)
    free(handle);
 }
 
-static freetype_atlas_slot_t* font_renderer_get_slot(ft_font_renderer_t *handle)
+static INLINE unsigned font_renderer_ft_hash(ft_font_renderer_t *handle,
+      uint32_t charcode)
+{
+   uint32_t hash = charcode * 0x9e3779b1u;
+   return (hash ^ (hash >> 16)) & (handle->map_size - 1);
+}
+
+static bool font_renderer_ft_grow_map(ft_font_renderer_t *handle)
+{
+   unsigned i;
+   unsigned old_size                 = handle->map_size;
+   freetype_atlas_slot_t **old_map   = handle->map;
+   unsigned size                     = old_size ? old_size * 2 : FT_MAP_MIN_SIZE;
+   freetype_atlas_slot_t **map       = (freetype_atlas_slot_t**)
+      calloc(size, sizeof(*map));
+
+   if (!map)
+      return false;
+
+   handle->map      = map;
+   handle->map_size = size;
+
+   for (i = 0; i < old_size; i++)
+   {
+      freetype_atlas_slot_t *slot = old_map[i];
+
+      while (slot)
+      {
+         freetype_atlas_slot_t *next = slot->next;
+         unsigned bucket             = font_renderer_ft_hash(handle, slot->charcode);
+
+         slot->next                  = map[bucket];
+         map[bucket]                 = slot;
+         slot                        = next;
+      }
+   }
+
+   free(old_map);
+   return true;
+}
+
+static void font_renderer_ft_map_remove(ft_font_renderer_t *handle,
+      freetype_atlas_slot_t *slot)
 {
-   int i, map_id;
-   unsigned oldest = 0;
-
-   for (i = 1; i < FT_ATLAS_SIZE; i++)
-      if((handle->usage_counter - handle->atlas_slots[i].last_used) >
-         (handle->usage_counter - handle->atlas_slots[oldest].last_used))
-         oldest = i;
-
-   /* remove from map */
-   map_id = handle->atlas_slots[oldest].charcode & 0xFF;
-   if(handle->uc_map[map_id] == &handle->atlas_slots[oldest])
-      handle->uc_map[map_id] = handle->atlas_slots[oldest].next;
-   else if (handle->uc_map[map_id])
+   freetype_atlas_slot_t **link = &handle->map[
+      font_renderer_ft_hash(handle, slot->charcode)];
+
+   while (*link && *link != slot)
+      link = &(*link)->next;
+   if (*link)
+      *link = slot->next;
+
+   slot->next = NULL;
+   handle->num_slots--;
+}
+
+static void font_renderer_ft_lru_unlink(ft_font_renderer_t *handle,
+      freetype_atlas_slot_t *slot)
+{
+   if (slot->lru_prev)
+      slot->lru_prev->lru_next = slot->lru_next;
+   else
+      handle->lru_head         = slot->lru_next;
+
+   if (slot->lru_next)
+      slot->lru_next->lru_prev = slot->lru_prev;
+   else
+      handle->lru_tail         = slot->lru_prev;
+
+   slot->lru_prev = NULL;
+   slot->lru_next = NULL;
+}
+
+static void font_renderer_ft_lru_push(ft_font_renderer_t *handle,
+      freetype_atlas_slot_t *slot)
+{
+   slot->lru_prev   = NULL;
+   slot->lru_next   = handle->lru_head;
+
+   if (handle->lru_head)
+      handle->lru_head->lru_prev = slot;
+   else
+      handle->lru_tail           = slot;
+
+   handle->lru_head = slot;
+}
+
+/* Takes the first evicted slot which is large enough. */
+static freetype_atlas_slot_t *font_renderer_ft_reuse_slot(
+      ft_font_renderer_t *handle, unsigned width, unsigned height)
+{
+   freetype_atlas_slot_t **link = &handle->free_slots;
+
+   while (*link)
    {
-      freetype_atlas_slot_t* ptr = handle->uc_map[map_id];
-      while(ptr->next && ptr->next != &handle->atlas_slots[oldest])
-         ptr = ptr->next;
-      ptr->next = handle->atlas_slots[oldest].next;
+      freetype_atlas_slot_t *slot = *link;
+
+      if (slot->slot_width >= width && slot->slot_height >= height)
+      {
+         *link      = slot->next;
+         slot->next = NULL;
+         return slot;
+      }
+
+      link = &slot->next;
    }
 
-   return &handle->atlas_slots[oldest];
+   return NULL;
+}
+
+static bool font_renderer_ft_grow_atlas(ft_font_renderer_t *handle)
+{
+   uint8_t *buffer = NULL;
+   unsigned height = MIN(handle->atlas.height * 2, handle->max_height);
+
+   if (height <= handle->atlas.height)
+      return false;
+
+   buffer = (uint8_t*)realloc(handle->atlas.buffer,
+         handle->atlas.width * height);
+   if (!buffer)
+      return false;
+
+   memset(buffer + handle->atlas.width * handle->atlas.height, 0,
+         handle->atlas.width * (height - handle->atlas.height));
+
+   handle->atlas.buffer = buffer;
+   handle->atlas.height = height;
+
+   /* Drivers upload everything when the size changes. */
+   handle->atlas.dirty  = true;
+   return true;
+}
+
+static freetype_atlas_shelf_t *font_renderer_ft_new_shelf(
+      ft_font_renderer_t *handle, unsigned height, bool grow)
+{
+   freetype_atlas_shelf_t *shelf = NULL;
+
+   /* Rounding up makes space freed by one glyph
+    * more likely to fit another. */
+   height = (height + 3) & ~3u;
+
+   while (handle->shelves_height + height > handle->atlas.height)
+      if (!grow || !font_renderer_ft_grow_atlas(handle))
+         return NULL;
+
+   if (handle->num_shelves == handle->cap_shelves)
+   {
+      unsigned cap = handle->cap_shelves ? handle->cap_shelves * 2 : 16;
+      freetype_atlas_shelf_t *shelves = (freetype_atlas_shelf_t*)
+         realloc(handle->shelves, cap * sizeof(*shelves));
+
+      if (!shelves)
+         return NULL;
+
+      handle->shelves     = shelves;
+      handle->cap_shelves = cap;
+   }
+
+   shelf                   = &handle->shelves[handle->num_shelves++];
+   shelf->y                = handle->shelves_height;
+   shelf->height           = height;
+   shelf->used_width       = 0;
+   handle->shelves_height += height;
+   return shelf;
+}
+
+static freetype_atlas_slot_t *font_renderer_ft_pack_slot(
+      ft_font_renderer_t *handle, unsigned width, unsigned height)
+{
+   unsigned i;
+   freetype_atlas_slot_t *slot   = NULL;
+   freetype_atlas_shelf_t *shelf = NULL;
+
+   if (width > handle->atlas.width)
+      return NULL;
+
+   /* Lowest shelf the glyph fits in. */
+   for (i = 0; i < handle->num_shelves; i++)
+   {
+      freetype_atlas_shelf_t *cur = &handle->shelves[i];
+
+      if (     cur->height >= height
+            && cur->used_width + width <= handle->atlas.width
+            && (!shelf || cur->height < shelf->height))
+         shelf = cur;
+   }
+
+   /* Don't waste a tall shelf on a short glyph while there is room,
+    * but don't grow the atlas for that either. */
+   if (!shelf || shelf->height >= height * 2)
+   {
+      freetype_atlas_shelf_t *fresh = font_renderer_ft_new_shelf(
+            handle, height, !shelf);
+      if (fresh)
+         shelf = fresh;
+   }
+
+   if (!shelf)
+      return NULL;
+
+   slot = (freetype_atlas_slot_t*)calloc(1, sizeof(*slot));
+   if (!slot)
+      return NULL;
+
+   slot->glyph.atlas_offset_x = shelf->used_width;
+   slot->glyph.atlas_offset_y = shelf->y;
+   slot->slot_width           = width;
+   slot->slot_height          = shelf->height;
+   shelf->used_width         += width;
+   return slot;
+}
+
+static freetype_atlas_slot_t *font_renderer_ft_get_slot(
+      ft_font_renderer_t *handle, unsigned width, unsigned height)
+{
+   freetype_atlas_slot_t *slot = NULL;
+
+   width  += FT_ATLAS_PADDING;
+   height += FT_ATLAS_PADDING;
+
+   if (handle->free_slots)
+      slot = font_renderer_ft_reuse_slot(handle, width, height);
+
+   if (!slot)
+      slot = font_renderer_ft_pack_slot(handle, width, height);
+
+   /* The atlas is full, evict least recently used glyphs until
+    * one of them leaves enough space behind. */
+   while (!slot && handle->lru_tail)
+   {
+      freetype_atlas_slot_t *victim = handle->lru_tail;
+
+      font_renderer_ft_lru_unlink(handle, victim);
+      font_renderer_ft_map_remove(handle, victim);
+
+      if (victim->slot_width >= width && victim->slot_height >= height)
+         slot = victim;
+      else
+      {
+         victim->next       = handle->free_slots;
+         handle->free_slots = victim;
+      }
+   }
+
+   return slot;
 }
 
 static const struct font_glyph *font_renderer_ft_get_glyph(
       void *data, uint32_t charcode)
 {
-   unsigned map_id;
+   unsigned r, bucket;
    uint8_t *dst;
    FT_GlyphSlot slot;
    freetype_atlas_slot_t* atlas_slot;
@@ -109,14 +389,18 @@ static const struct font_glyph *font_renderer_ft_get_glyph(
    if (!handle)
       return NULL;
 
-   map_id     = charcode & 0xFF;
-   atlas_slot = handle->uc_map[map_id];
+   bucket     = font_renderer_ft_hash(handle, charcode);
+   atlas_slot = handle->map[bucket];
 
-   while(atlas_slot)
+   while (atlas_slot)
    {
-      if(atlas_slot->charcode == charcode)
+      if (atlas_slot->charcode == charcode)
       {
-         atlas_slot->last_used = handle->usage_counter++;
+         if (atlas_slot != handle->lru_head)
+         {
+            font_renderer_ft_lru_unlink(handle, atlas_slot);
+            font_renderer_ft_lru_push(handle, atlas_slot);
+         }
          return &atlas_slot->glyph;
       }
       atlas_slot = atlas_slot->next;
@@ -128,10 +412,20 @@ static const struct font_glyph *font_renderer_ft_get_glyph(
    FT_Render_Glyph(handle->face->glyph, FT_RENDER_MODE_NORMAL);
    slot = handle->face->glyph;
 
-   atlas_slot             = font_renderer_get_slot(handle);
-   atlas_slot->charcode   = charcode;
-   atlas_slot->next       = handle->uc_map[map_id];
-   handle->uc_map[map_id] = atlas_slot;
+   atlas_slot = font_renderer_ft_get_slot(handle,
+         slot->bitmap.width, slot->bitmap.rows);
+   if (!atlas_slot)
+      return NULL;
+
+   if (handle->num_slots >= handle->map_size)
+      font_renderer_ft_grow_map(handle);
+
+   bucket                = font_renderer_ft_hash(handle, charcode);
+   atlas_slot->charcode  = charcode;
+   atlas_slot->next      = handle->map[bucket];
+   handle->map[bucket]   = atlas_slot;
+   handle->num_slots++;
+   font_renderer_ft_lru_push(handle, atlas_slot);
 
    /* Some glyphs can be blank. */
    atlas_slot->glyph.width         = slot->bitmap.width;
@@ -144,26 +438,27 @@ static const struct font_glyph *font_renderer_ft_get_glyph(
    dst = (uint8_t*)handle->atlas.buffer + atlas_slot->glyph.atlas_offset_x
          + atlas_slot->glyph.atlas_offset_y * handle->atlas.width;
 
+   /* Clear the whole slot, it may hold an evicted glyph. */
+   for (r = 0; r < atlas_slot->slot_height; r++)
+      memset(dst + r * handle->atlas.width, 0, atlas_slot->slot_width);
+
    if (slot->bitmap.buffer)
    {
-      unsigned r, c;
       const uint8_t *src = (const uint8_t*)slot->bitmap.buffer;
 
       for (r = 0; r < atlas_slot->glyph.height;
             r++, dst += handle->atlas.width, src += slot->bitmap.pitch)
-         for (c = 0; c < atlas_slot->glyph.width; c++)
-            dst[c] = src[c];
+         memcpy(dst, src, atlas_slot->glyph.width);
    }
 
-   handle->atlas.dirty = true;
-   atlas_slot->last_used = handle->usage_counter++;
+   font_atlas_mark_dirty(&handle->atlas,
+         atlas_slot->glyph.atlas_offset_y, atlas_slot->slot_height);
    return &atlas_slot->glyph;
 }
 
 static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_size)
 {
-   unsigned i, x, y;
-   freetype_atlas_slot_t* slot = NULL;
+   unsigned i;
 
    /* TODO: find a better way to determine max_width/max_height */
    unsigned max_width          = font_size;
@@ -171,6 +466,7 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
 
    handle->atlas.width         = max_width  * FT_ATLAS_COLS;
    handle->atlas.height        = max_height * FT_ATLAS_ROWS;
+   handle->max_height          = handle->atlas.height * FT_ATLAS_MAX_GROWTH;
 
    handle->atlas.buffer        = (uint8_t*)
       calloc(handle->atlas.width * handle->atlas.height, 1);
@@ -178,17 +474,8 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
    if (!handle->atlas.buffer)
       return false;
 
-   slot = handle->atlas_slots;
-
-   for (y = 0; y < FT_ATLAS_ROWS; y++)
-   {
-      for (x = 0; x < FT_ATLAS_COLS; x++)
-      {
-         slot->glyph.atlas_offset_x = x * max_width;
-         slot->glyph.atlas_offset_y = y * max_height;
-         slot++;
-      }
-   }
+   if (!font_renderer_ft_grow_map(handle))
+      return false;
 
    for (i = 0; i < 256; i++)
       font_renderer_ft_get_glyph(handle, i);
@@ -24,9 +24,15 @@
 #include <streams/file_stream.h>
 #include <lists/string_list.h>
 #include <string/stdstring.h>
+#include <features/features_cpu.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
 
 #include "glslang_util.hpp"
 #include "glslang.hpp"
+#include "slang_cache.hpp"
 
 #include "../../verbosity.h"
 
@@ -357,6 +363,25 @@ static bool glslang_parse_meta(const vector<string> &lines, glslang_meta *meta)
    return true;
 }
 
+/* The stage source already has every #include expanded, so
+ * together with the stage and the compiler it is all that
+ * decides what SPIR-V comes out. */
+static bool glslang_compile_stage(const string &source,
+      glslang::Stage stage, const char *name, vector<uint32_t> *spirv)
+{
+   string key = slang_cache_key(string("spirv\n")
+         + glslang::compiler_version() + "\n" + name + "\n" + source);
+
+   if (slang_cache_load(key, "spv", spirv))
+      return true;
+
+   if (!glslang::compile_spirv(source, stage, spirv))
+      return false;
+
+   slang_cache_store(key, "spv", *spirv);
+   return true;
+}
+
 bool glslang_compile_shader(const char *shader_path, glslang_output *output)
 {
    vector<string> lines;
@@ -368,15 +393,15 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
    if (!glslang_parse_meta(lines, &output->meta))
       return false;
 
-   if (!glslang::compile_spirv(build_stage_source(lines, "vertex"),
-            glslang::StageVertex, &output->vertex))
+   if (!glslang_compile_stage(build_stage_source(lines, "vertex"),
+            glslang::StageVertex, "vertex", &output->vertex))
    {
       RARCH_ERR("Failed to compile vertex shader stage.\n");
       return false;
    }
 
-   if (!glslang::compile_spirv(build_stage_source(lines, "fragment"),
-            glslang::StageFragment, &output->fragment))
+   if (!glslang_compile_stage(build_stage_source(lines, "fragment"),
+            glslang::StageFragment, "fragment", &output->fragment))
    {
       RARCH_ERR("Failed to compile fragment shader stage.\n");
       return false;
@@ -385,3 +410,94 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
    return true;
 }
 
+struct glslang_compile_job
+{
+   const char * const *paths;
+   glslang_output *outputs;
+   unsigned count;
+   unsigned next;
+   unsigned failed;
+#ifdef HAVE_THREADS
+   slock_t *lock;
+#endif
+};
+
+static void glslang_compile_worker(void *data)
+{
+   glslang_compile_job *job = (glslang_compile_job*)data;
+
+   for (;;)
+   {
+      unsigned i;
+
+#ifdef HAVE_THREADS
+      slock_lock(job->lock);
+#endif
+      /* Passes are taken in order, so every pass before a failed
+       * one has been compiled by the time all workers are done. */
+      i = job->failed < job->count ? job->count : job->next++;
+#ifdef HAVE_THREADS
+      slock_unlock(job->lock);
+#endif
+
+      if (i >= job->count)
+         return;
+
+      if (!glslang_compile_shader(job->paths[i], &job->outputs[i]))
+      {
+#ifdef HAVE_THREADS
+         slock_lock(job->lock);
+#endif
+         job->failed = min(job->failed, i);
+#ifdef HAVE_THREADS
+         slock_unlock(job->lock);
+#endif
+      }
+   }
+}
+
+bool glslang_compile_shaders(const char * const *shader_paths,
+      glslang_output *outputs, unsigned count, unsigned *failed)
+{
+   glslang_compile_job job;
+
+   job.paths   = shader_paths;
+   job.outputs = outputs;
+   job.count   = count;
+   job.next    = 0;
+   job.failed  = count;
+
+#ifdef HAVE_THREADS
+   vector<sthread_t*> threads;
+   unsigned workers = min(count, cpu_features_get_core_amount());
+
+   job.lock = slock_new();
+   if (!job.lock)
+   {
+      if (failed)
+         *failed = 0;
+      return false;
+   }
+
+   /* The calling thread is one of the workers. */
+   for (unsigned i = 1; i < workers; i++)
+   {
+      sthread_t *thread = sthread_create(glslang_compile_worker, &job);
+      if (!thread)
+         break;
+      threads.push_back(thread);
+   }
+#endif
+
+   glslang_compile_worker(&job);
+
+#ifdef HAVE_THREADS
+   for (auto thread : threads)
+      sthread_join(thread);
+   slock_free(job.lock);
+#endif
+
+   if (failed)
+      *failed = job.failed;
+   return job.failed == count;
+}
@@ -88,6 +88,12 @@ struct glslang_output
 };
 
 bool glslang_compile_shader(const char *shader_path, glslang_output *output);
+
+// Compiles several shaders at once, spread over as many threads as
+// there are cores. On failure, *failed is the first shader which
+// did not compile.
+bool glslang_compile_shaders(const char * const *shader_paths,
+      glslang_output *outputs, unsigned count, unsigned *failed);
 const char *glslang_format_to_string(enum glslang_format fmt);
 
 #endif
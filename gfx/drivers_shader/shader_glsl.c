@@ -248,11 +248,14 @@ static void gl_glsl_print_linker_log(GLuint obj)
    free(info_log);
 }
 
-static bool gl_glsl_compile_shader(glsl_shader_data_t *glsl,
+/* Compiling is split in two steps. Only the second one asks the
+ * driver how things went, which is what makes it wait for the
+ * result. Drivers which compile on threads of their own can then
+ * work on all passes of a preset at once. */
+static void gl_glsl_begin_shader(glsl_shader_data_t *glsl,
       GLuint shader,
       const char *define, const char *program)
 {
-   GLint status;
    const char *source[4];
    char version[32];
 
@@ -290,6 +293,11 @@ static bool gl_glsl_compile_shader(glsl_shader_data_t *glsl,
 
    glShaderSource(shader, ARRAY_SIZE(source), source, NULL);
    glCompileShader(shader);
+}
+
+static bool gl_glsl_finish_shader(GLuint shader)
+{
+   GLint status;
 
    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
    gl_glsl_print_shader_log(shader);
@@ -297,12 +305,10 @@ static bool gl_glsl_compile_shader(glsl_shader_data_t *glsl,
    return status == GL_TRUE;
 }
 
-static bool gl_glsl_link_program(GLuint prog)
+static bool gl_glsl_finish_link(GLuint prog)
 {
    GLint status;
 
-   glLinkProgram(prog);
-
    glGetProgramiv(prog, GL_LINK_STATUS, &status);
    gl_glsl_print_linker_log(prog);
 
@@ -313,58 +319,85 @@ static bool gl_glsl_link_program(GLuint prog)
    return true;
 }
 
-
-static bool gl_glsl_compile_program(
-      void *data,
-      unsigned idx,
-      void *program_data,
+static void gl_glsl_begin_program(
+      glsl_shader_data_t *glsl,
+      struct shader_program_glsl_data *program,
       struct shader_program_info *program_info)
 {
-   glsl_shader_data_t *glsl = (glsl_shader_data_t*)data;
-   struct shader_program_glsl_data *program = (struct shader_program_glsl_data*)program_data;
-   GLuint prog = glCreateProgram();
+   program->vprg = 0;
+   program->fprg = 0;
+   program->id   = glCreateProgram();
 
-   if (!program)
-      program = &glsl->prg[idx];
-
-   if (!prog)
-      goto error;
+   if (!program->id)
+      return;
 
    if (program_info->vertex)
    {
       RARCH_LOG("Found GLSL vertex shader.\n");
       program->vprg = glCreateShader(GL_VERTEX_SHADER);
-
-      if (!gl_glsl_compile_shader(
-               glsl,
-               program->vprg,
-               "#define VERTEX\n#define PARAMETER_UNIFORM\n", program_info->vertex))
-      {
-         RARCH_ERR("Failed to compile vertex shader #%u\n", idx);
-         goto error;
-      }
-
-      glAttachShader(prog, program->vprg);
+      gl_glsl_begin_shader(glsl, program->vprg,
+            "#define VERTEX\n#define PARAMETER_UNIFORM\n", program_info->vertex);
+      glAttachShader(program->id, program->vprg);
    }
 
    if (program_info->fragment)
    {
       RARCH_LOG("Found GLSL fragment shader.\n");
       program->fprg = glCreateShader(GL_FRAGMENT_SHADER);
-      if (!gl_glsl_compile_shader(glsl, program->fprg,
-               "#define FRAGMENT\n#define PARAMETER_UNIFORM\n", program_info->fragment))
-      {
-         RARCH_ERR("Failed to compile fragment shader #%u\n", idx);
-         goto error;
-      }
-
-      glAttachShader(prog, program->fprg);
+      gl_glsl_begin_shader(glsl, program->fprg,
+            "#define FRAGMENT\n#define PARAMETER_UNIFORM\n", program_info->fragment);
+      glAttachShader(program->id, program->fprg);
    }
 
+   /* Linking shaders which failed to compile fails as well,
+    * gl_glsl_finish_program() reports the compile error first. */
    if (program_info->vertex || program_info->fragment)
    {
       RARCH_LOG("Linking GLSL program.\n");
-      if (!gl_glsl_link_program(prog))
+      glLinkProgram(program->id);
+   }
+}
+
+static void gl_glsl_discard_program(struct shader_program_glsl_data *program)
+{
+   if (program->vprg)
+      glDeleteShader(program->vprg);
+   if (program->fprg)
+      glDeleteShader(program->fprg);
+   if (program->id)
+      glDeleteProgram(program->id);
+
+   program->vprg = 0;
+   program->fprg = 0;
+   program->id   = 0;
+}
+
+static bool gl_glsl_finish_program(
+      glsl_shader_data_t *glsl,
+      unsigned idx,
+      struct shader_program_glsl_data *program,
+      struct shader_program_info *program_info)
+{
+   GLuint prog = program->id;
+
+   if (!prog)
+      goto error;
+
+   if (program->vprg && !gl_glsl_finish_shader(program->vprg))
+   {
+      RARCH_ERR("Failed to compile vertex shader #%u\n", idx);
+      goto error;
+   }
+
+   if (program->fprg && !gl_glsl_finish_shader(program->fprg))
+   {
+      RARCH_ERR("Failed to compile fragment shader #%u\n", idx);
+      goto error;
+   }
+
+   if (program_info->vertex || program_info->fragment)
+   {
+      if (!gl_glsl_finish_link(prog))
          goto error;
 
       /* Clean up dead memory. We're not going to relink the program.
@@ -382,16 +415,30 @@ static bool gl_glsl_compile_program(
       glUseProgram(0);
    }
 
-   program->id = prog;
-
    return true;
 
 error:
    RARCH_ERR("Failed to link program #%u.\n", idx);
-   program->id = 0;
+   gl_glsl_discard_program(program);
    return false;
 }
 
+static bool gl_glsl_compile_program(
+      void *data,
+      unsigned idx,
+      void *program_data,
+      struct shader_program_info *program_info)
+{
+   glsl_shader_data_t *glsl = (glsl_shader_data_t*)data;
+   struct shader_program_glsl_data *program = (struct shader_program_glsl_data*)program_data;
+
+   if (!program)
+      program = &glsl->prg[idx];
+
+   gl_glsl_begin_program(glsl, program, program_info);
+   return gl_glsl_finish_program(glsl, idx, program, program_info);
+}
+
 static void gl_glsl_strip_parameter_pragmas(char *source)
 {
    /* #pragma parameter lines tend to have " characters in them,
@@ -432,18 +479,14 @@ static bool gl_glsl_compile_programs(
       glsl_shader_data_t *glsl, struct shader_program_glsl_data *program)
 {
    unsigned i;
+   struct shader_program_info shader_prog_info[GFX_MAX_SHADERS];
 
+   /* Hand every pass to the driver before waiting for any of them. */
    for (i = 0; i < glsl->shader->passes; i++)
    {
-      struct shader_program_info shader_prog_info;
-      const char *vertex           = NULL;
-      const char *fragment         = NULL;
       struct video_shader_pass *pass = (struct video_shader_pass*)
          &glsl->shader->pass[i];
 
-      if (!pass)
-         continue;
-
       /* If we load from GLSLP (CGP),
        * load the file here, and pretend
        * we were really using XML all along.
@@ -457,18 +500,24 @@ static bool gl_glsl_compile_programs(
       }
       *pass->source.path = '\0';
 
-      vertex   = pass->source.string.vertex;
-      fragment = pass->source.string.fragment;
+      shader_prog_info[i].vertex   = pass->source.string.vertex;
+      shader_prog_info[i].fragment = pass->source.string.fragment;
+      shader_prog_info[i].is_file  = false;
+   }
 
-      shader_prog_info.vertex   = vertex;
-      shader_prog_info.fragment = fragment;
-      shader_prog_info.is_file  = false;
+   for (i = 0; i < glsl->shader->passes; i++)
+      gl_glsl_begin_program(glsl, &program[i], &shader_prog_info[i]);
 
-      if (!gl_glsl_compile_program(glsl, i,
+   for (i = 0; i < glsl->shader->passes; i++)
+   {
+      if (!gl_glsl_finish_program(glsl, i,
             &program[i],
-            &shader_prog_info))
+            &shader_prog_info[i]))
       {
          RARCH_ERR("Failed to create GL program #%u.\n", i);
+
+         while (++i < glsl->shader->passes)
+            gl_glsl_discard_program(&program[i]);
          return false;
       }
    }
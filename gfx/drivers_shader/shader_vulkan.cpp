@@ -25,8 +25,10 @@
 
 #include <compat/strl.h>
 #include <formats/image.h>
+#include <features/features_cpu.h>
 
 #include "slang_reflection.hpp"
+#include "slang_cache.hpp"
 
 #include "../video_shader_driver.h"
 #include "../../verbosity.h"
@@ -2846,6 +2848,11 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       const struct vulkan_filter_chain_create_info *info,
       const char *path, vulkan_filter_chain_filter filter)
 {
+   unsigned hits, misses, start_hits, start_misses;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   slang_cache_get_stats(&start_hits, &start_misses);
+
    unique_ptr<video_shader> shader{ new video_shader() };
    if (!shader)
       return nullptr;
@@ -2872,6 +2879,23 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
 
    shader->num_parameters = 0;
 
+   // Compiling is the slow part, do all passes at once.
+   // Everything else has to happen in order.
+   vector<const char *> paths;
+   vector<glslang_output> outputs(shader->passes);
+   unsigned failed_pass;
+
+   for (unsigned i = 0; i < shader->passes; i++)
+      paths.push_back(shader->pass[i].source.path);
+
+   if (!glslang_compile_shaders(paths.data(), outputs.data(),
+            shader->passes, &failed_pass))
+   {
+      RARCH_ERR("Failed to compile shader: \"%s\".\n",
+            shader->pass[failed_pass].source.path);
+      return nullptr;
+   }
+
    for (unsigned i = 0; i < shader->passes; i++)
    {
       const video_shader_pass *pass = &shader->pass[i];
@@ -2880,13 +2904,7 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       struct vulkan_filter_chain_pass_info pass_info;
       memset(&pass_info, 0, sizeof(pass_info));
 
-      glslang_output output;
-      if (!glslang_compile_shader(pass->source.path, &output))
-      {
-         RARCH_ERR("Failed to compile shader: \"%s\".\n",
-               pass->source.path);
-         return nullptr;
-      }
+      glslang_output &output = outputs[i];
 
       for (auto &meta_param : output.meta.parameters)
       {
@@ -3091,6 +3109,14 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
    if (!chain->init())
       return nullptr;
 
+   slang_cache_get_stats(&hits, &misses);
+   hits   -= start_hits;
+   misses -= start_misses;
+
+   RARCH_LOG("[slang]: Loaded preset in %.1f ms (%s, %u of %u cache lookups hit).\n",
+         (cpu_features_get_time_usec() - start) / 1000.0,
+         misses ? "cold" : "warm", hits, hits + misses);
+
    return chain.release();
 }
 
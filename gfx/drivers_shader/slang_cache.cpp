@@ -0,0 +1,264 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <unordered_map>
+
+#include <retro_miscellaneous.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
+#include <retro_stat.h>
+#include <rhash.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+#include "slang_cache.hpp"
+
+#include "../../configuration.h"
+#include "../../verbosity.h"
+
+using namespace std;
+
+#define SLANG_CACHE_MAGIC          0x48434c53u /* "SLCH" */
+#define SLANG_CACHE_VERSION        1
+#define SLANG_CACHE_MEMORY_ENTRIES 64
+
+struct slang_cache_header
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t words;
+};
+
+struct slang_cache
+{
+   slang_cache()
+   {
+#ifdef HAVE_THREADS
+      lock = slock_new();
+#endif
+   }
+
+   ~slang_cache()
+   {
+#ifdef HAVE_THREADS
+      slock_free(lock);
+#endif
+   }
+
+   void acquire()
+   {
+#ifdef HAVE_THREADS
+      slock_lock(lock);
+#endif
+   }
+
+   void release()
+   {
+#ifdef HAVE_THREADS
+      slock_unlock(lock);
+#endif
+   }
+
+   unordered_map<string, vector<uint32_t>> entries;
+   // Oldest first, evicted in that order.
+   deque<string> order;
+   unsigned hits   = 0;
+   unsigned misses = 0;
+
+#ifdef HAVE_THREADS
+   slock_t *lock = nullptr;
+#endif
+};
+
+static slang_cache &slang_cache_get()
+{
+   static slang_cache cache;
+   return cache;
+}
+
+static bool slang_cache_path(const string &key, const char *ext,
+      char *path, size_t size)
+{
+   char dir[PATH_MAX_LENGTH];
+   char name[128];
+   settings_t *settings = config_get_ptr();
+
+   if (!settings || string_is_empty(settings->directory.cache))
+      return false;
+
+   fill_pathname_join(dir, settings->directory.cache, "slang", sizeof(dir));
+   snprintf(name, sizeof(name), "%s.%s", key.c_str(), ext);
+   fill_pathname_join(path, dir, name, size);
+   return true;
+}
+
+static void slang_cache_remember(slang_cache &cache,
+      const string &key, const vector<uint32_t> &words)
+{
+   if (cache.entries.count(key))
+      return;
+
+   while (cache.order.size() >= SLANG_CACHE_MEMORY_ENTRIES)
+   {
+      cache.entries.erase(cache.order.front());
+      cache.order.pop_front();
+   }
+
+   cache.entries[key] = words;
+   cache.order.push_back(key);
+}
+
+static bool slang_cache_read_file(const char *path,
+      vector<uint32_t> *words)
+{
+   slang_cache_header header;
+   void *buf   = NULL;
+   ssize_t len = 0;
+   bool ret    = false;
+
+   if (!path_file_exists(path) || !filestream_read_file(path, &buf, &len))
+      return false;
+
+   if (len >= (ssize_t)sizeof(header))
+   {
+      memcpy(&header, buf, sizeof(header));
+
+      if (     header.magic   == SLANG_CACHE_MAGIC
+            && header.version == SLANG_CACHE_VERSION
+            && (size_t)len    == sizeof(header) + header.words * sizeof(uint32_t))
+      {
+         const uint32_t *data = (const uint32_t*)
+            ((const uint8_t*)buf + sizeof(header));
+         words->assign(data, data + header.words);
+         ret = true;
+      }
+   }
+
+   free(buf);
+   return ret;
+}
+
+static void slang_cache_write_file(const char *path,
+      const vector<uint32_t> &words)
+{
+   char dir[PATH_MAX_LENGTH];
+   char tmp[PATH_MAX_LENGTH];
+   slang_cache_header header;
+   vector<uint8_t> buf(sizeof(header) + words.size() * sizeof(uint32_t));
+
+   header.magic   = SLANG_CACHE_MAGIC;
+   header.version = SLANG_CACHE_VERSION;
+   header.words   = (uint32_t)words.size();
+
+   memcpy(buf.data(), &header, sizeof(header));
+   if (!words.empty())
+      memcpy(buf.data() + sizeof(header), words.data(),
+            words.size() * sizeof(uint32_t));
+
+   fill_pathname_basedir(dir, path, sizeof(dir));
+   if (!path_is_directory(dir) && !path_mkdir(dir))
+      return;
+
+   /* Write under another name first, so that a reader never
+    * sees a partial entry. The name is unique per writer, as
+    * two threads may store the same entry at once. */
+   snprintf(tmp, sizeof(tmp), "%s.%lx.tmp", path,
+         (unsigned long)(uintptr_t)buf.data());
+
+   if (!filestream_write_file(tmp, buf.data(), buf.size()))
+   {
+      RARCH_WARN("[slang]: Failed to write cache entry \"%s\".\n", tmp);
+      remove(tmp);
+      return;
+   }
+
+   remove(path);
+   if (rename(tmp, path) != 0)
+      remove(tmp);
+}
+
+string slang_cache_key(const string &inputs)
+{
+   char hash[65];
+
+   sha256_hash(hash, (const uint8_t*)inputs.data(), inputs.size());
+   return hash;
+}
+
+bool slang_cache_load(const string &key, const char *ext,
+      vector<uint32_t> *words)
+{
+   char path[PATH_MAX_LENGTH];
+   slang_cache &cache = slang_cache_get();
+
+   cache.acquire();
+
+   auto itr = cache.entries.find(key);
+   if (itr != cache.entries.end())
+   {
+      *words = itr->second;
+      cache.hits++;
+      cache.release();
+      return true;
+   }
+
+   cache.release();
+
+   /* Read the file without holding the lock, other
+    * threads may be looking up other entries meanwhile. */
+   bool found = slang_cache_path(key, ext, path, sizeof(path))
+      && slang_cache_read_file(path, words);
+
+   cache.acquire();
+   if (found)
+   {
+      slang_cache_remember(cache, key, *words);
+      cache.hits++;
+   }
+   else
+      cache.misses++;
+   cache.release();
+
+   return found;
+}
+
+void slang_cache_store(const string &key, const char *ext,
+      const vector<uint32_t> &words)
+{
+   char path[PATH_MAX_LENGTH];
+   slang_cache &cache = slang_cache_get();
+
+   cache.acquire();
+   slang_cache_remember(cache, key, words);
+   cache.release();
+
+   if (slang_cache_path(key, ext, path, sizeof(path)))
+      slang_cache_write_file(path, words);
+}
+
+void slang_cache_get_stats(unsigned *hits, unsigned *misses)
+{
+   slang_cache &cache = slang_cache_get();
+
+   cache.acquire();
+   *hits   = cache.hits;
+   *misses = cache.misses;
+   cache.release();
+}
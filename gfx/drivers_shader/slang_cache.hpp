@@ -0,0 +1,42 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SLANG_CACHE_HPP
+#define SLANG_CACHE_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Content addressed cache for SPIR-V and reflection data.
+//
+// Entries are named by a hash of everything that went into making
+// them, so they never need to be invalidated. The most recent ones
+// are kept in memory, and all of them in the "slang" subdirectory
+// of the cache directory if one is set. Safe to use from several
+// threads.
+
+// Hashes the inputs of an entry into its key.
+std::string slang_cache_key(const std::string &inputs);
+
+// ext only makes the cache directory easier to browse.
+bool slang_cache_load(const std::string &key, const char *ext,
+      std::vector<uint32_t> *words);
+void slang_cache_store(const std::string &key, const char *ext,
+      const std::vector<uint32_t> &words);
+
+// Number of lookups so far which were found and which were not.
+void slang_cache_get_stats(unsigned *hits, unsigned *misses);
+
+#endif
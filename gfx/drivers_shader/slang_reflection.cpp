@@ -15,7 +15,9 @@
 
 #include "spirv_cross.hpp"
 #include "slang_reflection.hpp"
+#include "slang_cache.hpp"
 #include <vector>
+#include <algorithm>
 #include <stdio.h>
 #include "../../verbosity.h"
 
@@ -645,10 +647,222 @@ static bool slang_reflect(const Compiler &vertex_compiler, const Compiler &fragm
    return true;
 }
 
+/* Bump when slang_reflect() changes what it makes of a shader. */
+#define SLANG_REFLECTION_CACHE_VERSION 1
+
+template <typename M>
+static void slang_reflection_key_map(string &key, const char *name, const M *map)
+{
+   vector<string> entries;
+
+   if (map)
+   {
+      for (auto &entry : *map)
+      {
+         char value[64];
+         snprintf(value, sizeof(value), "=%d,%u\n",
+               int(entry.second.semantic), entry.second.index);
+         entries.push_back(entry.first + value);
+      }
+   }
+
+   /* The maps are unordered, their entries aren't. */
+   sort(begin(entries), end(entries));
+
+   key += name;
+   key += '\n';
+   for (auto &entry : entries)
+      key += entry;
+}
+
+/* Everything slang_reflect() reads goes into the key. */
+static string slang_reflection_key(const vector<uint32_t> &vertex,
+      const vector<uint32_t> &fragment, const slang_reflection *reflection)
+{
+   char header[64];
+   string key;
+
+   snprintf(header, sizeof(header), "reflection %d\npass %u\n",
+         SLANG_REFLECTION_CACHE_VERSION, reflection->pass_number);
+   key = header;
+
+   slang_reflection_key_map(key, "textures", reflection->texture_semantic_map);
+   slang_reflection_key_map(key, "texture uniforms",
+         reflection->texture_semantic_uniform_map);
+   slang_reflection_key_map(key, "uniforms", reflection->semantic_map);
+
+   snprintf(header, sizeof(header), "vertex %u\n", unsigned(vertex.size()));
+   key += header;
+   key.append((const char*)vertex.data(), vertex.size() * sizeof(uint32_t));
+
+   snprintf(header, sizeof(header), "fragment %u\n", unsigned(fragment.size()));
+   key += header;
+   key.append((const char*)fragment.data(), fragment.size() * sizeof(uint32_t));
+
+   return key;
+}
+
+static void slang_reflection_save_semantic(vector<uint32_t> &words,
+      const slang_semantic_meta &meta)
+{
+   words.push_back(uint32_t(meta.ubo_offset));
+   words.push_back(uint32_t(meta.push_constant_offset));
+   words.push_back(meta.num_components);
+   words.push_back(uint32_t(meta.uniform) | uint32_t(meta.push_constant) << 1);
+}
+
+static void slang_reflection_save(const slang_reflection *reflection,
+      vector<uint32_t> &words)
+{
+   unsigned i;
+
+   words.push_back(uint32_t(reflection->ubo_size));
+   words.push_back(uint32_t(reflection->push_constant_size));
+   words.push_back(reflection->ubo_binding);
+   words.push_back(reflection->ubo_stage_mask);
+   words.push_back(reflection->push_constant_stage_mask);
+
+   for (i = 0; i < SLANG_NUM_TEXTURE_SEMANTICS; i++)
+   {
+      words.push_back(uint32_t(reflection->semantic_textures[i].size()));
+
+      for (auto &meta : reflection->semantic_textures[i])
+      {
+         words.push_back(uint32_t(meta.ubo_offset));
+         words.push_back(uint32_t(meta.push_constant_offset));
+         words.push_back(meta.binding);
+         words.push_back(meta.stage_mask);
+         words.push_back(uint32_t(meta.texture)
+               | uint32_t(meta.uniform) << 1
+               | uint32_t(meta.push_constant) << 2);
+      }
+   }
+
+   for (i = 0; i < SLANG_NUM_SEMANTICS; i++)
+      slang_reflection_save_semantic(words, reflection->semantics[i]);
+
+   words.push_back(uint32_t(reflection->semantic_float_parameters.size()));
+   for (auto &meta : reflection->semantic_float_parameters)
+      slang_reflection_save_semantic(words, meta);
+}
+
+struct slang_reflection_reader
+{
+   const vector<uint32_t> &words;
+   size_t pos;
+
+   bool read(uint32_t *value)
+   {
+      if (pos >= words.size())
+         return false;
+      *value = words[pos++];
+      return true;
+   }
+};
+
+static bool slang_reflection_load_semantic(slang_reflection_reader &reader,
+      slang_semantic_meta *meta)
+{
+   uint32_t ubo_offset, push_constant_offset, num_components, flags;
+
+   if (     !reader.read(&ubo_offset)
+         || !reader.read(&push_constant_offset)
+         || !reader.read(&num_components)
+         || !reader.read(&flags))
+      return false;
+
+   meta->ubo_offset           = ubo_offset;
+   meta->push_constant_offset = push_constant_offset;
+   meta->num_components       = num_components;
+   meta->uniform              = (flags & 1) != 0;
+   meta->push_constant        = (flags & 2) != 0;
+   return true;
+}
+
+static bool slang_reflection_load(const vector<uint32_t> &words,
+      slang_reflection *reflection)
+{
+   unsigned i;
+   uint32_t count, ubo_size, push_constant_size;
+   slang_reflection_reader reader = { words, 0 };
+
+   if (     !reader.read(&ubo_size)
+         || !reader.read(&push_constant_size)
+         || !reader.read(&reflection->ubo_binding)
+         || !reader.read(&reflection->ubo_stage_mask)
+         || !reader.read(&reflection->push_constant_stage_mask))
+      return false;
+
+   reflection->ubo_size           = ubo_size;
+   reflection->push_constant_size = push_constant_size;
+
+   for (i = 0; i < SLANG_NUM_TEXTURE_SEMANTICS; i++)
+   {
+      if (!reader.read(&count) || count > words.size())
+         return false;
+
+      reflection->semantic_textures[i].resize(count);
+
+      for (auto &meta : reflection->semantic_textures[i])
+      {
+         uint32_t ubo_offset, push_constant_offset, flags;
+
+         if (     !reader.read(&ubo_offset)
+               || !reader.read(&push_constant_offset)
+               || !reader.read(&meta.binding)
+               || !reader.read(&meta.stage_mask)
+               || !reader.read(&flags))
+            return false;
+
+         meta.ubo_offset           = ubo_offset;
+         meta.push_constant_offset = push_constant_offset;
+         meta.texture              = (flags & 1) != 0;
+         meta.uniform              = (flags & 2) != 0;
+         meta.push_constant        = (flags & 4) != 0;
+      }
+   }
+
+   for (i = 0; i < SLANG_NUM_SEMANTICS; i++)
+      if (!slang_reflection_load_semantic(reader, &reflection->semantics[i]))
+         return false;
+
+   if (!reader.read(&count) || count > words.size())
+      return false;
+
+   reflection->semantic_float_parameters.resize(count);
+   for (auto &meta : reflection->semantic_float_parameters)
+      if (!slang_reflection_load_semantic(reader, &meta))
+         return false;
+
+   return reader.pos == words.size();
+}
+
 bool slang_reflect_spirv(const std::vector<uint32_t> &vertex,
       const std::vector<uint32_t> &fragment,
       slang_reflection *reflection)
 {
+   vector<uint32_t> words;
+   string key = slang_cache_key(
+         slang_reflection_key(vertex, fragment, reflection));
+
+   if (slang_cache_load(key, "refl", &words))
+   {
+      slang_reflection cached;
+
+      cached.pass_number                  = reflection->pass_number;
+      cached.texture_semantic_map         = reflection->texture_semantic_map;
+      cached.texture_semantic_uniform_map = reflection->texture_semantic_uniform_map;
+      cached.semantic_map                 = reflection->semantic_map;
+
+      if (slang_reflection_load(words, &cached))
+      {
+         *reflection = cached;
+         return true;
+      }
+
+      RARCH_WARN("[slang]: Ignoring invalid cached reflection.\n");
+   }
+
    try
    {
       Compiler vertex_compiler(vertex);
@@ -664,6 +878,9 @@ bool slang_reflect_spirv(const std::vector<uint32_t> &vertex,
          return false;
       }
 
+      words.clear();
+      slang_reflection_save(reflection, words);
+      slang_cache_store(key, "refl", words);
       return true;
    }
    catch (const std::exception &e)
@@ -26,6 +26,8 @@
 
 #include <stdlib.h>
 
+#include <retro_miscellaneous.h>
+
 static const font_renderer_driver_t *font_backends[] = {
 #ifdef HAVE_FREETYPE
    &freetype_font_renderer,
@@ -42,6 +44,49 @@ static const font_renderer_driver_t *font_backends[] = {
 
 static void *g_osd_font;
 
+void font_atlas_mark_dirty(struct font_atlas *atlas,
+      unsigned y, unsigned height)
+{
+   if (!height)
+      return;
+
+   if (!atlas->dirty)
+   {
+      atlas->dirty_begin = y;
+      atlas->dirty_end   = y + height;
+      atlas->dirty       = true;
+   }
+   else if (atlas->dirty_begin < atlas->dirty_end)
+   {
+      atlas->dirty_begin = MIN(atlas->dirty_begin, y);
+      atlas->dirty_end   = MAX(atlas->dirty_end, y + height);
+   }
+}
+
+bool font_atlas_take_dirty(struct font_atlas *atlas,
+      unsigned *y, unsigned *height)
+{
+   if (!atlas->dirty)
+      return false;
+
+   if (     atlas->dirty_begin < atlas->dirty_end
+         && atlas->dirty_end  <= atlas->height)
+   {
+      *y      = atlas->dirty_begin;
+      *height = atlas->dirty_end - atlas->dirty_begin;
+   }
+   else
+   {
+      *y      = 0;
+      *height = atlas->height;
+   }
+
+   atlas->dirty       = false;
+   atlas->dirty_begin = 0;
+   atlas->dirty_end   = 0;
+   return true;
+}
+
 int font_renderer_create_default(const void **data, void **handle,
       const char *font_path, unsigned font_size)
 {
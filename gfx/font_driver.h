@@ -74,6 +74,11 @@ struct font_atlas
    unsigned width;
    unsigned height;
    bool dirty;
+
+   /* Rows changed since the last upload, see font_atlas_mark_dirty().
+    * If dirty is set while these are empty, everything changed. */
+   unsigned dirty_begin;
+   unsigned dirty_end;
 };
 
 struct font_params
@@ -137,6 +142,16 @@ typedef struct
 /* font_path can be NULL for default font. */
 int font_renderer_create_default(const void **driver,
       void **handle, const char *font_path, unsigned font_size);
+
+/* Called by font renderers after changing rows of the atlas. */
+void font_atlas_mark_dirty(struct font_atlas *atlas,
+      unsigned y, unsigned height);
+
+/* Called by font drivers before uploading the atlas. Returns false
+ * if nothing changed, otherwise the rows to upload and clears the
+ * dirty state. */
+bool font_atlas_take_dirty(struct font_atlas *atlas,
+      unsigned *y, unsigned *height);
       
 bool font_driver_has_render_msg(void);
 
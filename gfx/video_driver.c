@@ -107,6 +107,15 @@ static retro_time_t video_driver_frame_time_samples[MEASURE_FRAME_TIME_SAMPLES_C
 static uint64_t video_driver_frame_time_count            = 0;
 static uint64_t video_driver_frame_count                 = 0;
 
+/* Set while frames are run that will never be shown,
+ * e.g. by run-ahead. */
+static bool video_driver_frame_suppressed                = false;
+
+/* Time at which the last call to the driver's frame function
+ * began and returned. */
+static retro_time_t video_driver_present_begin           = 0;
+static retro_time_t video_driver_present_end             = 0;
+
 static void *video_driver_data                           = NULL;
 static video_driver_t *current_video                     = NULL;
 
@@ -608,6 +617,7 @@ static bool init_video(void)
 
    runloop_ctl(RUNLOOP_CTL_SYSTEM_INFO_GET, &system);
 
+   conv_init_simd(cpu_features_get());
    init_video_filter(video_driver_pix_fmt);
    command_event(CMD_EVENT_SHADER_DIR_INIT, NULL);
 
@@ -836,6 +846,19 @@ void video_driver_set_texture_frame(const void *frame, bool rgb32,
 #endif
 }
 
+void video_driver_set_texture_frame_rows(const void *frame, bool rgb32,
+      unsigned width, unsigned height, unsigned y, unsigned rows,
+      float alpha)
+{
+#ifdef HAVE_MENU
+   if (video_driver_poke && video_driver_poke->set_texture_frame_rows)
+      video_driver_poke->set_texture_frame_rows(video_driver_data,
+            frame, rgb32, width, height, y, rows, alpha);
+   else
+      video_driver_set_texture_frame(frame, rgb32, width, height, alpha);
+#endif
+}
+
 #ifdef HAVE_OVERLAY
 bool video_driver_overlay_interface(const video_overlay_interface_t **iface)
 {
@@ -2102,6 +2125,15 @@ void video_driver_frame(const void *data, unsigned width,
    const char *msg        = NULL;
    settings_t *settings   = config_get_ptr();
 
+   /* Skip scaling, filtering and recording altogether
+    * for frames nobody will see. The frame is still
+    * remembered, run-ahead may have to show it after all. */
+   if (video_driver_frame_suppressed)
+   {
+      video_driver_cached_frame_set(data, width, height, pitch);
+      return;
+   }
+
    runloop_ctl(RUNLOOP_CTL_MSG_QUEUE_PULL,   &msg);
 
    if (!video_driver_is_active())
@@ -2146,15 +2178,39 @@ void video_driver_frame(const void *data, unsigned width,
    if (msg)
       strlcpy(video_driver_msg, msg, sizeof(video_driver_msg));
 
+   video_driver_present_begin = cpu_features_get_time_usec();
+
    if (!current_video || !current_video->frame(
             video_driver_data, data, width, height,
             video_driver_frame_count,
             pitch, video_driver_msg))
       video_driver_unset_active();
 
+   video_driver_present_end   = cpu_features_get_time_usec();
+
    video_driver_frame_count++;
 }
 
+void video_driver_set_frame_suppressed(bool state)
+{
+   video_driver_frame_suppressed = state;
+}
+
+/**
+ * video_driver_get_present_time:
+ * @begin                : time at which the last frame was handed to the driver.
+ * @end                  : time at which the driver returned.
+ *
+ * With VSync on, @end approximates the time of the last VBlank.
+ **/
+void video_driver_get_present_time(retro_time_t *begin, retro_time_t *end)
+{
+   if (begin)
+      *begin = video_driver_present_begin;
+   if (end)
+      *end   = video_driver_present_end;
+}
+
 void video_driver_display_type_set(enum rarch_display_type type)
 {
    video_driver_display_type = type;
@@ -186,6 +186,13 @@ typedef struct video_poke_interface
          struct retro_framebuffer *framebuffer);
    bool (*get_hw_render_interface)(void *data,
          const struct retro_hw_render_interface **iface);
+#ifdef HAVE_MENU
+   /* Update rows [y, y + rows) of the texture, frame still holds
+    * the whole image. Drivers may upload all of it instead. */
+   void (*set_texture_frame_rows)(void *data, const void *frame, bool rgb32,
+         unsigned width, unsigned height, unsigned y, unsigned rows,
+         float alpha);
+#endif
 } video_poke_interface_t;
 
 typedef struct video_viewport
@@ -431,6 +438,10 @@ void video_driver_set_texture_enable(bool enable, bool full_screen);
 void video_driver_set_texture_frame(const void *frame, bool rgb32,
       unsigned width, unsigned height, float alpha);
 
+void video_driver_set_texture_frame_rows(const void *frame, bool rgb32,
+      unsigned width, unsigned height, unsigned y, unsigned rows,
+      float alpha);
+
 #ifdef HAVE_OVERLAY
 bool video_driver_overlay_interface(
       const video_overlay_interface_t **iface);
@@ -546,6 +557,10 @@ const video_poke_interface_t *video_driver_get_poke(void);
 void video_driver_frame(const void *data, unsigned width,
       unsigned height, size_t pitch);
 
+void video_driver_get_present_time(retro_time_t *begin, retro_time_t *end);
+
+void video_driver_set_frame_suppressed(bool state);
+
 uintptr_t video_driver_display_get(void);
 
 enum rarch_display_type video_driver_display_type_get(void);
@@ -31,6 +31,9 @@
 #include "../runloop.h"
 #include "../verbosity.h"
 
+/* Number of frame buffers in the pool shared with the video thread. */
+#define THREAD_FRAME_SLOTS 3
+
 enum thread_cmd
 {
    CMD_VIDEO_NONE = 0,
@@ -206,17 +209,32 @@ struct thread_video
    struct video_viewport vp;
    struct video_viewport read_vp; /* Last viewport reported to caller. */
 
+   /* Triple-buffered frame pool. The caller owns slot 'write',
+    * the video thread owns slot 'read', and slot 'pending' holds
+    * the newest complete frame. Indices are swapped under
+    * thr->lock, frame data is never copied while holding it. */
    struct
    {
       slock_t *lock;
       uint8_t *buffer;
-      unsigned width;
-      unsigned height;
-      unsigned pitch;
-      bool updated;
+      size_t slot_size;
+      unsigned max_width;
+      struct
+      {
+         uint8_t *data;
+         unsigned width;
+         unsigned height;
+         unsigned pitch;
+         uint64_t count;
+         bool dupe;      /* No data, show the last frame again. */
+         char msg[PATH_MAX_LENGTH];
+      } slots[THREAD_FRAME_SLOTS];
+      unsigned write;
+      unsigned pending;
+      unsigned read;
+      bool updated;   /* Slot 'pending' holds a frame not yet picked up. */
+      bool rendering; /* Video thread is busy with slot 'read'. */
       bool within_thread;
-      uint64_t count;
-      char msg[PATH_MAX_LENGTH];
    } frame;
 
    video_driver_t video_thread;
@@ -561,6 +579,8 @@ static bool video_thread_handle_packet(
    return false;
 }
 
+static struct retro_perf_counter thr_frame_hit = {0};
+
 static void video_thread_loop(void *data)
 {
    thread_video_t *thr = (thread_video_t*)data;
@@ -574,7 +594,22 @@ static void video_thread_loop(void *data)
       while (thr->send_cmd == CMD_VIDEO_NONE && !thr->frame.updated)
          scond_wait(thr->cond_thread, thr->lock);
       if (thr->frame.updated)
-         updated = true;
+      {
+         /* Take the newest frame, the caller keeps writing
+          * into its own slot meanwhile. */
+         unsigned read        = thr->frame.read;
+         thr->frame.read      = thr->frame.pending;
+         thr->frame.pending   = read;
+         thr->frame.updated   = false;
+         thr->frame.rendering = true;
+         updated              = true;
+
+         thr->hit_count++;
+         performance_counter_sample(&thr_frame_hit, 1);
+
+         /* Slot 'pending' is free again. */
+         scond_signal(thr->cond_cmd);
+      }
 
       /* To avoid race condition where send_cmd is updated 
        * right after the switch is checked. */
@@ -592,6 +627,7 @@ static void video_thread_loop(void *data)
          bool               focus = false;
          bool        has_windowed = true;
          struct video_viewport vp = {0};
+         const char          *msg = thr->frame.slots[thr->frame.read].msg;
 
          slock_lock(thr->frame.lock);
 
@@ -599,9 +635,13 @@ static void video_thread_loop(void *data)
 
          if (thr->driver && thr->driver->frame)
             ret = thr->driver->frame(thr->driver_data,
-               thr->frame.buffer, thr->frame.width, thr->frame.height,
-               thr->frame.count,
-               thr->frame.pitch, *thr->frame.msg ? thr->frame.msg : NULL);
+               thr->frame.slots[thr->frame.read].dupe
+               ? NULL : thr->frame.slots[thr->frame.read].data,
+               thr->frame.slots[thr->frame.read].width,
+               thr->frame.slots[thr->frame.read].height,
+               thr->frame.slots[thr->frame.read].count,
+               thr->frame.slots[thr->frame.read].pitch,
+               *msg ? msg : NULL);
 
          slock_unlock(thr->frame.lock);
 
@@ -621,7 +661,7 @@ static void video_thread_loop(void *data)
          thr->alive         = alive;
          thr->focus         = focus;
          thr->has_windowed  = has_windowed;
-         thr->frame.updated = false;
+         thr->frame.rendering = false;
          thr->vp            = vp;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
@@ -690,7 +730,9 @@ static bool video_thread_frame(void *data, const void *frame_,
       unsigned pitch, const char *msg)
 {
    unsigned copy_stride;
-   static struct retro_perf_counter thr_frame = {0};
+   static struct retro_perf_counter thr_frame           = {0};
+   static struct retro_perf_counter thr_frame_zero_copy = {0};
+   static struct retro_perf_counter thr_frame_miss      = {0};
    const uint8_t *src                  = NULL;
    uint8_t *dst                        = NULL;
    thread_video_t *thr                 = (thread_video_t*)data;
@@ -708,13 +750,43 @@ static bool video_thread_frame(void *data, const void *frame_,
    }
 
    performance_counter_init(&thr_frame, "thr_frame");
+   performance_counter_init(&thr_frame_zero_copy, "thr_frame_zero_copy");
+   performance_counter_init(&thr_frame_hit, "thr_frame_hit");
+   performance_counter_init(&thr_frame_miss, "thr_frame_miss");
    performance_counter_start(&thr_frame);
 
    copy_stride = width * (thr->info.rgb32 
          ? sizeof(uint32_t) : sizeof(uint16_t));
 
    src = (const uint8_t*)frame_;
-   dst = thr->frame.buffer;
+   dst = thr->frame.slots[thr->frame.write].data;
+
+   /* The write slot belongs to us, so fill it without holding
+    * the lock. If the core rendered straight into it through
+    * GET_CURRENT_SOFTWARE_FRAMEBUFFER, there is nothing to copy. */
+   if (src == dst)
+   {
+      copy_stride = pitch;
+      performance_counter_sample(&thr_frame_zero_copy, 1);
+   }
+   else if (src)
+   {
+      unsigned h;
+      for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
+         memcpy(dst, src, copy_stride);
+   }
+
+   thr->frame.slots[thr->frame.write].width  = width;
+   thr->frame.slots[thr->frame.write].height = height;
+   thr->frame.slots[thr->frame.write].count  = frame_count;
+   thr->frame.slots[thr->frame.write].pitch  = copy_stride;
+   thr->frame.slots[thr->frame.write].dupe   = !src;
+
+   if (msg)
+      strlcpy(thr->frame.slots[thr->frame.write].msg, msg,
+            sizeof(thr->frame.slots[thr->frame.write].msg));
+   else
+      *thr->frame.slots[thr->frame.write].msg = '\0';
 
    slock_lock(thr->lock);
 
@@ -740,41 +812,41 @@ static bool video_thread_frame(void *data, const void *frame_,
       }
    }
 
-   /* Drop frame if updated flag is still set, as thread is 
-    * still working on last frame. */
-   if (!thr->frame.updated)
+   /* A dupe repeats whatever was shown last. If a real frame is
+    * still pending, that one is about to be shown, so keep it. */
+   if (src || !thr->frame.updated
+         || thr->frame.slots[thr->frame.pending].dupe)
    {
-      if (src)
+      unsigned pending;
+
+      /* If the thread has not picked up the previous frame yet,
+       * it is replaced by this one and counts as dropped. */
+      if (thr->frame.updated)
       {
-         unsigned h;
-         for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
-            memcpy(dst, src, copy_stride);
+         thr->miss_count++;
+         performance_counter_sample(&thr_frame_miss, 1);
       }
 
+      pending            = thr->frame.pending;
+      thr->frame.pending = thr->frame.write;
+      thr->frame.write   = pending;
       thr->frame.updated = true;
-      thr->frame.width  = width;
-      thr->frame.height = height;
-      thr->frame.count  = frame_count;
-      thr->frame.pitch  = copy_stride;
-
-      if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
-      else
-         *thr->frame.msg = '\0';
+   }
+   else if (msg)
+      strlcpy(thr->frame.slots[thr->frame.pending].msg, msg,
+            sizeof(thr->frame.slots[thr->frame.pending].msg));
 
-      scond_signal(thr->cond_thread);
+   scond_signal(thr->cond_thread);
 
 #if defined(HAVE_MENU)
-      if (thr->texture.enable)
-      {
-         while (thr->frame.updated)
-            scond_wait(thr->cond_cmd, thr->lock);
-      }
-#endif
-      thr->hit_count++;
+   /* With the menu up, wait until this frame has been drawn,
+    * not only picked up. */
+   if (thr->texture.enable)
+   {
+      while (thr->frame.updated || thr->frame.rendering)
+         scond_wait(thr->cond_cmd, thr->lock);
    }
-   else
-      thr->miss_count++;
+#endif
 
    slock_unlock(thr->lock);
 
@@ -794,6 +866,7 @@ static void video_thread_set_nonblock_state(void *data, bool state)
 static bool video_thread_init(thread_video_t *thr, const video_info_t *info,
       const input_driver_t **input, void **input_data)
 {
+   unsigned i;
    size_t max_size;
    thread_packet_t pkt = {CMD_INIT};
 
@@ -810,15 +883,25 @@ static bool video_thread_init(thread_video_t *thr, const video_info_t *info,
    thr->has_windowed         = true;
    thr->suppress_screensaver = true;
 
-   max_size                  = info->input_scale * RARCH_SCALE_BASE;
+   thr->frame.max_width      = info->input_scale * RARCH_SCALE_BASE;
+   max_size                  = thr->frame.max_width;
    max_size                 *= max_size;
    max_size                 *= info->rgb32 ? sizeof(uint32_t) : sizeof(uint16_t);
-   thr->frame.buffer         = (uint8_t*)malloc(max_size);
+   thr->frame.slot_size      = max_size;
+   thr->frame.buffer         = (uint8_t*)
+      malloc(max_size * THREAD_FRAME_SLOTS);
 
    if (!thr->frame.buffer)
       return false;
 
-   memset(thr->frame.buffer, 0x80, max_size);
+   memset(thr->frame.buffer, 0x80, max_size * THREAD_FRAME_SLOTS);
+
+   for (i = 0; i < THREAD_FRAME_SLOTS; i++)
+      thr->frame.slots[i].data = thr->frame.buffer + i * max_size;
+
+   thr->frame.write          = 0;
+   thr->frame.pending        = 1;
+   thr->frame.read           = 2;
 
    thr->last_time            = cpu_features_get_time_usec();
    thr->thread               = sthread_create(video_thread_loop, thr);
@@ -1232,6 +1315,36 @@ static struct video_shader *thread_get_current_shader(void *data)
    return thr->poke->get_current_shader(thr->driver_data);
 }
 
+static bool thread_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   size_t pitch;
+   thread_video_t *thr = (thread_video_t*)data;
+   enum retro_pixel_format fmt = video_driver_get_pixel_format();
+
+   if (!thr || !framebuffer)
+      return false;
+
+   /* Frames that get converted or filtered before reaching us
+    * can't be rendered in place. */
+   if (fmt == RETRO_PIXEL_FORMAT_0RGB1555 || video_driver_frame_filter_alive())
+      return false;
+
+   pitch = framebuffer->width * (thr->info.rgb32 
+         ? sizeof(uint32_t) : sizeof(uint16_t));
+
+   if (framebuffer->width > thr->frame.max_width
+         || pitch * framebuffer->height > thr->frame.slot_size)
+      return false;
+
+   framebuffer->data         = thr->frame.slots[thr->frame.write].data;
+   framebuffer->pitch        = pitch;
+   framebuffer->format       = fmt;
+   framebuffer->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+
+   return true;
+}
+
 static const video_poke_interface_t thread_poke = {
    thread_load_texture,
    thread_unload_texture,
@@ -1257,6 +1370,7 @@ static const video_poke_interface_t thread_poke = {
    NULL,
 
    thread_get_current_shader,
+   thread_get_current_software_framebuffer,
 };
 
 static void video_thread_get_poke_interface(
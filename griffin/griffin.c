@@ -126,6 +126,7 @@ ACHIEVEMENTS
 #include "../libretro-common/formats/json/jsonsax.c"
 #include "../network/net_http_special.c"
 #include "../cheevos.c"
+#include "../cheevos_eval.c"
 #endif
 
 /*============================================================
@@ -534,6 +535,7 @@ STATE TRACKER
 FIFO BUFFER
 ============================================================ */
 #include "../libretro-common/queues/fifo_queue.c"
+#include "../libretro-common/queues/fifo_spsc.c"
 
 /*============================================================
 AUDIO RESAMPLER
@@ -709,6 +711,7 @@ FILE
 #include "../list_special.c"
 #include "../libretro-common/string/stdstring.c"
 #include "../libretro-common/file/nbio/nbio_stdio.c"
+#include "../libretro-common/file/nbio/nbio_thread.c"
 
 /*============================================================
 MESSAGE
@@ -836,6 +839,7 @@ WIFI
 RECORDING
 ============================================================ */
 #include "../movie.c"
+#include "../runahead.c"
 #include "../record/record_driver.c"
 #include "../record/drivers/record_null.c"
 
@@ -174,6 +174,7 @@ VIDEO DRIVER
 #include "../gfx/drivers_shader/shader_vulkan.cpp"
 #include "../gfx/drivers_shader/glslang_util.cpp"
 #include "../gfx/drivers_shader/slang_reflection.cpp"
+#include "../gfx/drivers_shader/slang_cache.cpp"
 #include "../deps/SPIRV-Cross/spirv_cross.cpp"
 #endif
 
@@ -27,12 +27,12 @@
 #include <retro_inline.h>
 #include <algorithms/mismatch.h>
 #include <compat/intrinsics.h>
+#include <libretro.h>
 
 #if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__)
 #define CPU_X86
 #endif
 
-/* Other arches SIGBUS (usually) on unaligned accesses. */
 #ifndef CPU_X86
 #define NO_UNALIGNED_MEM
 #endif
@@ -41,32 +41,24 @@
 #include <emmintrin.h>
 #endif
 
-/* There's no equivalent in libc, you'd think so ...
- * std::mismatch exists, but it's not optimized at all. */
-size_t find_change(const uint16_t *a, const uint16_t *b)
-{
-#if __SSE2__
-   const __m128i *a128 = (const __m128i*)a;
-   const __m128i *b128 = (const __m128i*)b;
-   
-   for (;;)
-   {
-      __m128i v0    = _mm_loadu_si128(a128);
-      __m128i v1    = _mm_loadu_si128(b128);
-      __m128i c     = _mm_cmpeq_epi32(v0, v1);
-      uint32_t mask = _mm_movemask_epi8(c);
+/* AVX2 is not part of the baseline of any x86 target we build
+ * for, so compile it per function and select it at runtime. */
+#if defined(CPU_X86) && defined(__GNUC__) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HAVE_MISMATCH_AVX2
+#include <immintrin.h>
+#endif
 
-      if (mask != 0xffff) /* Something has changed, figure out where. */
-      {
-         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
-               (compat_ctz(~mask))) >> 1;
-         return ret | (a[ret] == b[ret]);
-      }
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define HAVE_MISMATCH_NEON
+#include <arm_neon.h>
+#endif
 
-      a128++;
-      b128++;
-   }
-#else
+/* All implementations rely on the buffers being terminated
+ * by a mismatching uint16 followed by enough padding for a
+ * full vector load (see state_manager_raw_alloc()). */
+
+static size_t find_change_C(const uint16_t *a, const uint16_t *b)
+{
    const uint16_t *a_org = a;
 #ifdef NO_UNALIGNED_MEM
    while (((uintptr_t)a & (sizeof(size_t) - 1)) && *a == *b)
@@ -95,10 +87,9 @@ size_t find_change(const uint16_t *a, const uint16_t *b)
       }
    }
    return a - a_org;
-#endif
 }
 
-size_t find_same(const uint16_t *a, const uint16_t *b)
+static size_t find_same_C(const uint16_t *a, const uint16_t *b)
 {
    const uint16_t *a_org = a;
 #ifdef NO_UNALIGNED_MEM
@@ -137,3 +128,223 @@ size_t find_same(const uint16_t *a, const uint16_t *b)
    }
    return a - a_org;
 }
+
+#if __SSE2__
+static size_t find_change_SSE2(const uint16_t *a, const uint16_t *b)
+{
+   const __m128i *a128 = (const __m128i*)a;
+   const __m128i *b128 = (const __m128i*)b;
+   
+   for (;;)
+   {
+      __m128i v0    = _mm_loadu_si128(a128);
+      __m128i v1    = _mm_loadu_si128(b128);
+      __m128i c     = _mm_cmpeq_epi32(v0, v1);
+      uint32_t mask = _mm_movemask_epi8(c);
+
+      if (mask != 0xffff) /* Something has changed, figure out where. */
+      {
+         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
+               (compat_ctz(~mask))) >> 1;
+         return ret | (a[ret] == b[ret]);
+      }
+
+      a128++;
+      b128++;
+   }
+}
+
+static size_t find_same_SSE2(const uint16_t *a, const uint16_t *b)
+{
+   const __m128i *a128 = (const __m128i*)a;
+   const __m128i *b128 = (const __m128i*)b;
+
+   for (;;)
+   {
+      __m128i v0    = _mm_loadu_si128(a128);
+      __m128i v1    = _mm_loadu_si128(b128);
+      __m128i c     = _mm_cmpeq_epi32(v0, v1);
+      uint32_t mask = _mm_movemask_epi8(c);
+
+      if (mask) /* Found an identical uint32. */
+      {
+         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
+               compat_ctz(mask)) >> 1;
+
+         if (ret && a[ret - 1] == b[ret - 1])
+            ret--;
+         return ret;
+      }
+
+      a128++;
+      b128++;
+   }
+}
+#endif
+
+#ifdef HAVE_MISMATCH_AVX2
+__attribute__((target("avx2")))
+static size_t find_change_AVX2(const uint16_t *a, const uint16_t *b)
+{
+   const __m256i *a256 = (const __m256i*)a;
+   const __m256i *b256 = (const __m256i*)b;
+
+   for (;;)
+   {
+      __m256i v0    = _mm256_loadu_si256(a256);
+      __m256i v1    = _mm256_loadu_si256(b256);
+      __m256i c     = _mm256_cmpeq_epi32(v0, v1);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(c);
+
+      if (mask != 0xffffffffu)
+      {
+         size_t ret = (((uint8_t*)a256 - (uint8_t*)a) |
+               (compat_ctz(~mask))) >> 1;
+         return ret | (a[ret] == b[ret]);
+      }
+
+      a256++;
+      b256++;
+   }
+}
+
+__attribute__((target("avx2")))
+static size_t find_same_AVX2(const uint16_t *a, const uint16_t *b)
+{
+   const __m256i *a256 = (const __m256i*)a;
+   const __m256i *b256 = (const __m256i*)b;
+
+   for (;;)
+   {
+      __m256i v0    = _mm256_loadu_si256(a256);
+      __m256i v1    = _mm256_loadu_si256(b256);
+      __m256i c     = _mm256_cmpeq_epi32(v0, v1);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(c);
+
+      if (mask)
+      {
+         size_t ret = (((uint8_t*)a256 - (uint8_t*)a) |
+               compat_ctz(mask)) >> 1;
+
+         if (ret && a[ret - 1] == b[ret - 1])
+            ret--;
+         return ret;
+      }
+
+      a256++;
+      b256++;
+   }
+}
+#endif
+
+#ifdef HAVE_MISMATCH_NEON
+/* NEON has no cheap movemask, so only test whole 16-byte
+ * blocks with it and locate the exact lane with scalar code. */
+static size_t find_change_NEON(const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+
+   for (;;)
+   {
+      uint32x4_t c = vceqq_u32(
+            vreinterpretq_u32_u8(vld1q_u8(a8)),
+            vreinterpretq_u32_u8(vld1q_u8(b8)));
+      uint32x2_t r = vand_u32(vget_low_u32(c), vget_high_u32(c));
+
+      if ((vget_lane_u32(r, 0) & vget_lane_u32(r, 1)) != 0xffffffffu)
+      {
+         size_t ret = (a8 - (const uint8_t*)a) >> 1;
+
+         while (a[ret] == b[ret])
+            ret++;
+         return ret;
+      }
+
+      a8 += 16;
+      b8 += 16;
+   }
+}
+
+static size_t find_same_NEON(const uint16_t *a, const uint16_t *b)
+{
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+
+   for (;;)
+   {
+      uint32x4_t c = vceqq_u32(
+            vreinterpretq_u32_u8(vld1q_u8(a8)),
+            vreinterpretq_u32_u8(vld1q_u8(b8)));
+      uint32x2_t r = vorr_u32(vget_low_u32(c), vget_high_u32(c));
+
+      if (vget_lane_u32(r, 0) | vget_lane_u32(r, 1))
+      {
+         /* Same uint32 pairing as the other implementations. */
+         size_t ret = (a8 - (const uint8_t*)a) >> 1;
+
+         while (a[ret] != b[ret] || a[ret + 1] != b[ret + 1])
+            ret += 2;
+
+         if (ret && a[ret - 1] == b[ret - 1])
+            ret--;
+         return ret;
+      }
+
+      a8 += 16;
+      b8 += 16;
+   }
+}
+#endif
+
+#if __SSE2__
+static size_t (*find_change_impl)(const uint16_t*, const uint16_t*) = find_change_SSE2;
+static size_t (*find_same_impl)(const uint16_t*, const uint16_t*)   = find_same_SSE2;
+#else
+static size_t (*find_change_impl)(const uint16_t*, const uint16_t*) = find_change_C;
+static size_t (*find_same_impl)(const uint16_t*, const uint16_t*)   = find_same_C;
+#endif
+
+uint64_t mismatch_init_simd(uint64_t mask)
+{
+   (void)mask;
+
+#ifdef HAVE_MISMATCH_AVX2
+   if (mask & RETRO_SIMD_AVX2)
+   {
+      find_change_impl = find_change_AVX2;
+      find_same_impl   = find_same_AVX2;
+      return RETRO_SIMD_AVX2;
+   }
+#endif
+#if __SSE2__
+   if (mask & RETRO_SIMD_SSE2)
+   {
+      find_change_impl = find_change_SSE2;
+      find_same_impl   = find_same_SSE2;
+      return RETRO_SIMD_SSE2;
+   }
+#endif
+#ifdef HAVE_MISMATCH_NEON
+   if (mask & RETRO_SIMD_NEON)
+   {
+      find_change_impl = find_change_NEON;
+      find_same_impl   = find_same_NEON;
+      return RETRO_SIMD_NEON;
+   }
+#endif
+
+   find_change_impl = find_change_C;
+   find_same_impl   = find_same_C;
+   return 0;
+}
+
+size_t find_change(const uint16_t *a, const uint16_t *b)
+{
+   return find_change_impl(a, b);
+}
+
+size_t find_same(const uint16_t *a, const uint16_t *b)
+{
+   return find_same_impl(a, b);
+}
@@ -595,6 +595,10 @@ uint64_t cpu_features_get(void)
    if (sysctlbyname("hw.optional.avx2_0", NULL, &len, NULL, 0) == 0)
       cpu |= RETRO_SIMD_AVX2;
 
+   len            = sizeof(size_t);
+   if (sysctlbyname("hw.optional.fma", NULL, &len, NULL, 0) == 0)
+      cpu |= RETRO_SIMD_FMA;
+
    len            = sizeof(size_t);
    if (sysctlbyname("hw.optional.altivec", NULL, &len, NULL, 0) == 0)
       cpu |= RETRO_SIMD_VMX;
@@ -665,13 +669,22 @@ uint64_t cpu_features_get(void)
    if (flags[2] & (1 << 25))
       cpu |= RETRO_SIMD_AES;
 
+   if (flags[2] & (1 << 1))
+      cpu |= RETRO_SIMD_PCLMUL;
+
 
    /* Must only perform xgetbv check if we have
     * AVX CPU support (guaranteed to have at least i686). */
    if (((flags[2] & avx_flags) == avx_flags)
          && ((xgetbv_x86(0) & 0x6) == 0x6))
+   {
       cpu |= RETRO_SIMD_AVX;
 
+      /* FMA3 works on the same YMM state. */
+      if (flags[2] & (1 << 12))
+         cpu |= RETRO_SIMD_FMA;
+   }
+
    if (max_flag >= 7)
    {
       x86_cpuid(7, flags);
@@ -704,6 +717,9 @@ uint64_t cpu_features_get(void)
    if (check_arm_cpu_feature("vfpv4"))
       cpu |= RETRO_SIMD_VFPV4;
 
+   if (check_arm_cpu_feature("crc32"))
+      cpu |= RETRO_SIMD_CRC32;
+
    if (check_arm_cpu_feature("asimd"))
    {
       cpu |= RETRO_SIMD_ASIMD;
@@ -748,8 +764,10 @@ uint64_t cpu_features_get(void)
    if (cpu & RETRO_SIMD_SSE4)   strlcat(buf, " SSE4", sizeof(buf));
    if (cpu & RETRO_SIMD_SSE42)  strlcat(buf, " SSE4.2", sizeof(buf));
    if (cpu & RETRO_SIMD_AES)    strlcat(buf, " AES", sizeof(buf));
+   if (cpu & RETRO_SIMD_PCLMUL) strlcat(buf, " PCLMUL", sizeof(buf));
    if (cpu & RETRO_SIMD_AVX)    strlcat(buf, " AVX", sizeof(buf));
    if (cpu & RETRO_SIMD_AVX2)   strlcat(buf, " AVX2", sizeof(buf));
+   if (cpu & RETRO_SIMD_FMA)    strlcat(buf, " FMA", sizeof(buf));
    if (cpu & RETRO_SIMD_NEON)   strlcat(buf, " NEON", sizeof(buf));
    if (cpu & RETRO_SIMD_VFPV3)  strlcat(buf, " VFPv3", sizeof(buf));
    if (cpu & RETRO_SIMD_VFPV4)  strlcat(buf, " VFPv4", sizeof(buf));
@@ -758,6 +776,7 @@ uint64_t cpu_features_get(void)
    if (cpu & RETRO_SIMD_VFPU)   strlcat(buf, " VFPU", sizeof(buf));
    if (cpu & RETRO_SIMD_PS)     strlcat(buf, " PS", sizeof(buf));
    if (cpu & RETRO_SIMD_ASIMD)  strlcat(buf, " ASIMD", sizeof(buf));
+   if (cpu & RETRO_SIMD_CRC32)  strlcat(buf, " CRC32", sizeof(buf));
 
    return cpu;
 }
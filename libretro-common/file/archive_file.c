@@ -46,6 +46,11 @@
 #include <retro_miscellaneous.h>
 #include <lists/string_list.h>
 #include <string/stdstring.h>
+#include <encodings/crc32.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
 
 struct file_archive_file_data
 {
@@ -167,61 +172,6 @@ error:
 }
 #endif
 
-static int file_archive_get_file_list_cb(
-      const char *path,
-      const char *valid_exts,
-      const uint8_t *cdata,
-      unsigned cmode,
-      uint32_t csize,
-      uint32_t size,
-      uint32_t checksum,
-      struct archive_extract_userdata *userdata)
-{
-   union string_list_elem_attr attr;
-   struct string_list *ext_list = NULL;
-   const char *file_ext         = NULL;
-   size_t pathLen = strlen(path);
-
-   (void)cdata;
-   (void)cmode;
-   (void)csize;
-   (void)size;
-   (void)checksum;
-
-   memset(&attr, 0, sizeof(attr));
-
-   if (!pathLen)
-      return 0;
-
-   if (valid_exts)
-      ext_list = string_split(valid_exts, "|");
-
-   if (ext_list)
-   {
-      /* Checks if this entry is a directory or a file. */
-      char last_char = path[pathLen-1];
-
-      /* Skip if directory. */
-      if (last_char == '/' || last_char == '\\' )
-         goto error;
-
-      file_ext = path_get_extension(path);
-
-      if (!file_ext ||
-            !string_list_find_elem_prefix(ext_list, ".", file_ext))
-         goto error;
-
-      attr.i = RARCH_COMPRESSED_FILE_IN_ARCHIVE;
-      string_list_free(ext_list);
-   }
-
-   return string_list_append(userdata->list, path, attr);
-
-error:
-   string_list_free(ext_list);
-   return 0;
-}
-
 static int file_archive_extract_cb(const char *name, const char *valid_exts,
       const uint8_t *cdata,
       unsigned cmode, uint32_t csize, uint32_t size,
@@ -477,6 +427,525 @@ static bool file_archive_walk(const char *file, const char *valid_exts,
    return returnerr;
 }
 
+/* Archive indexes.
+ *
+ * Listing an archive, looking up a CRC32 or checking that a
+ * file exists in it only needs what is in the directory: the
+ * names, sizes and checksums. These are kept in memory for the
+ * last few archives used, keyed by modification time and size,
+ * so scanning a large archive entry by entry parses it once.
+ * If an index directory is set, the indexes are also saved
+ * there and survive restarts. */
+
+#define FILE_ARCHIVE_INDEX_CACHE_SIZE 4
+#define FILE_ARCHIVE_INDEX_VERSION    3
+#define FILE_ARCHIVE_INDEX_HEADER     28
+#define FILE_ARCHIVE_INDEX_ENTRY      18
+
+struct file_archive_index_entry
+{
+   char *name;
+   uint32_t csize;
+   uint32_t size;
+   uint32_t crc32;
+   uint32_t cmode;
+};
+
+struct file_archive_index
+{
+   char *path;
+   int64_t mtime;
+   int64_t size;
+   struct file_archive_index_entry *entries;
+   size_t count;
+   size_t capacity;
+   /* Entry numbers ordered by name, for lookups. */
+   size_t *sorted;
+   bool error;
+   struct file_archive_index *next;
+};
+
+/* Most recently used first. */
+static struct file_archive_index *file_archive_index_cache = NULL;
+/* Index of an archive that can not be cached, see
+ * file_archive_index_get_uncached(). */
+static struct file_archive_index *file_archive_index_uncached = NULL;
+static char file_archive_index_dir[PATH_MAX_LENGTH]       = {0};
+#ifdef HAVE_THREADS
+static slock_t *file_archive_index_lock                    = NULL;
+#endif
+
+static void file_archive_index_lock_acquire(void)
+{
+#ifdef HAVE_THREADS
+   if (!file_archive_index_lock)
+      file_archive_index_lock = slock_new();
+   if (file_archive_index_lock)
+      slock_lock(file_archive_index_lock);
+#endif
+}
+
+static void file_archive_index_lock_release(void)
+{
+#ifdef HAVE_THREADS
+   if (file_archive_index_lock)
+      slock_unlock(file_archive_index_lock);
+#endif
+}
+
+static void file_archive_index_free(struct file_archive_index *index)
+{
+   size_t i;
+
+   if (!index)
+      return;
+
+   for (i = 0; i < index->count; i++)
+      free(index->entries[i].name);
+
+   free(index->entries);
+   free(index->sorted);
+   free(index->path);
+   free(index);
+}
+
+static bool file_archive_index_add(struct file_archive_index *index,
+      const char *name, uint32_t cmode,
+      uint32_t csize, uint32_t size, uint32_t crc32)
+{
+   struct file_archive_index_entry *entry = NULL;
+
+   if (index->count == index->capacity)
+   {
+      size_t capacity = index->capacity ? index->capacity * 2 : 64;
+      struct file_archive_index_entry *entries =
+         (struct file_archive_index_entry*)realloc(index->entries,
+               capacity * sizeof(*entries));
+
+      if (!entries)
+         return false;
+
+      index->entries  = entries;
+      index->capacity = capacity;
+   }
+
+   entry         = &index->entries[index->count];
+   entry->name   = strdup(name);
+
+   if (!entry->name)
+      return false;
+
+   entry->cmode  = cmode;
+   entry->csize  = csize;
+   entry->size   = size;
+   entry->crc32  = crc32;
+
+   index->count++;
+   return true;
+}
+
+/* qsort() has no context argument. Sorting happens
+ * with the index lock held, so this is safe. */
+static const struct file_archive_index *file_archive_index_sorting = NULL;
+
+static int file_archive_index_compare(const void *a, const void *b)
+{
+   const struct file_archive_index_entry *entries =
+      file_archive_index_sorting->entries;
+   int ret = strcmp(entries[*(const size_t*)a].name,
+         entries[*(const size_t*)b].name);
+
+   if (ret)
+      return ret;
+
+   /* Keep the first of two entries with the same name first. */
+   return *(const size_t*)a < *(const size_t*)b ? -1 : 1;
+}
+
+static bool file_archive_index_sort(struct file_archive_index *index)
+{
+   size_t i;
+
+   index->sorted = (size_t*)malloc((index->count + 1) * sizeof(size_t));
+   if (!index->sorted)
+      return false;
+
+   for (i = 0; i < index->count; i++)
+      index->sorted[i] = i;
+
+   file_archive_index_sorting = index;
+   qsort(index->sorted, index->count, sizeof(size_t),
+         file_archive_index_compare);
+   file_archive_index_sorting = NULL;
+   return true;
+}
+
+static const struct file_archive_index_entry *file_archive_index_find(
+      const struct file_archive_index *index, const char *name)
+{
+   size_t low  = 0;
+   size_t high = index->count;
+
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      const struct file_archive_index_entry *entry =
+         &index->entries[index->sorted[mid]];
+      int ret    = strcmp(entry->name, name);
+
+      if (ret == 0)
+      {
+         /* Duplicates are ordered by position,
+          * return the first one like a walk would. */
+         while (mid > low && string_is_equal(
+                  index->entries[index->sorted[mid - 1]].name, name))
+            mid--;
+         return &index->entries[index->sorted[mid]];
+      }
+
+      if (ret < 0)
+         low  = mid + 1;
+      else
+         high = mid;
+   }
+
+   return NULL;
+}
+
+static void file_archive_index_put(uint8_t *data, uint64_t val, unsigned len)
+{
+   unsigned i;
+   for (i = 0; i < len; i++)
+      data[i] = (uint8_t)(val >> (i * 8));
+}
+
+static uint64_t file_archive_index_get(const uint8_t *data, unsigned len)
+{
+   unsigned i;
+   uint64_t val = 0;
+   for (i = 0; i < len; i++)
+      val |= (uint64_t)data[i] << (i * 8);
+   return val;
+}
+
+static bool file_archive_index_file_path(const char *path,
+      char *out, size_t size)
+{
+   char name[PATH_MAX_LENGTH];
+   uint32_t hash = 0;
+
+   if (!*file_archive_index_dir)
+      return false;
+
+   /* The same file name can be in several directories. */
+   hash = encoding_crc32(0, (const uint8_t*)path, strlen(path));
+   snprintf(name, sizeof(name), "%s.%08x.idx",
+         path_basename(path), (unsigned)hash);
+   fill_pathname_join(out, file_archive_index_dir, name, size);
+   return true;
+}
+
+/* Index file layout, all little endian:
+ *   "RAIX", version (4), mtime (8), size (8), count (4),
+ *   then per entry cmode, csize, size, crc32 (4 each),
+ *   name length (2) and the name. */
+static void file_archive_index_save(const struct file_archive_index *index)
+{
+   size_t i;
+   char path[PATH_MAX_LENGTH];
+   size_t len    = FILE_ARCHIVE_INDEX_HEADER;
+   uint8_t *data = NULL;
+   uint8_t *ptr  = NULL;
+
+   if (!file_archive_index_file_path(index->path, path, sizeof(path)))
+      return;
+
+   for (i = 0; i < index->count; i++)
+      len += FILE_ARCHIVE_INDEX_ENTRY + strlen(index->entries[i].name);
+
+   data = (uint8_t*)malloc(len);
+   if (!data)
+      return;
+
+   memcpy(data, "RAIX", 4);
+   file_archive_index_put(data + 4,  FILE_ARCHIVE_INDEX_VERSION, 4);
+   file_archive_index_put(data + 8,  (uint64_t)index->mtime, 8);
+   file_archive_index_put(data + 16, (uint64_t)index->size, 8);
+   file_archive_index_put(data + 24, index->count, 4);
+   ptr = data + FILE_ARCHIVE_INDEX_HEADER;
+
+   for (i = 0; i < index->count; i++)
+   {
+      const struct file_archive_index_entry *entry = &index->entries[i];
+      size_t name_len = strlen(entry->name);
+
+      file_archive_index_put(ptr + 0,  entry->cmode, 4);
+      file_archive_index_put(ptr + 4,  entry->csize, 4);
+      file_archive_index_put(ptr + 8,  entry->size, 4);
+      file_archive_index_put(ptr + 12, entry->crc32, 4);
+      file_archive_index_put(ptr + 16, name_len, 2);
+      memcpy(ptr + FILE_ARCHIVE_INDEX_ENTRY, entry->name, name_len);
+      ptr += FILE_ARCHIVE_INDEX_ENTRY + name_len;
+   }
+
+   filestream_write_file(path, data, len);
+   free(data);
+}
+
+static bool file_archive_index_load(struct file_archive_index *index)
+{
+   size_t i, count;
+   char path[PATH_MAX_LENGTH];
+   ssize_t len   = 0;
+   void *buf     = NULL;
+   uint8_t *data = NULL;
+   uint8_t *ptr  = NULL;
+   uint8_t *end  = NULL;
+
+   if (!file_archive_index_file_path(index->path, path, sizeof(path)))
+      return false;
+   if (!path_is_valid(path))
+      return false;
+   if (!filestream_read_file(path, &buf, &len))
+      return false;
+
+   data = (uint8_t*)buf;
+   end  = data + len;
+
+   if (len < FILE_ARCHIVE_INDEX_HEADER
+         || memcmp(data, "RAIX", 4)
+         || file_archive_index_get(data + 4, 4) != FILE_ARCHIVE_INDEX_VERSION
+         || (int64_t)file_archive_index_get(data + 8, 8) != index->mtime
+         || (int64_t)file_archive_index_get(data + 16, 8) != index->size)
+      goto error;
+
+   count = file_archive_index_get(data + 24, 4);
+   ptr   = data + FILE_ARCHIVE_INDEX_HEADER;
+
+   for (i = 0; i < count; i++)
+   {
+      char name[PATH_MAX_LENGTH];
+      size_t name_len;
+
+      if (end - ptr < FILE_ARCHIVE_INDEX_ENTRY)
+         goto error;
+
+      name_len = file_archive_index_get(ptr + 16, 2);
+      if (!name_len || name_len >= sizeof(name)
+            || (size_t)(end - ptr - FILE_ARCHIVE_INDEX_ENTRY) < name_len)
+         goto error;
+
+      memcpy(name, ptr + FILE_ARCHIVE_INDEX_ENTRY, name_len);
+      name[name_len] = '\0';
+
+      if (!file_archive_index_add(index, name,
+               (uint32_t)file_archive_index_get(ptr + 0,  4),
+               (uint32_t)file_archive_index_get(ptr + 4,  4),
+               (uint32_t)file_archive_index_get(ptr + 8,  4),
+               (uint32_t)file_archive_index_get(ptr + 12, 4)))
+         goto error;
+
+      ptr += FILE_ARCHIVE_INDEX_ENTRY + name_len;
+   }
+
+   free(buf);
+   return true;
+
+error:
+   for (i = 0; i < index->count; i++)
+      free(index->entries[i].name);
+   index->count = 0;
+   free(buf);
+   return false;
+}
+
+static int file_archive_index_cb(const char *name, const char *valid_exts,
+      const uint8_t *cdata, unsigned cmode, uint32_t csize, uint32_t size,
+      uint32_t checksum, struct archive_extract_userdata *userdata)
+{
+   struct file_archive_index *index = userdata->index;
+
+   /* 7z directories come through without a name. */
+   if (!*name)
+      return 1;
+
+   if (!file_archive_index_add(index, name, cmode,
+            csize, size, checksum))
+   {
+      index->error = true;
+      return 0;
+   }
+
+   return 1;
+}
+
+static bool file_archive_index_parse(struct file_archive_index *index)
+{
+   file_archive_transfer_t state            = {0};
+   struct archive_extract_userdata userdata = {{0}};
+   bool returnerr                           = true;
+
+   userdata.index = index;
+   state.type     = ARCHIVE_TRANSFER_INIT;
+
+   for (;;)
+   {
+      if (file_archive_parse_file_iterate(&state, &returnerr, index->path,
+               NULL, file_archive_index_cb, &userdata) != 0)
+         break;
+   }
+
+   /* A failed init stops the loop before the cleanup ran. */
+   if (state.type == ARCHIVE_TRANSFER_DEINIT_ERROR)
+      file_archive_parse_file_iterate(&state, &returnerr, index->path,
+            NULL, NULL, &userdata);
+
+   return returnerr && !index->error;
+}
+
+/* Without a modification time and size there is no telling whether
+ * an index is still current, so it is built for this call only. It
+ * is kept until the next one, callers only use it under the lock. */
+static const struct file_archive_index *file_archive_index_get_uncached(
+      const char *path)
+{
+   struct file_archive_index *index = NULL;
+
+   file_archive_index_free(file_archive_index_uncached);
+   file_archive_index_uncached = NULL;
+
+   index = (struct file_archive_index*)calloc(1, sizeof(*index));
+   if (!index)
+      return NULL;
+
+   index->path  = strdup(path);
+   index->mtime = -1;
+   index->size  = -1;
+
+   if (     !index->path
+         || !file_archive_index_parse(index)
+         || !file_archive_index_sort(index))
+   {
+      file_archive_index_free(index);
+      return NULL;
+   }
+
+   file_archive_index_uncached = index;
+   return index;
+}
+
+/**
+ * file_archive_index_get_locked:
+ * @path                        : filename path of archive, without
+ *                                a path inside it.
+ *
+ * Finds the index of @path in the cache, loads it from the index
+ * directory or parses the archive. Caller holds the index lock.
+ *
+ * Returns: the index on success, otherwise NULL.
+ **/
+static const struct file_archive_index *file_archive_index_get_locked(
+      const char *path)
+{
+   size_t cached                    = 0;
+   struct file_archive_index *index = NULL;
+   struct file_archive_index **prev = &file_archive_index_cache;
+   int64_t mtime                    = path_get_mtime(path);
+   int64_t size                     = path_get_size64(path);
+
+   if (mtime < 0 || size < 0)
+      return file_archive_index_get_uncached(path);
+
+   for (index = file_archive_index_cache; index; index = index->next)
+   {
+      if (string_is_equal(index->path, path))
+      {
+         *prev = index->next;
+
+         if (index->mtime == mtime && index->size == size)
+         {
+            index->next              = file_archive_index_cache;
+            file_archive_index_cache = index;
+            return index;
+         }
+
+         /* The archive changed. */
+         file_archive_index_free(index);
+         break;
+      }
+      prev = &index->next;
+   }
+
+   index = (struct file_archive_index*)calloc(1, sizeof(*index));
+   if (!index)
+      return NULL;
+
+   index->path  = strdup(path);
+   index->mtime = mtime;
+   index->size  = size;
+
+   if (!index->path)
+      goto error;
+
+   if (!file_archive_index_load(index))
+   {
+      if (!file_archive_index_parse(index))
+         goto error;
+      file_archive_index_save(index);
+   }
+
+   if (!file_archive_index_sort(index))
+      goto error;
+
+   index->next              = file_archive_index_cache;
+   file_archive_index_cache = index;
+
+   /* Drop the least recently used ones. */
+   for (prev = &file_archive_index_cache; *prev; )
+   {
+      if (++cached > FILE_ARCHIVE_INDEX_CACHE_SIZE)
+      {
+         struct file_archive_index *old = *prev;
+         *prev = old->next;
+         file_archive_index_free(old);
+      }
+      else
+         prev = &(*prev)->next;
+   }
+
+   return index;
+
+error:
+   file_archive_index_free(index);
+   return NULL;
+}
+
+/* Splits @path into the archive and the path inside it. */
+static const char *file_archive_index_split(const char *path,
+      char *archive, size_t size)
+{
+   char *delim = NULL;
+
+   strlcpy(archive, path, size);
+   delim = (char*)path_get_archive_delim(archive);
+
+   if (!delim)
+      return NULL;
+
+   *delim = '\0';
+   return path + (delim - archive) + 1;
+}
+
+void file_archive_set_index_dir(const char *dir)
+{
+   file_archive_index_lock_acquire();
+   if (dir)
+      strlcpy(file_archive_index_dir, dir, sizeof(file_archive_index_dir));
+   else
+      *file_archive_index_dir = '\0';
+   file_archive_index_lock_release();
+}
+
 int file_archive_parse_file_progress(file_archive_transfer_t *state)
 {
    /* FIXME: this estimate is worse than before */
@@ -569,7 +1038,11 @@ end:
 struct string_list *file_archive_get_file_list(const char *path,
       const char *valid_exts)
 {
-   struct archive_extract_userdata userdata = {{0}};
+   size_t i;
+   union string_list_elem_attr attr;
+   const struct file_archive_index *index = NULL;
+   struct string_list *ext_list           = NULL;
+   struct string_list *list               = NULL;
 
 #ifdef HAVE_COMPRESSION
    if (!path_is_compressed_file(path))
@@ -578,23 +1051,63 @@ struct string_list *file_archive_get_file_list(const char *path,
    return NULL;
 #endif
 
-   userdata.list_only = true;
-   strlcpy(userdata.archive_path, path, sizeof(userdata.archive_path));
+   memset(&attr, 0, sizeof(attr));
 
-   userdata.list = string_list_new();
+   if (valid_exts)
+   {
+      ext_list = string_split(valid_exts, "|");
+      attr.i   = RARCH_COMPRESSED_FILE_IN_ARCHIVE;
+   }
 
-   if (!userdata.list)
+   list = string_list_new();
+   if (!list)
       goto error;
 
-   if (!file_archive_walk(path, valid_exts,
-            file_archive_get_file_list_cb, &userdata))
+   file_archive_index_lock_acquire();
+
+   index = file_archive_index_get_locked(path);
+   if (!index)
+   {
+      file_archive_index_lock_release();
       goto error;
+   }
+
+   for (i = 0; i < index->count; i++)
+   {
+      const char *name = index->entries[i].name;
+
+      if (ext_list)
+      {
+         const char *file_ext = NULL;
+         char last_char       = name[strlen(name) - 1];
+
+         /* Skip if directory. */
+         if (last_char == '/' || last_char == '\\')
+            continue;
+
+         file_ext = path_get_extension(name);
+
+         if (!file_ext ||
+               !string_list_find_elem_prefix(ext_list, ".", file_ext))
+            continue;
+      }
+
+      if (!string_list_append(list, name, attr))
+      {
+         file_archive_index_lock_release();
+         goto error;
+      }
+   }
 
-   return userdata.list;
+   file_archive_index_lock_release();
+
+   string_list_free(ext_list);
+   return list;
 
 error:
-   if (userdata.list)
-      string_list_free(userdata.list);
+   if (list)
+      string_list_free(list);
+   string_list_free(ext_list);
    return NULL;
 }
 
@@ -686,6 +1199,38 @@ error:
    return NULL;
 }
 
+/* Whether any file in the archive at @path has @needle in its
+ * name. This is what the zip backend matches on; the 7z one wants
+ * the whole name, which passes this check as well. Lets a missing
+ * file fail without opening the archive again. */
+static bool file_archive_index_contains(const char *path,
+      const char *needle)
+{
+   size_t i;
+   bool found                             = false;
+   const struct file_archive_index *index = NULL;
+
+   file_archive_index_lock_acquire();
+
+   index = file_archive_index_get_locked(path);
+
+   /* Without an index, let the backend find out. */
+   if (!index)
+      found = true;
+   else if (file_archive_index_find(index, needle))
+      found = true;
+   else
+   {
+      for (i = 0; i < index->count && !found; i++)
+         if (strstr(index->entries[i].name, needle))
+            found = true;
+   }
+
+   file_archive_index_lock_release();
+
+   return found;
+}
+
 /* Generic compressed file loader.
  * Extracts to buf, unless optional_filename != 0
  * Then extracts to optional_filename and leaves buf alone.
@@ -722,6 +1267,10 @@ int file_archive_compressed_read(
 
    backend = file_archive_get_file_backend(str_list->elems[0].data);
 
+   if (!backend || !file_archive_index_contains(
+            str_list->elems[0].data, str_list->elems[1].data))
+      goto error;
+
    *length = backend->compressed_file_read(str_list->elems[0].data,
          str_list->elems[1].data, buf, optional_filename);
 
@@ -797,63 +1346,49 @@ const struct file_archive_file_backend* file_archive_get_file_backend(const char
  **/
 uint32_t file_archive_get_file_crc32(const char *path)
 {
-   const struct file_archive_file_backend *backend = file_archive_get_file_backend(path);
-   file_archive_transfer_t state                   = {0};
-   struct archive_extract_userdata userdata        = {{0}};
-   bool returnerr                                  = false;
-   bool contains_compressed                        = false;
-   const char *archive_path                        = NULL;
+   size_t i;
+   char archive[PATH_MAX_LENGTH];
+   uint32_t crc                           = 0;
+   const struct file_archive_index *index = NULL;
+   const char *inner                      = NULL;
 
-   if (!backend)
+   if (!file_archive_get_file_backend(path))
       return 0;
 
-   contains_compressed = path_contains_compressed_file(path);
+   inner = file_archive_index_split(path, archive, sizeof(archive));
 
-   if (contains_compressed)
-   {
-      archive_path = path_get_archive_delim(path);
-
-      /* move pointer right after the delimiter to give us the path */
-      if (archive_path)
-         archive_path += 1;
-   }
-
-   state.type = ARCHIVE_TRANSFER_INIT;
+   file_archive_index_lock_acquire();
 
-   /* Initialize and open archive first.
-      Sets next state type to ITERATE. */
-   file_archive_parse_file_iterate(&state,
-            &returnerr, path, NULL, NULL,
-            &userdata);
+   index = file_archive_index_get_locked(archive);
 
-   for (;;)
+   if (index)
    {
-      /* Now find the first file in the archive. */
-      if (state.type == ARCHIVE_TRANSFER_ITERATE)
-         file_archive_parse_file_iterate(&state,
-                  &returnerr, path, NULL, NULL,
-                  &userdata);
-
-      /* If no path specified within archive, stop after
-       * finding the first file.
-       */
-      if (!contains_compressed)
-         break;
-
-      /* Stop when the right file in the archive is found. */
-      if (archive_path)
+      if (inner && *inner)
       {
-         if (string_is_equal(userdata.extracted_file_path, archive_path))
-            break;
+         const struct file_archive_index_entry *entry =
+            file_archive_index_find(index, inner);
+
+         if (entry)
+            crc = entry->crc32;
       }
       else
-         break;
-   }
+      {
+         /* No path within the archive, use the first file. */
+         for (i = 0; i < index->count; i++)
+         {
+            const char *name = index->entries[i].name;
+            char last_char   = name[strlen(name) - 1];
 
-   file_archive_parse_file_iterate_stop(&state);
+            if (last_char != '/' && last_char != '\\')
+            {
+               crc = index->entries[i].crc32;
+               break;
+            }
+         }
+      }
+   }
 
-   if (userdata.crc)
-      return userdata.crc;
+   file_archive_index_lock_release();
 
-   return 0;
+   return crc;
 }
@@ -435,6 +435,8 @@ const struct file_archive_file_backend sevenzip_backend = {
    NULL,
    NULL,
    NULL,
+   NULL,
+   NULL,
    sevenzip_stream_crc32_calculate,
    sevenzip_file_read,
    sevenzip_parse_file_init,
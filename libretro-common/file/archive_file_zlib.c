@@ -129,6 +129,24 @@ static int zlib_stream_compress_data_to_file(void *data)
    return 0;
 }
 
+static bool zlib_stream_compress_reset(void *data)
+{
+   z_stream *stream = (z_stream*)data;
+
+   if (!stream)
+      return false;
+   return deflateReset(stream) == Z_OK;
+}
+
+static bool zlib_stream_decompress_reset(void *data)
+{
+   z_stream *stream = (z_stream*)data;
+
+   if (!stream)
+      return false;
+   return inflateReset(stream) == Z_OK;
+}
+
 static bool zlib_stream_decompress_init(void *data)
 {
    z_stream *stream = (z_stream*)data;
@@ -328,7 +346,7 @@ static int zip_file_read(
       const char *needle, void **buf,
       const char *optional_outfile)
 {
-   file_archive_transfer_t zlib;
+   file_archive_transfer_t zlib              = {0};
    bool returnerr = true;
    int ret        = 0;
    struct archive_extract_userdata userdata = {{0}};
@@ -473,6 +491,8 @@ const struct file_archive_file_backend zlib_backend = {
    zlib_stream_compress_init,
    zlib_stream_compress_free,
    zlib_stream_compress_data_to_file,
+   zlib_stream_compress_reset,
+   zlib_stream_decompress_reset,
    zlib_stream_crc32_calculate,
    zip_file_read,
    zip_parse_file_init,
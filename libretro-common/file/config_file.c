@@ -42,12 +42,19 @@
 #include <file/config_file.h>
 #include <file/file_path.h>
 #include <retro_stat.h>
-#include <lists/string_list.h>
 #include <string/stdstring.h>
 #include <rhash.h>
 
 #define MAX_INCLUDE_DEPTH 16
 
+/* Keys, values and entries are carved out of large blocks
+ * which are only released together with the config file. */
+#define CONFIG_ARENA_BLOCK_SIZE 4096
+#define CONFIG_ARENA_ALIGN      sizeof(void*)
+
+/* Initial number of slots in the key index, must be a power of two. */
+#define CONFIG_INDEX_MIN_SIZE   64
+
 struct config_entry_list
 {
    /* If we got this from an #include,
@@ -66,6 +73,14 @@ struct config_include_list
    struct config_include_list *next;
 };
 
+struct config_arena_block
+{
+   struct config_arena_block *next;
+   size_t size;
+   size_t used;
+   char *data;
+};
+
 struct config_file
 {
    char *path;
@@ -74,43 +89,197 @@ struct config_file
    unsigned include_depth;
 
    struct config_include_list *includes;
+
+   /* Open addressing index over the entry list. A key maps to
+    * the entry lookups should return for it; unset entries
+    * keep their slot with a NULL key. */
+   struct config_entry_list **index;
+   size_t index_size;
+   size_t index_used;
+
+   /* First block is the one allocations are served from. */
+   struct config_arena_block *arena;
 };
 
 static config_file_t *config_file_new_internal(
       const char *path, unsigned depth);
 
-static char *getaline(FILE *file)
+static struct config_arena_block *config_arena_block_new(size_t size)
 {
-   char* newline     = (char*)malloc(9);
-   char* newline_tmp = NULL;
-   size_t cur_size   = 8;
-   size_t idx        = 0;
-   int in            = getc(file);
+   struct config_arena_block *block = (struct config_arena_block*)
+      malloc(sizeof(*block) + size);
 
-   if (!newline)
+   if (!block)
       return NULL;
 
-   while (in != EOF && in != '\n')
+   block->next = NULL;
+   block->size = size;
+   block->used = 0;
+   block->data = (char*)(block + 1);
+   return block;
+}
+
+static void config_arena_push(config_file_t *conf,
+      struct config_arena_block *block)
+{
+   struct config_arena_block *head = conf->arena;
+
+   /* Keep allocating from whichever block has more room left. */
+   if (head && head->size - head->used > block->size - block->used)
    {
-      if (idx == cur_size)
-      {
-         cur_size *= 2;
-         newline_tmp = (char*)realloc(newline, cur_size + 1);
+      block->next = head->next;
+      head->next  = block;
+   }
+   else
+   {
+      block->next = head;
+      conf->arena = block;
+   }
+}
+
+static void *config_arena_alloc(config_file_t *conf, size_t len)
+{
+   void                        *ptr = NULL;
+   struct config_arena_block *block = conf->arena;
+
+   len = (len + CONFIG_ARENA_ALIGN - 1) & ~(CONFIG_ARENA_ALIGN - 1);
+
+   if (!block || block->size - block->used < len)
+   {
+      block = config_arena_block_new(len > CONFIG_ARENA_BLOCK_SIZE
+            ? len : CONFIG_ARENA_BLOCK_SIZE);
+      if (!block)
+         return NULL;
+      config_arena_push(conf, block);
+   }
+
+   ptr          = block->data + block->used;
+   block->used += len;
+   return ptr;
+}
+
+static char *config_arena_strdup(config_file_t *conf,
+      const char *str, size_t len)
+{
+   char *copy = (char*)config_arena_alloc(conf, len + 1);
+
+   if (!copy)
+      return NULL;
+
+   memcpy(copy, str, len);
+   copy[len] = '\0';
+   return copy;
+}
+
+/* Hands all of the child's blocks over to the parent,
+ * which is what lets entries be moved between files. */
+static void config_arena_move(config_file_t *parent, config_file_t *child)
+{
+   struct config_arena_block *tail = child->arena;
+
+   if (!tail)
+      return;
+
+   while (tail->next)
+      tail = tail->next;
+
+   if (parent->arena)
+   {
+      tail->next           = parent->arena->next;
+      parent->arena->next  = child->arena;
+   }
+   else
+      parent->arena        = child->arena;
+
+   child->arena = NULL;
+}
+
+static struct config_entry_list **config_index_slot(
+      const config_file_t *conf, const char *key, uint32_t hash)
+{
+   size_t mask = conf->index_size - 1;
+   size_t i    = hash & mask;
+
+   for (;;)
+   {
+      struct config_entry_list *entry = conf->index[i];
+
+      if (!entry || (entry->key_hash == hash
+               && entry->key && !strcmp(entry->key, key)))
+         return &conf->index[i];
+
+      i = (i + 1) & mask;
+   }
+}
 
-         if (!newline_tmp)
-         {
-            free(newline);
-            return NULL;
-         }
+static bool config_index_grow(config_file_t *conf)
+{
+   size_t i;
+   size_t old_size                      = conf->index_size;
+   struct config_entry_list **old_index = conf->index;
+   size_t new_size                      = old_size
+      ? old_size * 2 : CONFIG_INDEX_MIN_SIZE;
+   struct config_entry_list **new_index = (struct config_entry_list**)
+      calloc(new_size, sizeof(*new_index));
+
+   if (!new_index)
+      return false;
+
+   conf->index      = new_index;
+   conf->index_size = new_size;
+   conf->index_used = 0;
+
+   /* Unset entries are dropped here. */
+   for (i = 0; i < old_size; i++)
+   {
+      struct config_entry_list *entry = old_index[i];
 
-         newline = newline_tmp;
+      if (entry && entry->key)
+      {
+         *config_index_slot(conf, entry->key, entry->key_hash) = entry;
+         conf->index_used++;
       }
+   }
+
+   free(old_index);
+   return true;
+}
+
+/* If the key is already indexed, only take its place when
+ * replace is set; lookups otherwise keep returning the
+ * entry which came first. */
+static void config_index_insert(config_file_t *conf,
+      struct config_entry_list *entry, bool replace)
+{
+   struct config_entry_list **slot = NULL;
+
+   if ((conf->index_used + 1) * 4 > conf->index_size * 3)
+      if (!config_index_grow(conf))
+         return;
+
+   slot = config_index_slot(conf, entry->key, entry->key_hash);
+
+   if (!*slot)
+   {
+      *slot = entry;
+      conf->index_used++;
+   }
+   else if (replace)
+      *slot = entry;
+}
+
+static void config_index_merge(config_file_t *conf,
+      const config_file_t *from, bool replace)
+{
+   size_t i;
+
+   for (i = 0; i < from->index_size; i++)
+   {
+      struct config_entry_list *entry = from->index[i];
 
-      newline[idx++] = in;
-      in = getc(file);
+      if (entry && entry->key)
+         config_index_insert(conf, entry, replace);
    }
-   newline[idx] = '\0';
-   return newline; 
 }
 
 static char *strip_comment(char *str)
@@ -152,10 +321,10 @@ static char *strip_comment(char *str)
    return str;
 }
 
+/* Terminates the value in place and returns a pointer into line. */
 static char *extract_value(char *line, bool is_value)
 {
    char *save = NULL;
-   char *tok  = NULL;
 
    if (is_value)
    {
@@ -177,19 +346,13 @@ static char *extract_value(char *line, bool is_value)
    if (*line == '"')
    {
       line++;
-      tok = strtok_r(line, "\"", &save);
-      if (!tok)
-         return NULL;
-      return strdup(tok);
+      return strtok_r(line, "\"", &save);
    }
    else if (*line == '\0') /* Nothing */
       return NULL;
 
    /* We don't have that. Read until next space. */
-   tok = strtok_r(line, " \n\t\f\r\v", &save);
-   if (tok)
-      return strdup(tok);
-   return NULL;
+   return strtok_r(line, " \n\t\f\r\v", &save);
 }
 
 static void add_include_list(config_file_t *conf, const char *path)
@@ -225,35 +388,24 @@ static void set_list_readonly(struct config_entry_list *list)
 /* Move semantics? */
 static void add_child_list(config_file_t *parent, config_file_t *child)
 {
-   if (parent->entries)
-   {
-      struct config_entry_list *head = parent->entries;
-      while (head->next)
-         head = head->next;
+   if (!child->entries)
+      return;
 
-      set_list_readonly(child->entries);
-      head->next = child->entries;
-   }
+   set_list_readonly(child->entries);
+
+   if (parent->entries)
+      parent->tail->next = child->entries;
    else
-   {
-      set_list_readonly(child->entries);
-      parent->entries = child->entries;
-   }
+      parent->entries    = child->entries;
 
-   child->entries = NULL;
+   parent->tail = child->tail;
 
-   /* Rebase tail. */
-   if (parent->entries)
-   {
-      struct config_entry_list *head = 
-         (struct config_entry_list*)parent->entries;
+   /* Entries the parent already has keep precedence. */
+   config_index_merge(parent, child, false);
+   config_arena_move(parent, child);
 
-      while (head->next)
-         head = head->next;
-      parent->tail = head;
-   }
-   else
-      parent->tail = NULL;
+   child->entries = NULL;
+   child->tail    = NULL;
 }
 
 static void add_sub_conf(config_file_t *conf, char *line)
@@ -289,34 +441,24 @@ static void add_sub_conf(config_file_t *conf, char *line)
    sub_conf = (config_file_t*)
       config_file_new_internal(real_path, conf->include_depth + 1);
    if (!sub_conf)
-   {
-      free(path);
       return;
-   }
 
    /* Pilfer internal list. */
    add_child_list(conf, sub_conf);
    config_file_free(sub_conf);
-   free(path);
 }
 
-static bool parse_line(config_file_t *conf,
-      struct config_entry_list *list, char *line)
+/* Key and value are terminated in place, so line has to
+ * live in the config's arena. */
+static void parse_line(config_file_t *conf, char *line)
 {
-   char *comment   = NULL;
-   char *key_tmp   = NULL;
-   size_t cur_size = 8;
-   size_t idx      = 0;
-   char *key       = (char*)malloc(9);
-
-   if (!key)
-      return false;
+   char *comment                   = NULL;
+   char *key                       = NULL;
+   char *value                     = NULL;
+   struct config_entry_list *entry = NULL;
 
    if (!line || !*line)
-   {
-      free(key);
-      return false;
-   }
+      return;
 
    comment = strip_comment(line);
 
@@ -327,8 +469,7 @@ static bool parse_line(config_file_t *conf,
       if (strstr(comment, "include ") == comment)
       {
          add_sub_conf(conf, comment + strlen("include "));
-         free(key);
-         return false;
+         return;
       }
    }
    else if (conf->include_depth >= MAX_INCLUDE_DEPTH)
@@ -340,36 +481,85 @@ static bool parse_line(config_file_t *conf,
    while (isspace((int)*line))
       line++;
 
+   key = line;
    while (isgraph((int)*line))
+      line++;
+
+   /* A key which runs until the end of the line has no value. */
+   if (!*line)
+      return;
+
+   *line = '\0';
+   value = extract_value(line + 1, true);
+   if (!value)
+      return;
+
+   entry = (struct config_entry_list*)
+      config_arena_alloc(conf, sizeof(*entry));
+   if (!entry)
+      return;
+
+   entry->readonly = false;
+   entry->key      = key;
+   entry->value    = value;
+   entry->key_hash = djb2_calculate(key);
+   entry->next     = NULL;
+
+   if (conf->entries)
+      conf->tail->next = entry;
+   else
+      conf->entries    = entry;
+
+   conf->tail = entry;
+
+   config_index_insert(conf, entry, false);
+}
+
+/* Parses a NUL terminated buffer owned by the config's arena. */
+static void config_file_parse(config_file_t *conf, char *buf)
+{
+   char *line = buf;
+
+   while (line)
    {
-      if (idx == cur_size)
-      {
-         cur_size *= 2;
-         key_tmp = (char*)realloc(key, cur_size + 1);
+      char *next = strchr(line, '\n');
+      size_t len;
 
-         if (!key_tmp)
-         {
-            free(key);
-            return false;
-         }
+      if (next)
+         *next++ = '\0';
 
-         key = key_tmp;
-      }
+      len = strlen(line);
+      if (len && line[len - 1] == '\r')
+         line[len - 1] = '\0';
 
-      key[idx++] = *line++;
+      parse_line(conf, line);
+      line = next;
    }
-   key[idx] = '\0';
-   list->key = key;
-   list->key_hash = djb2_calculate(key);
+}
 
-   list->value = extract_value(line, true);
-   if (!list->value)
-   {
-      list->key = NULL;
-      free(key);
+static bool config_file_read(config_file_t *conf, FILE *file)
+{
+   long len;
+   struct config_arena_block *block = NULL;
+
+   if (fseek(file, 0, SEEK_END) != 0)
+      return false;
+
+   len = ftell(file);
+   if (len < 0 || fseek(file, 0, SEEK_SET) != 0)
+      return false;
+
+   block = config_arena_block_new((size_t)len + 1);
+   if (!block)
       return false;
-   }
 
+   /* Text mode may hand back less than ftell() promised. */
+   block->used              = fread(block->data, 1, (size_t)len, file);
+   block->data[block->used] = '\0';
+   block->size              = ++block->used;
+   config_arena_push(conf, block);
+
+   config_file_parse(conf, block->data);
    return true;
 }
 
@@ -392,49 +582,15 @@ static config_file_t *config_file_new_internal(
       goto error;
 
    conf->include_depth = depth;
-   file = fopen(path, "r");
+   file = fopen(path, "rb");
 
    if (!file)
-   {
-      free(conf->path);
       goto error;
-   }
 
-   while (!feof(file))
+   if (!config_file_read(conf, file))
    {
-      struct config_entry_list *list = (struct config_entry_list*)
-         calloc(1, sizeof(*list));
-      char *line = NULL;
-
-      if (!list)
-      {
-         config_file_free(conf);
-         fclose(file);
-         return NULL;
-      }
-
-      line = getaline(file);
-
-      if (!line)
-      {
-         free(list);
-         continue;
-      }
-
-      if (parse_line(conf, list, line))
-      {
-         if (conf->entries)
-            conf->tail->next = list;
-         else
-            conf->entries = list;
-
-         conf->tail = list;
-      }
-
-      free(line);
-
-      if (list != conf->tail)
-         free(list);
+      fclose(file);
+      goto error;
    }
 
    fclose(file);
@@ -442,7 +598,7 @@ static config_file_t *config_file_new_internal(
    return conf;
 
 error:
-   free(conf);
+   config_file_free(conf);
 
    return NULL;
 }
@@ -450,27 +606,16 @@ error:
 void config_file_free(config_file_t *conf)
 {
    struct config_include_list *inc_tmp = NULL;
-   struct config_entry_list *tmp       = NULL;
+   struct config_arena_block *block    = NULL;
    if (!conf)
       return;
 
-   tmp = conf->entries;
-   while (tmp)
+   block = conf->arena;
+   while (block)
    {
-      struct config_entry_list *hold = NULL;
-      if (tmp->key)
-         free(tmp->key);
-      if (tmp->value)
-         free(tmp->value);
-
-      tmp->value = NULL;
-      tmp->key   = NULL;
-
-      hold       = tmp;
-      tmp        = tmp->next;
-
-      if (hold)
-         free(hold);
+      struct config_arena_block *hold = block;
+      block = block->next;
+      free(hold);
    }
 
    inc_tmp = (struct config_include_list*)conf->includes;
@@ -483,6 +628,8 @@ void config_file_free(config_file_t *conf)
       free(hold);
    }
 
+   if (conf->index)
+      free(conf->index);
    if (conf->path)
       free(conf->path);
    free(conf);
@@ -497,8 +644,15 @@ bool config_append_file(config_file_t *conf, const char *path)
    if (new_conf->tail)
    {
       new_conf->tail->next = conf->entries;
+      if (!conf->entries)
+         conf->tail        = new_conf->tail;
       conf->entries        = new_conf->entries; /* Pilfer. */
       new_conf->entries    = NULL;
+      new_conf->tail       = NULL;
+
+      /* Appended entries come first, so they win lookups. */
+      config_index_merge(conf, new_conf, true);
+      config_arena_move(conf, new_conf);
    }
 
    config_file_free(new_conf);
@@ -508,8 +662,8 @@ bool config_append_file(config_file_t *conf, const char *path)
 
 config_file_t *config_file_new_from_string(const char *from_string)
 {
-   size_t i;
-   struct string_list *lines = NULL;
+   size_t len;
+   struct config_arena_block *block = NULL;
    struct config_file *conf = (struct config_file*)calloc(1, sizeof(*conf));
    if (!conf)
       return NULL;
@@ -519,42 +673,17 @@ config_file_t *config_file_new_from_string(const char *from_string)
 
    conf->path = NULL;
    conf->include_depth = 0;
-   
-   lines = string_split(from_string, "\n");
-   if (!lines)
-      return conf;
-
-   for (i = 0; i < lines->size; i++)
-   {
-      struct config_entry_list *list = (struct config_entry_list*)
-         calloc(1, sizeof(*list));
-      char* line = lines->elems[i].data;
 
-      if (!list)
-      {
-         string_list_free(lines);
-         config_file_free(conf);
-         return NULL;
-      }
-
-      if (line)
-      {
-         if (parse_line(conf, list, line))
-         {
-            if (conf->entries)
-               conf->tail->next = list;
-            else
-               conf->entries = list;
-
-            conf->tail = list;
-         }
-      }
+   len   = strlen(from_string) + 1;
+   block = config_arena_block_new(len);
+   if (!block)
+      return conf;
 
-      if (list != conf->tail)
-         free(list);
-   }
+   memcpy(block->data, from_string, len);
+   block->used = len;
+   config_arena_push(conf, block);
 
-   string_list_free(lines);
+   config_file_parse(conf, block->data);
 
    return conf;
 }
@@ -565,34 +694,18 @@ config_file_t *config_file_new(const char *path)
 }
 
 
-static struct config_entry_list *config_get_entry(const config_file_t *conf,
-      const char *key, struct config_entry_list **prev)
+static struct config_entry_list *config_get_entry(
+      const config_file_t *conf, const char *key)
 {
-   struct config_entry_list *entry;
-   struct config_entry_list *previous = NULL;
-
-   uint32_t hash = djb2_calculate(key);
-
-   if (prev)
-      previous = *prev;
-
-   for (entry = conf->entries; entry; entry = entry->next)
-   {
-      if (hash == entry->key_hash && !strcmp(key, entry->key))
-         return entry;
-
-      previous = entry;
-   }
-
-   if (prev)
-      *prev = previous;
+   if (!conf->index)
+      return NULL;
 
-   return NULL;
+   return *config_index_slot(conf, key, djb2_calculate(key));
 }
 
 bool config_get_double(config_file_t *conf, const char *key, double *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
       *in = strtod(entry->value, NULL);
@@ -602,7 +715,7 @@ bool config_get_double(config_file_t *conf, const char *key, double *in)
 
 bool config_get_float(config_file_t *conf, const char *key, float *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -615,7 +728,7 @@ bool config_get_float(config_file_t *conf, const char *key, float *in)
 
 bool config_get_int(config_file_t *conf, const char *key, int *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -632,7 +745,7 @@ bool config_get_int(config_file_t *conf, const char *key, int *in)
 #if defined(__STDC_VERSION__) && __STDC_VERSION__>=199901L
 bool config_get_uint64(config_file_t *conf, const char *key, uint64_t *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -649,7 +762,7 @@ bool config_get_uint64(config_file_t *conf, const char *key, uint64_t *in)
 
 bool config_get_uint(config_file_t *conf, const char *key, unsigned *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -665,7 +778,7 @@ bool config_get_uint(config_file_t *conf, const char *key, unsigned *in)
 
 bool config_get_hex(config_file_t *conf, const char *key, unsigned *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -681,7 +794,7 @@ bool config_get_hex(config_file_t *conf, const char *key, unsigned *in)
 
 bool config_get_char(config_file_t *conf, const char *key, char *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -696,7 +809,7 @@ bool config_get_char(config_file_t *conf, const char *key, char *in)
 
 bool config_get_string(config_file_t *conf, const char *key, char **str)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
       *str = strdup(entry->value);
@@ -715,7 +828,7 @@ bool config_get_config_path(config_file_t *conf, char *s, size_t len)
 bool config_get_array(config_file_t *conf, const char *key,
       char *buf, size_t size)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
       return strlcpy(buf, entry->value, size) < size;
@@ -729,7 +842,7 @@ bool config_get_path(config_file_t *conf, const char *key,
 #if defined(RARCH_CONSOLE)
    return config_get_array(conf, key, buf, size);
 #else
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
       fill_pathname_expand_special(buf, entry->value, size);
@@ -740,7 +853,7 @@ bool config_get_path(config_file_t *conf, const char *key,
 
 bool config_get_bool(config_file_t *conf, const char *key, bool *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -761,42 +874,75 @@ bool config_get_bool(config_file_t *conf, const char *key, bool *in)
 
 void config_set_string(config_file_t *conf, const char *key, const char *val)
 {
-   struct config_entry_list *last  = conf->entries;
-   struct config_entry_list *entry = config_get_entry(conf, key, &last);
+   size_t len;
+   char *value                     = NULL;
+   struct config_entry_list *entry = config_get_entry(conf, key);
+
+   if (!val) return;
+
+   len = strlen(val);
 
    if (entry && !entry->readonly)
    {
-      free(entry->value);
-      entry->value = strdup(val);
+      /* Old value stays in the arena, so reuse it when possible. */
+      if (len <= strlen(entry->value))
+         memcpy(entry->value, val, len + 1);
+      else if ((value = config_arena_strdup(conf, val, len)))
+         entry->value = value;
       return;
    }
 
-   if (!val) return;
-
-   entry = (struct config_entry_list*)calloc(1, sizeof(*entry));
+   entry = (struct config_entry_list*)
+      config_arena_alloc(conf, sizeof(*entry));
    if (!entry) return;
 
-   entry->key   = strdup(key);
-   entry->value = strdup(val);
+   entry->readonly = false;
+   entry->key      = config_arena_strdup(conf, key, strlen(key));
+   entry->value    = config_arena_strdup(conf, val, len);
+   entry->key_hash = djb2_calculate(key);
+   entry->next     = NULL;
 
-   if (last)
-      last->next = entry;
+   if (!entry->key || !entry->value) return;
+
+   if (conf->entries)
+      conf->tail->next = entry;
    else
-      conf->entries = entry;
+      conf->entries    = entry;
+
+   conf->tail = entry;
+
+   /* Shadows a read-only value pulled in through #include. */
+   config_index_insert(conf, entry, true);
 }
 
 void config_unset(config_file_t *conf, const char *key)
 {
-   struct config_entry_list *last  = conf->entries;
-   struct config_entry_list *entry = config_get_entry(conf, key, &last);
+   uint32_t hash                   = 0;
+   struct config_entry_list *list  = NULL;
+   struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (!entry)
       return;
 
+   /* Only the first of several entries with the same key is
+    * indexed, but the others would still be written out, and
+    * be found again once the file is read back. */
+   hash = entry->key_hash;
+
+   for (list = conf->entries; list; list = list->next)
+   {
+      if (list != entry && (list->readonly || list->key_hash != hash
+               || !list->key || strcmp(list->key, key)))
+         continue;
+
+      /* Storage belongs to the arena; a NULL key hides the entry
+       * from lookups and from config_file_dump(). */
+      list->key   = NULL;
+      list->value = NULL;
+   }
+
    entry->key   = NULL;
    entry->value = NULL;
-   free(entry->key);
-   free(entry->value);
 }
 
 void config_set_path(config_file_t *conf, const char *entry, const char *val)
@@ -925,16 +1071,7 @@ void config_file_dump(config_file_t *conf, FILE *file)
 
 bool config_entry_exists(config_file_t *conf, const char *entry)
 {
-   struct config_entry_list *list = conf->entries;
-
-   while (list)
-   {
-      if (!strcmp(entry, list->key))
-         return true;
-      list = list->next;
-   }
-
-   return false;
+   return config_get_entry(conf, entry) != NULL;
 }
 
 bool config_get_entry_list_head(config_file_t *conf,
@@ -1,3 +1,9 @@
+/* Portable nbio backend. The I/O is done on the caller's thread,
+ * one slice per nbio_iterate(). Threaded Unix builds use
+ * nbio_thread.c instead. */
+
+#if !(defined(HAVE_THREADS) && (defined(__unix__) || defined(__APPLE__)))
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -17,6 +23,8 @@ struct nbio_t
     */
    signed char op;
    signed char mode;
+   /* The last read failed, there is no data to hand out. */
+   bool read_failed;
 };
 
 static const char * modes[]={ "rb", "wb", "r+b", "rb", "wb", "r+b" };
@@ -55,6 +63,7 @@ struct nbio_t* nbio_open(const char * filename, unsigned mode)
 
    handle->progress      = handle->len;
    handle->op            = -2;
+   handle->read_failed   = false;
 
    return handle;
 
@@ -84,8 +93,9 @@ void nbio_begin_read(struct nbio_t* handle)
 
    fseek(handle->f, 0, SEEK_SET);
 
-   handle->op       = NBIO_READ;
-   handle->progress = 0;
+   handle->op          = NBIO_READ;
+   handle->progress    = 0;
+   handle->read_failed = false;
 }
 
 void nbio_begin_write(struct nbio_t* handle)
@@ -102,11 +112,13 @@ void nbio_begin_write(struct nbio_t* handle)
    fseek(handle->f, 0, SEEK_SET);
    handle->op = NBIO_WRITE;
    handle->progress = 0;
+   handle->read_failed = false;
 }
 
 bool nbio_iterate(struct nbio_t* handle)
 {
    size_t amount = 65536;
+   size_t read   = 0;
 
    if (!handle)
       return false;
@@ -120,10 +132,18 @@ bool nbio_iterate(struct nbio_t* handle)
          if (handle->mode == BIO_READ)
          {
             amount = handle->len;
-            fread((char*)handle->data, 1, amount, handle->f);
+            read   = fread((char*)handle->data, 1, amount, handle->f);
          }
          else
-            fread((char*)handle->data + handle->progress, 1, amount, handle->f);
+            read   = fread((char*)handle->data + handle->progress, 1, amount, handle->f);
+
+         if (read != amount)
+         {
+            handle->read_failed = true;
+            handle->op          = -1;
+            handle->progress    = handle->len;
+            return true;
+         }
          break;
       case NBIO_WRITE:
          if (handle->mode == BIO_WRITE)
@@ -174,7 +194,8 @@ void* nbio_get_ptr(struct nbio_t* handle, size_t* len)
       return NULL;
    if (len)
       *len = handle->len;
-   if (handle->op == -1)
+   /* A failed read leaves a buffer nobody should parse. */
+   if (handle->op == -1 && !handle->read_failed)
       return handle->data;
    return NULL;
 }
@@ -204,3 +225,5 @@ void nbio_free(struct nbio_t* handle)
    handle->data = NULL;
    free(handle);
 }
+
+#endif
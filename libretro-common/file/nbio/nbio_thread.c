@@ -0,0 +1,457 @@
+/* Copyright  (C) 2010-2016 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (nbio_thread.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* nbio backend which does the actual I/O on a small pool of
+ * threads with pread()/pwrite(), straight into the handle's
+ * buffer. nbio_iterate() only polls for completion. Files larger
+ * than one chunk are split, so several threads work on them at
+ * once. Where this is not available, nbio_stdio.c is used. */
+
+#if defined(HAVE_THREADS) && (defined(__unix__) || defined(__APPLE__))
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <file/nbio.h>
+#include <rthreads/rthreads.h>
+
+#define NBIO_THREADS    4
+#define NBIO_CHUNK_SIZE (1024 * 1024)
+
+struct nbio_t
+{
+   int fd;
+   void* data;
+   size_t len;
+   /*
+    * possible values:
+    * NBIO_READ, NBIO_WRITE - obvious
+    * -1 - currently doing nothing
+    * -2 - the pointer was reallocated since the last operation
+    */
+   signed char op;
+   signed char mode;
+   /* The last read failed, there is no data to hand out. */
+   bool read_failed;
+
+   /* Owned by the pool, protected by its lock. */
+   size_t next;
+   unsigned active;
+   bool error;
+   bool queued;
+   struct nbio_t *queue_next;
+};
+
+struct nbio_pool
+{
+   sthread_t *threads[NBIO_THREADS];
+   slock_t *lock;
+   scond_t *work_cond;
+   scond_t *done_cond;
+   struct nbio_t *head;
+   struct nbio_t *tail;
+};
+
+static const int modes[] = {
+   O_RDONLY, O_WRONLY | O_CREAT | O_TRUNC, O_RDWR,
+   O_RDONLY, O_WRONLY | O_CREAT | O_TRUNC, O_RDWR
+};
+
+/* The pool lives as long as the process does. Handles are opened
+ * from any thread, so the first nbio_open() creates it through
+ * nbio_pool_once. After that it is only read. */
+static struct nbio_pool *nbio_pool     = NULL;
+static pthread_once_t nbio_pool_once   = PTHREAD_ONCE_INIT;
+
+static bool nbio_transfer(struct nbio_t *handle, size_t offset, size_t len)
+{
+   char *ptr = (char*)handle->data + offset;
+
+   while (len)
+   {
+      ssize_t ret;
+
+      if (handle->op == NBIO_WRITE)
+         ret = pwrite(handle->fd, ptr, len, (off_t)offset);
+      else
+         ret = pread(handle->fd, ptr, len, (off_t)offset);
+
+      if (ret < 0 && errno == EINTR)
+         continue;
+      if (ret <= 0)
+         return false;
+
+      ptr    += ret;
+      offset += ret;
+      len    -= ret;
+   }
+
+   return true;
+}
+
+static bool nbio_is_done(struct nbio_t *handle)
+{
+   return handle->next == handle->len && !handle->active;
+}
+
+static void nbio_pool_unqueue(struct nbio_t *handle)
+{
+   struct nbio_t *prev = NULL;
+   struct nbio_t *cur  = nbio_pool->head;
+
+   while (cur && cur != handle)
+   {
+      prev = cur;
+      cur  = cur->queue_next;
+   }
+
+   if (!cur)
+      return;
+
+   if (prev)
+      prev->queue_next = handle->queue_next;
+   else
+      nbio_pool->head  = handle->queue_next;
+
+   if (nbio_pool->tail == handle)
+      nbio_pool->tail  = prev;
+
+   handle->queue_next = NULL;
+   handle->queued     = false;
+}
+
+static void nbio_pool_thread(void *data)
+{
+   struct nbio_pool *pool = (struct nbio_pool*)data;
+
+   slock_lock(pool->lock);
+
+   for (;;)
+   {
+      bool ok;
+      size_t offset, len;
+      struct nbio_t *handle = NULL;
+
+      while (!pool->head)
+         scond_wait(pool->work_cond, pool->lock);
+
+      /* Take the next chunk of the oldest handle, so a large
+       * file is spread over every idle thread. */
+      handle          = pool->head;
+      offset          = handle->next;
+      len             = handle->len - offset;
+      if (len > NBIO_CHUNK_SIZE)
+         len          = NBIO_CHUNK_SIZE;
+      handle->next   += len;
+      handle->active++;
+
+      if (handle->next == handle->len)
+         nbio_pool_unqueue(handle);
+
+      slock_unlock(pool->lock);
+
+      ok = nbio_transfer(handle, offset, len);
+
+      slock_lock(pool->lock);
+      if (!ok)
+         handle->error = true;
+      if (--handle->active == 0 && handle->next == handle->len)
+         scond_broadcast(pool->done_cond);
+   }
+}
+
+static void nbio_pool_create(void)
+{
+   unsigned i;
+   struct nbio_pool *pool = (struct nbio_pool*)calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return;
+
+   pool->lock      = slock_new();
+   pool->work_cond = scond_new();
+   pool->done_cond = scond_new();
+
+   if (!pool->lock || !pool->work_cond || !pool->done_cond)
+      goto error;
+
+   for (i = 0; i < NBIO_THREADS; i++)
+   {
+      pool->threads[i] = sthread_create(nbio_pool_thread, pool);
+
+      /* Threads that did start keep waiting on the pool,
+       * so it can not be torn down anymore. */
+      if (!pool->threads[i])
+         break;
+   }
+
+   if (!i)
+      goto error;
+
+   nbio_pool = pool;
+   return;
+
+error:
+   if (pool->done_cond)
+      scond_free(pool->done_cond);
+   if (pool->work_cond)
+      scond_free(pool->work_cond);
+   if (pool->lock)
+      slock_free(pool->lock);
+   free(pool);
+}
+
+static bool nbio_pool_init(void)
+{
+   pthread_once(&nbio_pool_once, nbio_pool_create);
+   return nbio_pool != NULL;
+}
+
+struct nbio_t* nbio_open(const char * filename, unsigned mode)
+{
+   struct stat st;
+   struct nbio_t* handle = NULL;
+   int fd                = -1;
+
+   if (!nbio_pool_init())
+      return NULL;
+
+   fd = open(filename, modes[mode], 0666);
+   if (fd < 0)
+      return NULL;
+
+   handle                = (struct nbio_t*)calloc(1, sizeof(struct nbio_t));
+
+   if (!handle)
+      goto error;
+
+   handle->fd            = fd;
+   handle->len           = 0;
+
+   switch (mode)
+   {
+      case NBIO_WRITE:
+      case BIO_WRITE:
+         break;
+      default:
+         if (fstat(fd, &st) != 0)
+            goto error;
+         handle->len = st.st_size;
+         break;
+   }
+
+   handle->mode          = mode;
+   handle->data          = malloc(handle->len);
+
+   if (handle->len && !handle->data)
+      goto error;
+
+   handle->next          = handle->len;
+   handle->op            = -2;
+
+   return handle;
+
+error:
+   if (handle)
+   {
+      if (handle->data)
+         free(handle->data);
+      handle->data = NULL;
+      free(handle);
+   }
+   handle = NULL;
+   close(fd);
+   return NULL;
+}
+
+static void nbio_begin(struct nbio_t* handle, signed char op)
+{
+   handle->op     = op;
+
+   slock_lock(nbio_pool->lock);
+
+   handle->next        = 0;
+   handle->active      = 0;
+   handle->error       = false;
+   handle->read_failed = false;
+
+   if (handle->len)
+   {
+      handle->queued     = true;
+      handle->queue_next = NULL;
+
+      if (nbio_pool->tail)
+         nbio_pool->tail->queue_next = handle;
+      else
+         nbio_pool->head             = handle;
+      nbio_pool->tail                = handle;
+
+      scond_broadcast(nbio_pool->work_cond);
+   }
+
+   slock_unlock(nbio_pool->lock);
+}
+
+void nbio_begin_read(struct nbio_t* handle)
+{
+   if (!handle)
+      return;
+
+   if (handle->op >= 0)
+   {
+      puts("ERROR - attempted file read operation while busy");
+      abort();
+   }
+
+   nbio_begin(handle, NBIO_READ);
+}
+
+void nbio_begin_write(struct nbio_t* handle)
+{
+   if (!handle)
+      return;
+
+   if (handle->op >= 0)
+   {
+      puts("ERROR - attempted file write operation while busy");
+      abort();
+   }
+
+   nbio_begin(handle, NBIO_WRITE);
+}
+
+bool nbio_iterate(struct nbio_t* handle)
+{
+   bool done, error;
+
+   if (!handle)
+      return false;
+
+   if (handle->op < 0)
+   {
+      handle->op = -1;
+      return true;
+   }
+
+   slock_lock(nbio_pool->lock);
+
+   /* The blocking modes finish the whole operation
+    * in one call, like nbio_stdio.c does. */
+   if (handle->mode == BIO_READ || handle->mode == BIO_WRITE)
+      while (!nbio_is_done(handle))
+         scond_wait(nbio_pool->done_cond, nbio_pool->lock);
+
+   done  = nbio_is_done(handle);
+   error = handle->error;
+
+   slock_unlock(nbio_pool->lock);
+
+   if (!done)
+      return false;
+
+   handle->read_failed = error && handle->op == NBIO_READ;
+   handle->op          = -1;
+
+   if (error && handle->mode == BIO_WRITE)
+      return false;
+   return true;
+}
+
+void nbio_resize(struct nbio_t* handle, size_t len)
+{
+   if (!handle)
+      return;
+
+   if (handle->op >= 0)
+   {
+      puts("ERROR - attempted file resize operation while busy");
+      abort();
+   }
+   if (len < handle->len)
+   {
+      puts("ERROR - attempted file shrink operation, not implemented");
+      abort();
+   }
+
+   handle->len  = len;
+   handle->data = realloc(handle->data, handle->len);
+   handle->op   = -1;
+   handle->next = handle->len;
+}
+
+void* nbio_get_ptr(struct nbio_t* handle, size_t* len)
+{
+   if (!handle)
+      return NULL;
+   if (len)
+      *len = handle->len;
+   /* A failed read leaves a buffer nobody should parse. */
+   if (handle->op == -1 && !handle->read_failed)
+      return handle->data;
+   return NULL;
+}
+
+void nbio_cancel(struct nbio_t* handle)
+{
+   if (!handle)
+      return;
+
+   if (handle->op >= 0)
+   {
+      /* Drop the chunks nobody has picked up yet and wait
+       * for the others, they still write to the buffer. */
+      slock_lock(nbio_pool->lock);
+      if (handle->queued)
+         nbio_pool_unqueue(handle);
+      handle->next = handle->len;
+      while (handle->active)
+         scond_wait(nbio_pool->done_cond, nbio_pool->lock);
+      slock_unlock(nbio_pool->lock);
+   }
+
+   handle->op = -1;
+}
+
+void nbio_free(struct nbio_t* handle)
+{
+   if (!handle)
+      return;
+   if (handle->op >= 0)
+   {
+      puts("ERROR - attempted free() while busy");
+      abort();
+   }
+   close(handle->fd);
+   free(handle->data);
+
+   handle->fd   = -1;
+   handle->data = NULL;
+   free(handle);
+}
+
+#endif
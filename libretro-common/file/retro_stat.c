@@ -176,6 +176,49 @@ int32_t path_get_size(const char *path)
    return -1;
 }
 
+int64_t path_get_mtime(const char *path)
+{
+#if defined(VITA) || defined(PSP)
+   if (!path_stat(path, IS_VALID, NULL))
+      return -1;
+   return 0;
+#elif defined(__CELLOS_LV2__)
+   CellFsStat buf;
+   if (cellFsStat(path, &buf) < 0)
+      return -1;
+   return (int64_t)buf.st_mtime;
+#elif defined(_WIN32)
+   WIN32_FILE_ATTRIBUTE_DATA file_info;
+   if (!GetFileAttributesEx(path, GetFileExInfoStandard, &file_info))
+      return -1;
+   return ((int64_t)file_info.ftLastWriteTime.dwHighDateTime << 32)
+      | file_info.ftLastWriteTime.dwLowDateTime;
+#else
+   struct stat buf;
+   if (stat(path, &buf) < 0)
+      return -1;
+   return (int64_t)buf.st_mtime;
+#endif
+}
+
+int64_t path_get_size64(const char *path)
+{
+#if defined(VITA) || defined(PSP) || defined(__CELLOS_LV2__)
+   return path_get_size(path);
+#elif defined(_WIN32)
+   WIN32_FILE_ATTRIBUTE_DATA file_info;
+   if (!GetFileAttributesEx(path, GetFileExInfoStandard, &file_info))
+      return -1;
+   return ((int64_t)file_info.nFileSizeHigh << 32)
+      | file_info.nFileSizeLow;
+#else
+   struct stat buf;
+   if (stat(path, &buf) < 0)
+      return -1;
+   return (int64_t)buf.st_size;
+#endif
+}
+
 /**
  * path_mkdir_norecurse:
  * @dir                : directory
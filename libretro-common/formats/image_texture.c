@@ -288,7 +288,7 @@ bool image_texture_load(struct texture_image *out_img,
 
    if (fmt != IMAGE_FORMAT_NONE)
    {
-      handle = (struct nbio_t*)nbio_open(path, NBIO_READ);
+      handle = (struct nbio_t*)nbio_open(path, BIO_READ);
       if (!handle)
          goto error;
       nbio_begin_read(handle);
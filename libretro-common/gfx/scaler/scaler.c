@@ -30,6 +30,53 @@
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+/* scaler_ctx_scale() runs in up to two passes over horizontal
+ * stripes. The first converts and horizontally filters input
+ * rows, the second vertically filters and converts output rows.
+ * The vertical filter reads scaled rows from anywhere in the
+ * frame, so every stripe of the first pass has to finish before
+ * the second one starts. */
+enum scaler_pass
+{
+   SCALER_PASS_DIRECT = 0,
+   SCALER_PASS_HORIZ,
+   SCALER_PASS_VERT
+};
+
+#ifdef HAVE_THREADS
+struct scaler_worker
+{
+   struct scaler_pool *pool;
+   sthread_t *thread;
+   unsigned index;
+   unsigned generation;
+};
+
+struct scaler_pool
+{
+   struct scaler_worker *workers;
+   unsigned count;
+
+   slock_t *lock;
+   scond_t *start_cond;
+   scond_t *done_cond;
+   unsigned generation;
+   unsigned pending;
+   bool quit;
+
+   /* Current pass, valid while pending != 0. */
+   struct scaler_ctx *ctx;
+   enum scaler_pass pass;
+   void *output;
+   const void *input;
+   int rows;
+};
+#endif
+
 /**
  * scaler_alloc:
  * @elem_size    : size of the elements to be used.
@@ -262,9 +309,274 @@ static bool set_pix_conv(struct scaler_ctx *ctx)
    return true;
 }
 
+static void scaler_ctx_run_pass(struct scaler_ctx *ctx,
+      enum scaler_pass pass, void *output, const void *input,
+      int first, int last)
+{
+   int rows = last - first;
+
+   if (rows <= 0)
+      return;
+
+   switch (pass)
+   {
+      case SCALER_PASS_DIRECT:
+         ctx->direct_pixconv(
+               (uint8_t*)output + first * ctx->out_stride,
+               (const uint8_t*)input + first * ctx->in_stride,
+               ctx->out_width, rows,
+               ctx->out_stride, ctx->in_stride);
+         break;
+
+      case SCALER_PASS_HORIZ:
+         {
+            const void *input_frame = input;
+            int input_stride        = ctx->in_stride;
+
+            if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+            {
+               ctx->in_pixconv(
+                     (uint8_t*)ctx->input.frame + first * ctx->input.stride,
+                     (const uint8_t*)input + first * ctx->in_stride,
+                     ctx->in_width, rows,
+                     ctx->input.stride, ctx->in_stride);
+
+               input_frame  = ctx->input.frame;
+               input_stride = ctx->input.stride;
+            }
+
+            if (!ctx->scaler_special && ctx->scaler_horiz)
+            {
+               struct scaler_ctx stripe = *ctx;
+
+               stripe.scaled.frame  += first * (ctx->scaled.stride >> 3);
+               stripe.scaled.height  = rows;
+
+               ctx->scaler_horiz(&stripe,
+                     (const uint8_t*)input_frame + first * input_stride,
+                     input_stride);
+            }
+         }
+         break;
+
+      case SCALER_PASS_VERT:
+         {
+            void *output_frame = output;
+            int output_stride  = ctx->out_stride;
+
+            if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+            {
+               output_frame  = ctx->output.frame;
+               output_stride = ctx->output.stride;
+            }
+
+            if (!ctx->scaler_special && ctx->scaler_vert)
+            {
+               struct scaler_ctx stripe = *ctx;
+
+               stripe.out_height       = rows;
+               stripe.vert.filter     += first * ctx->vert.filter_stride;
+               stripe.vert.filter_pos += first;
+
+               ctx->scaler_vert(&stripe,
+                     (uint8_t*)output_frame + first * output_stride,
+                     output_stride);
+            }
+
+            if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+               ctx->out_pixconv(
+                     (uint8_t*)output + first * ctx->out_stride,
+                     (const uint8_t*)ctx->output.frame
+                     + first * ctx->output.stride,
+                     ctx->out_width, rows,
+                     ctx->out_stride, ctx->output.stride);
+         }
+         break;
+   }
+}
+
+#ifdef HAVE_THREADS
+static void scaler_pool_run_stripe(struct scaler_pool *pool, unsigned index)
+{
+   int stripes = pool->count + 1;
+   int per     = (pool->rows + stripes - 1) / stripes;
+   int first   = per * (int)index;
+   int last    = first + per;
+
+   if (last > pool->rows)
+      last = pool->rows;
+
+   scaler_ctx_run_pass(pool->ctx, pool->pass,
+         pool->output, pool->input, first, last);
+}
+
+static void scaler_pool_thread(void *data)
+{
+   struct scaler_worker *worker = (struct scaler_worker*)data;
+   struct scaler_pool *pool     = worker->pool;
+
+   slock_lock(pool->lock);
+
+   for (;;)
+   {
+      while (worker->generation == pool->generation && !pool->quit)
+         scond_wait(pool->start_cond, pool->lock);
+
+      if (pool->quit)
+         break;
+
+      worker->generation = pool->generation;
+      slock_unlock(pool->lock);
+
+      scaler_pool_run_stripe(pool, worker->index);
+
+      slock_lock(pool->lock);
+      if (--pool->pending == 0)
+         scond_signal(pool->done_cond);
+   }
+
+   slock_unlock(pool->lock);
+}
+
+static void scaler_pool_free(struct scaler_pool *pool)
+{
+   unsigned i;
+
+   if (!pool)
+      return;
+
+   if (pool->lock)
+   {
+      slock_lock(pool->lock);
+      pool->quit = true;
+      scond_broadcast(pool->start_cond);
+      slock_unlock(pool->lock);
+   }
+
+   for (i = 0; i < pool->count; i++)
+      if (pool->workers[i].thread)
+         sthread_join(pool->workers[i].thread);
+
+   if (pool->start_cond)
+      scond_free(pool->start_cond);
+   if (pool->done_cond)
+      scond_free(pool->done_cond);
+   if (pool->lock)
+      slock_free(pool->lock);
+
+   free(pool->workers);
+   free(pool);
+}
+
+static struct scaler_pool *scaler_pool_new(unsigned threads)
+{
+   unsigned i;
+   struct scaler_pool *pool = (struct scaler_pool*)
+      calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   pool->count      = threads - 1;
+   pool->workers    = (struct scaler_worker*)
+      calloc(pool->count, sizeof(*pool->workers));
+   pool->lock       = slock_new();
+   pool->start_cond = scond_new();
+   pool->done_cond  = scond_new();
+
+   if (!pool->workers || !pool->lock || !pool->start_cond || !pool->done_cond)
+      goto error;
+
+   for (i = 0; i < pool->count; i++)
+   {
+      pool->workers[i].pool   = pool;
+      pool->workers[i].index  = i;
+      pool->workers[i].thread = sthread_create(scaler_pool_thread,
+            &pool->workers[i]);
+
+      if (!pool->workers[i].thread)
+         goto error;
+   }
+
+   return pool;
+
+error:
+   scaler_pool_free(pool);
+   return NULL;
+}
+
+/* The calling thread takes the last stripe itself. */
+static void scaler_pool_run(struct scaler_pool *pool,
+      struct scaler_ctx *ctx, enum scaler_pass pass,
+      void *output, const void *input, int rows)
+{
+   slock_lock(pool->lock);
+   pool->ctx     = ctx;
+   pool->pass    = pass;
+   pool->output  = output;
+   pool->input   = input;
+   pool->rows    = rows;
+   pool->pending = pool->count;
+   pool->generation++;
+   scond_broadcast(pool->start_cond);
+   slock_unlock(pool->lock);
+
+   scaler_pool_run_stripe(pool, pool->count);
+
+   slock_lock(pool->lock);
+   while (pool->pending)
+      scond_wait(pool->done_cond, pool->lock);
+   slock_unlock(pool->lock);
+}
+#endif
+
+static void scaler_ctx_pass(struct scaler_ctx *ctx,
+      enum scaler_pass pass, void *output, const void *input, int rows)
+{
+#ifdef HAVE_THREADS
+   if (ctx->pool && rows > (int)ctx->pool->count)
+   {
+      scaler_pool_run(ctx->pool, ctx, pass, output, input, rows);
+      return;
+   }
+#endif
+
+   scaler_ctx_run_pass(ctx, pass, output, input, 0, rows);
+}
+
+static void scaler_ctx_free_frames(struct scaler_ctx *ctx)
+{
+   scaler_free(ctx->horiz.filter);
+   scaler_free(ctx->horiz.filter_pos);
+   scaler_free(ctx->vert.filter);
+   scaler_free(ctx->vert.filter_pos);
+   scaler_free(ctx->scaled.frame);
+   scaler_free(ctx->input.frame);
+   scaler_free(ctx->output.frame);
+
+   memset(&ctx->horiz, 0, sizeof(ctx->horiz));
+   memset(&ctx->vert, 0, sizeof(ctx->vert));
+   memset(&ctx->scaled, 0, sizeof(ctx->scaled));
+   memset(&ctx->input, 0, sizeof(ctx->input));
+   memset(&ctx->output, 0, sizeof(ctx->output));
+}
+
 bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 {
-   scaler_ctx_gen_reset(ctx);
+   scaler_ctx_free_frames(ctx);
+
+#ifdef HAVE_THREADS
+   /* Keep the worker threads across filter changes unless
+    * the requested count changed. */
+   if (ctx->pool && ctx->pool->count + 1 != ctx->threads)
+   {
+      scaler_pool_free(ctx->pool);
+      ctx->pool = NULL;
+   }
+
+   if (!ctx->pool && ctx->threads > 1)
+      ctx->pool = scaler_pool_new(ctx->threads);
+#endif
 
    if (ctx->in_width == ctx->out_width && ctx->in_height == ctx->out_height)
       ctx->unscaled = true; /* Only pixel format conversion ... */
@@ -299,19 +611,12 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 {
-   scaler_free(ctx->horiz.filter);
-   scaler_free(ctx->horiz.filter_pos);
-   scaler_free(ctx->vert.filter);
-   scaler_free(ctx->vert.filter_pos);
-   scaler_free(ctx->scaled.frame);
-   scaler_free(ctx->input.frame);
-   scaler_free(ctx->output.frame);
+   scaler_ctx_free_frames(ctx);
 
-   memset(&ctx->horiz, 0, sizeof(ctx->horiz));
-   memset(&ctx->vert, 0, sizeof(ctx->vert));
-   memset(&ctx->scaled, 0, sizeof(ctx->scaled));
-   memset(&ctx->input, 0, sizeof(ctx->input));
-   memset(&ctx->output, 0, sizeof(ctx->output));
+#ifdef HAVE_THREADS
+   scaler_pool_free(ctx->pool);
+   ctx->pool = NULL;
+#endif
 }
 
 /**
@@ -325,55 +630,43 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 void scaler_ctx_scale(struct scaler_ctx *ctx,
       void *output, const void *input)
 {
-   const void *input_frame = input;
-   void *output_frame      = output;
-   int input_stride        = ctx->in_stride;
-   int output_stride       = ctx->out_stride;
-
    if (ctx->unscaled)
    {
       /* Just perform straight pixel conversion. */
-      ctx->direct_pixconv(output, input,
-            ctx->out_width, ctx->out_height,
-            ctx->out_stride, ctx->in_stride);
+      scaler_ctx_pass(ctx, SCALER_PASS_DIRECT,
+            output, input, ctx->out_height);
       return;
    }
 
-   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
-   {
-      ctx->in_pixconv(ctx->input.frame, input,
-            ctx->in_width, ctx->in_height,
-            ctx->input.stride, ctx->in_stride);
-
-      input_frame       = ctx->input.frame;
-      input_stride      = ctx->input.stride;
-   }
-
-   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
-   {
-      output_frame  = ctx->output.frame;
-      output_stride = ctx->output.stride;
-   }
+   scaler_ctx_pass(ctx, SCALER_PASS_HORIZ,
+         output, input, ctx->in_height);
 
    if (ctx->scaler_special)
    {
       /* Take some special, and (hopefully) more optimized path. */
+      const void *input_frame = input;
+      void *output_frame      = output;
+      int input_stride        = ctx->in_stride;
+      int output_stride       = ctx->out_stride;
+
+      if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+      {
+         input_frame  = ctx->input.frame;
+         input_stride = ctx->input.stride;
+      }
+
+      if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+      {
+         output_frame  = ctx->output.frame;
+         output_stride = ctx->output.stride;
+      }
+
       ctx->scaler_special(ctx, output_frame, input_frame,
             ctx->out_width, ctx->out_height,
             ctx->in_width, ctx->in_height,
             output_stride, input_stride);
    }
-   else
-   {
-      /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
-   }
 
-   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
-      ctx->out_pixconv(output, ctx->output.frame,
-            ctx->out_width, ctx->out_height,
-            ctx->out_stride, ctx->output.stride);
+   scaler_ctx_pass(ctx, SCALER_PASS_VERT,
+         output, input, ctx->out_height);
 }
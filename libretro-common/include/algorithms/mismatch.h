@@ -31,6 +31,20 @@
 
 RETRO_BEGIN_DECLS
 
+/**
+ * mismatch_init_simd:
+ * @mask              : allowed RETRO_SIMD_* features,
+ *                      usually cpu_features_get().
+ *
+ * Selects the fastest find_change()/find_same()
+ * implementation allowed by @mask. Without calling this,
+ * the best implementation known at compile time is used.
+ *
+ * Returns: the RETRO_SIMD_* flag of the selected
+ * implementation, or 0 for the plain C one.
+ **/
+uint64_t mismatch_init_simd(uint64_t mask);
+
 size_t find_change(const uint16_t *a, const uint16_t *b);
 
 size_t find_same(const uint16_t *a, const uint16_t *b);
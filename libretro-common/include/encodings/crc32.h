@@ -28,4 +28,19 @@
 
 uint32_t encoding_crc32(uint32_t crc, const uint8_t *buf, size_t len);
 
+/**
+ * encoding_crc32_init_simd:
+ * @mask              : allowed RETRO_SIMD_* features,
+ *                      usually cpu_features_get().
+ *
+ * Selects the fastest encoding_crc32() implementation allowed
+ * by @mask. Without calling this, a slice-by-8 table version
+ * (or the ARMv8 CRC32 instructions, when the compiler targets
+ * them) is used. All of them return the same checksums.
+ *
+ * Returns: the RETRO_SIMD_* flag of the selected
+ * implementation, or 0 for the table one.
+ **/
+uint64_t encoding_crc32_init_simd(uint64_t mask);
+
 #endif
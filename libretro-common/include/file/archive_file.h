@@ -54,6 +54,8 @@ typedef struct file_archive_handle
 
 typedef struct file_archive_file_data file_archive_file_data_t;
 
+struct file_archive_index;
+
 typedef struct file_archive_transfer
 {
    file_archive_file_data_t *handle;
@@ -110,6 +112,7 @@ struct archive_extract_userdata
    uint32_t crc;
    struct decomp_state_t decomp_state;
    decompress_state_t *dec;
+   struct file_archive_index *index;
 };
 
 /* Returns true when parsing should continue. False to stop. */
@@ -134,6 +137,10 @@ struct file_archive_file_backend
    void     (*stream_compress_init)(void *, int);
    void     (*stream_compress_free)(void *);
    int      (*stream_compress_data_to_file)(void *);
+   /* Prepare an initialized stream for the next buffer,
+    * cheaper than freeing and initializing it again. */
+   bool     (*stream_compress_reset)(void *);
+   bool     (*stream_decompress_reset)(void *);
    uint32_t (*stream_crc_calculate)(uint32_t, const uint8_t *, size_t);
    int (*compressed_file_read)(const char *path, const char *needle, void **buf,
          const char *optional_outfile);
@@ -210,6 +217,17 @@ const struct file_archive_file_backend* file_archive_get_file_backend(const char
  **/
 uint32_t file_archive_get_file_crc32(const char *path);
 
+/**
+ * file_archive_set_index_dir:
+ * @dir                          : directory to save archive indexes in.
+ *
+ * Archive indexes are always cached in memory for the last few
+ * archives used. If @dir is set, they are also saved there, so
+ * archives are not parsed again until they change. NULL or an
+ * empty string turns this off.
+ **/
+void file_archive_set_index_dir(const char *dir);
+
 extern const struct file_archive_file_backend zlib_backend;
 extern const struct file_archive_file_backend sevenzip_backend;
 
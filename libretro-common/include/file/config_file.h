@@ -139,7 +139,8 @@ bool config_get_config_path(config_file_t *conf, char *s, size_t len);
 bool config_get_bool(config_file_t *conf, const char *entry, bool *in);
 
 /* Setters. Similar to the getters. 
- * Will not write to entry if the entry was obtained from an #include. */
+ * Will not write to entry if the entry was obtained from an #include;
+ * a new entry which shadows it is added instead. */
 void config_set_double(config_file_t *conf, const char *entry, double value);
 void config_set_float(config_file_t *conf, const char *entry, float value);
 void config_set_int(config_file_t *conf, const char *entry, int val);
@@ -79,7 +79,8 @@ void nbio_resize(struct nbio_t* handle, size_t len);
 
 /*
  * Returns a pointer to the file data. Writable only if structure was not created with nbio_read.
- * If any operation is in progress, the pointer will be NULL, but len will still be correct.
+ * If any operation is in progress, or the last read failed, the pointer will be NULL,
+ * but len will still be correct.
  */
 void* nbio_get_ptr(struct nbio_t* handle, size_t* len);
 
@@ -23,8 +23,26 @@
 #ifndef __LIBRETRO_SDK_SCALER_PIXCONV_H__
 #define __LIBRETRO_SDK_SCALER_PIXCONV_H__
 
+#include <stdint.h>
+
 #include <clamping.h>
 
+/**
+ * conv_init_simd:
+ * @mask              : allowed RETRO_SIMD_* features,
+ *                      usually cpu_features_get().
+ *
+ * Selects the fastest implementation allowed by @mask for
+ * the per-frame conversions (RGB565/0RGB1555 to ARGB8888,
+ * RGB565 to 0RGB1555, ARGB8888 to ABGR8888 and YUYV to
+ * ARGB8888). Without calling this, the best implementation
+ * known at compile time is used.
+ *
+ * Returns: the RETRO_SIMD_* flag of the selected
+ * implementation, or 0 for the plain C one.
+ **/
+uint64_t conv_init_simd(uint64_t mask);
+
 void conv_0rgb1555_argb8888(void *output, const void *input,
       int width, int height,
       int out_stride, int in_stride);
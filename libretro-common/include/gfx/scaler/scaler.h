@@ -51,6 +51,8 @@ enum scaler_type
    SCALER_TYPE_SINC
 };
 
+struct scaler_pool;
+
 struct scaler_filter
 {
    int16_t *filter;
@@ -106,10 +108,24 @@ struct scaler_ctx
       uint32_t *frame;
       int stride;
    } output;
+
+   /* Number of threads scaler_ctx_scale() splits the frame
+    * over, including the calling thread. 0 or 1 scales on
+    * the calling thread only. Takes effect on the next
+    * scaler_ctx_gen_filter(). */
+   unsigned threads;
+   struct scaler_pool *pool;
 };
 
 bool scaler_ctx_gen_filter(struct scaler_ctx *ctx);
 
+/**
+ * scaler_ctx_gen_reset:
+ * @ctx          : pointer to scaler context object.
+ *
+ * Frees all filters, intermediate frames and worker threads
+ * owned by @ctx.
+ **/
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx);
 
 /**
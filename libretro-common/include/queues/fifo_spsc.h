@@ -0,0 +1,109 @@
+/* Copyright  (C) 2010-2016 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (fifo_spsc.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_FIFO_SPSC_H
+#define __LIBRETRO_SDK_FIFO_SPSC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Lock-free FIFO for exactly one producer thread and one
+ * consumer thread. Write-side functions may only be called by
+ * the producer, read-side functions only by the consumer.
+ *
+ * Unlike fifo_buffer_t, no external locking is needed. */
+typedef struct fifo_spsc fifo_spsc_t;
+
+/**
+ * fifo_spsc_new:
+ * @size              : capacity in bytes.
+ *
+ * The backing storage is rounded up to a power of two,
+ * but no more than @size bytes can be queued at a time.
+ *
+ * Returns: new FIFO, or NULL on allocation failure.
+ **/
+fifo_spsc_t *fifo_spsc_new(size_t size);
+
+void fifo_spsc_free(fifo_spsc_t *fifo);
+
+/* Only safe while neither side is accessing the FIFO. */
+void fifo_spsc_clear(fifo_spsc_t *fifo);
+
+size_t fifo_spsc_capacity(fifo_spsc_t *fifo);
+
+/* Producer side. */
+size_t fifo_spsc_write_avail(fifo_spsc_t *fifo);
+
+/**
+ * fifo_spsc_write:
+ *
+ * Copies up to @size bytes into the FIFO.
+ *
+ * Returns: number of bytes actually written.
+ **/
+size_t fifo_spsc_write(fifo_spsc_t *fifo, const void *in_buf, size_t size);
+
+/**
+ * fifo_spsc_write_reserve:
+ * @size              : in: wanted size, out: size of the span.
+ *
+ * Returns a contiguous writable span of at most @size bytes
+ * without copying anything. The span may be shorter than
+ * requested if it would wrap around the end of the buffer.
+ * Publish the written bytes with fifo_spsc_write_commit().
+ **/
+void *fifo_spsc_write_reserve(fifo_spsc_t *fifo, size_t *size);
+
+void fifo_spsc_write_commit(fifo_spsc_t *fifo, size_t size);
+
+/* Consumer side. */
+size_t fifo_spsc_read_avail(fifo_spsc_t *fifo);
+
+/**
+ * fifo_spsc_read:
+ *
+ * Copies up to @size bytes out of the FIFO.
+ *
+ * Returns: number of bytes actually read.
+ **/
+size_t fifo_spsc_read(fifo_spsc_t *fifo, void *out_buf, size_t size);
+
+/**
+ * fifo_spsc_read_reserve:
+ * @size              : in: wanted size, out: size of the span.
+ *
+ * Returns a contiguous readable span of at most @size bytes,
+ * see fifo_spsc_write_reserve(). Release the consumed bytes
+ * with fifo_spsc_read_commit().
+ **/
+const void *fifo_spsc_read_reserve(fifo_spsc_t *fifo, size_t *size);
+
+void fifo_spsc_read_commit(fifo_spsc_t *fifo, size_t size);
+
+RETRO_END_DECLS
+
+#endif
@@ -42,6 +42,15 @@ enum task_type
    TASK_TYPE_BLOCKING
 };
 
+/* Hint for the threaded task queue on what a task spends
+ * most of its time on. Workers prefer tasks of their own
+ * class, but will take any other task rather than idle. */
+enum task_affinity
+{
+   TASK_AFFINITY_CPU = 0,
+   TASK_AFFINITY_IO
+};
+
 enum task_queue_ctl_state
 {
    TASK_QUEUE_CTL_NONE = 0,
@@ -107,7 +116,12 @@ enum task_queue_ctl_state
    /**
     * Signals a task to end without waiting for
     * it to complete. */
-   TASK_QUEUE_CTL_CANCEL
+   TASK_QUEUE_CTL_CANCEL,
+
+   /* Sets the number of worker threads (unsigned*) used
+    * by the threaded implementation. Takes effect on the
+    * next TASK_QUEUE_CTL_INIT. */
+   TASK_QUEUE_CTL_SET_WORKER_COUNT
  };
 
 typedef struct retro_task retro_task_t;
@@ -170,6 +184,12 @@ struct retro_task
 
    enum task_type type;
 
+   enum task_affinity affinity;
+
+   /* set while a worker thread runs the handler,
+    * don't touch this. */
+   bool claimed;
+
    /* don't touch this. */
    retro_task_t *next;
 };
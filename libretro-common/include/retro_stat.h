@@ -48,6 +48,29 @@ bool path_is_valid(const char *path);
 
 int32_t path_get_size(const char *path);
 
+/**
+ * path_get_mtime:
+ * @path               : path
+ *
+ * Gets the last modification time of a file.
+ *
+ * Returns: modification time in platform-defined units,
+ * 0 if unsupported on this platform, or -1 if the path
+ * does not exist.
+ */
+int64_t path_get_mtime(const char *path);
+
+/**
+ * path_get_size64:
+ * @path               : path
+ *
+ * Like path_get_size(), but not limited to 2 GiB where
+ * the platform can tell.
+ *
+ * Returns: file size in bytes, or -1 if the path does not exist.
+ */
+int64_t path_get_size64(const char *path);
+
 /**
  * path_mkdir_norecurse:
  * @dir                : directory
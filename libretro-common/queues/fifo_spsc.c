@@ -0,0 +1,208 @@
+/* Copyright  (C) 2010-2016 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (fifo_spsc.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+#include <queues/fifo_spsc.h>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#endif
+
+/* Each index is only ever written by one side, so plain
+ * acquire loads and release stores are enough. */
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define FIFO_LOAD_ACQUIRE(ptr)       __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define FIFO_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#elif defined(__GNUC__)
+static INLINE size_t fifo_load_acquire(volatile size_t *ptr)
+{
+   size_t val = *ptr;
+   __sync_synchronize();
+   return val;
+}
+#define FIFO_LOAD_ACQUIRE(ptr)       fifo_load_acquire(ptr)
+#define FIFO_STORE_RELEASE(ptr, val) do { __sync_synchronize(); *(ptr) = (val); } while (0)
+#elif defined(_MSC_VER)
+static INLINE size_t fifo_load_acquire(volatile size_t *ptr)
+{
+   size_t val = *ptr;
+   MemoryBarrier();
+   return val;
+}
+#define FIFO_LOAD_ACQUIRE(ptr)       fifo_load_acquire(ptr)
+#define FIFO_STORE_RELEASE(ptr, val) do { MemoryBarrier(); *(ptr) = (val); } while (0)
+#else
+/* Single core targets, volatile is enough. */
+#define FIFO_LOAD_ACQUIRE(ptr)       (*(ptr))
+#define FIFO_STORE_RELEASE(ptr, val) (*(ptr) = (val))
+#endif
+
+struct fifo_spsc
+{
+   uint8_t *buffer;
+   size_t capacity;
+   /* Storage size - 1, storage size is a power of two. */
+   size_t mask;
+
+   /* Free-running byte counters. Only the producer writes
+    * 'write_pos', only the consumer writes 'read_pos'.
+    * Kept on separate cache lines to avoid false sharing. */
+   volatile size_t write_pos;
+   uint8_t pad[64 - sizeof(size_t)];
+   volatile size_t read_pos;
+};
+
+fifo_spsc_t *fifo_spsc_new(size_t size)
+{
+   size_t storage   = 1;
+   fifo_spsc_t *buf = NULL;
+
+   if (!size)
+      return NULL;
+
+   while (storage < size)
+      storage <<= 1;
+
+   buf = (fifo_spsc_t*)calloc(1, sizeof(*buf));
+   if (!buf)
+      return NULL;
+
+   buf->buffer = (uint8_t*)calloc(1, storage);
+   if (!buf->buffer)
+   {
+      free(buf);
+      return NULL;
+   }
+
+   buf->capacity = size;
+   buf->mask     = storage - 1;
+
+   return buf;
+}
+
+void fifo_spsc_free(fifo_spsc_t *fifo)
+{
+   if (!fifo)
+      return;
+
+   free(fifo->buffer);
+   free(fifo);
+}
+
+void fifo_spsc_clear(fifo_spsc_t *fifo)
+{
+   fifo->write_pos = 0;
+   fifo->read_pos  = 0;
+}
+
+size_t fifo_spsc_capacity(fifo_spsc_t *fifo)
+{
+   return fifo->capacity;
+}
+
+size_t fifo_spsc_write_avail(fifo_spsc_t *fifo)
+{
+   return fifo->capacity -
+      (fifo->write_pos - FIFO_LOAD_ACQUIRE(&fifo->read_pos));
+}
+
+size_t fifo_spsc_read_avail(fifo_spsc_t *fifo)
+{
+   return FIFO_LOAD_ACQUIRE(&fifo->write_pos) - fifo->read_pos;
+}
+
+void *fifo_spsc_write_reserve(fifo_spsc_t *fifo, size_t *size)
+{
+   size_t avail  = fifo_spsc_write_avail(fifo);
+   size_t offset = fifo->write_pos & fifo->mask;
+   size_t span   = fifo->mask + 1 - offset;
+
+   if (*size > avail)
+      *size = avail;
+   if (*size > span)
+      *size = span;
+
+   return fifo->buffer + offset;
+}
+
+void fifo_spsc_write_commit(fifo_spsc_t *fifo, size_t size)
+{
+   FIFO_STORE_RELEASE(&fifo->write_pos, fifo->write_pos + size);
+}
+
+const void *fifo_spsc_read_reserve(fifo_spsc_t *fifo, size_t *size)
+{
+   size_t avail  = fifo_spsc_read_avail(fifo);
+   size_t offset = fifo->read_pos & fifo->mask;
+   size_t span   = fifo->mask + 1 - offset;
+
+   if (*size > avail)
+      *size = avail;
+   if (*size > span)
+      *size = span;
+
+   return fifo->buffer + offset;
+}
+
+void fifo_spsc_read_commit(fifo_spsc_t *fifo, size_t size)
+{
+   FIFO_STORE_RELEASE(&fifo->read_pos, fifo->read_pos + size);
+}
+
+size_t fifo_spsc_write(fifo_spsc_t *fifo, const void *in_buf, size_t size)
+{
+   size_t avail  = fifo_spsc_write_avail(fifo);
+   size_t offset = fifo->write_pos & fifo->mask;
+   size_t first  = fifo->mask + 1 - offset;
+
+   if (size > avail)
+      size = avail;
+   if (first > size)
+      first = size;
+
+   memcpy(fifo->buffer + offset, in_buf, first);
+   memcpy(fifo->buffer, (const uint8_t*)in_buf + first, size - first);
+
+   fifo_spsc_write_commit(fifo, size);
+   return size;
+}
+
+size_t fifo_spsc_read(fifo_spsc_t *fifo, void *out_buf, size_t size)
+{
+   size_t avail  = fifo_spsc_read_avail(fifo);
+   size_t offset = fifo->read_pos & fifo->mask;
+   size_t first  = fifo->mask + 1 - offset;
+
+   if (size > avail)
+      size = avail;
+   if (first > size)
+      first = size;
+
+   memcpy(out_buf, fifo->buffer + offset, first);
+   memcpy((uint8_t*)out_buf + first, fifo->buffer, size - first);
+
+   fifo_spsc_read_commit(fifo, size);
+   return size;
+}
@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdarg.h>
 
 #include <queues/task_queue.h>
@@ -30,6 +31,8 @@
 #include <rthreads/rthreads.h>
 #endif
 
+#define TASK_QUEUE_MAX_WORKERS 8
+
 typedef struct
 {
    retro_task_t *front;
@@ -277,11 +280,15 @@ static struct retro_task_impl impl_regular = {
    retro_task_regular_deinit
 };
 
+static unsigned worker_count = 1;
+
 #ifdef HAVE_THREADS
 static slock_t *running_lock    = NULL;
 static slock_t *finished_lock   = NULL;
 static scond_t *worker_cond     = NULL;
-static sthread_t *worker_thread = NULL;
+static sthread_t *worker_threads[TASK_QUEUE_MAX_WORKERS];
+static unsigned worker_threads_count = 0;
+static unsigned tasks_claimed   = 0;    /* use running_lock when touching it */
 static bool worker_continue     = true; /* use running_lock when touching it */
 
 static void task_queue_remove(task_queue_t *queue, retro_task_t *task)
@@ -305,6 +312,9 @@ static void task_queue_remove(task_queue_t *queue, retro_task_t *task)
       {
          t->next    = task->next;
          task->next = NULL;
+
+         if (queue->back == task)
+            queue->back = t;
          break;
       }
 
@@ -363,8 +373,16 @@ static void retro_task_threaded_wait(void)
       retro_task_threaded_gather();
 
       slock_lock(running_lock);
-      wait = (tasks_running.front != NULL);
+      wait = (tasks_running.front != NULL) || tasks_claimed > 0;
       slock_unlock(running_lock);
+
+      /* A worker may have finished a task after we gathered. */
+      if (!wait)
+      {
+         slock_lock(finished_lock);
+         wait = (tasks_finished.front != NULL);
+         slock_unlock(finished_lock);
+      }
    } while (wait);
 }
 
@@ -411,9 +429,43 @@ static void retro_task_threaded_retrieve(task_retriever_data_t *data)
    slock_unlock(running_lock);
 }
 
+/* Picks the next task for a worker, running_lock must be held.
+ *
+ * Blocking tasks come first, since the user is waiting on them.
+ * Otherwise the first task of the worker's own class is taken,
+ * or if there is none, the first task of the other class. */
+static retro_task_t *task_queue_pick(enum task_affinity affinity)
+{
+   retro_task_t *task     = NULL;
+   retro_task_t *own      = NULL;
+   retro_task_t *other    = NULL;
+
+   for (task = tasks_running.front; task; task = task->next)
+   {
+      if (task->claimed)
+         continue;
+
+      if (task->type == TASK_TYPE_BLOCKING)
+         return task;
+
+      if (task->affinity == affinity)
+      {
+         if (!own)
+            own = task;
+      }
+      else if (!other)
+         other = task;
+   }
+
+   return own ? own : other;
+}
+
 static void threaded_worker(void *userdata)
 {
-   (void)userdata;
+   /* With more than one worker, every other one prefers
+    * I/O bound tasks. */
+   enum task_affinity affinity = ((uintptr_t)userdata & 1)
+      ? TASK_AFFINITY_IO : TASK_AFFINITY_CPU;
 
    for (;;)
    {
@@ -424,8 +476,8 @@ static void threaded_worker(void *userdata)
 
       slock_lock(running_lock);
 
-      /* Get first task to run */
-      task = tasks_running.front;
+      /* Get next task to run */
+      task = task_queue_pick(affinity);
       if (task == NULL)
       {
          scond_wait(worker_cond, running_lock);
@@ -433,57 +485,87 @@ static void threaded_worker(void *userdata)
          continue;
       }
 
+      task->claimed = true;
+      tasks_claimed++;
       slock_unlock(running_lock);
 
       task->handler(task);
 
       slock_lock(running_lock);
       task_queue_remove(&tasks_running, task);
-      slock_unlock(running_lock);
+      task->claimed = false;
 
       /* Update queue */
       if (!task->finished)
       {
          /* Re-add task to running queue */
-         retro_task_threaded_push_running(task);
+         task_queue_put(&tasks_running, task);
+         scond_signal(worker_cond);
+         tasks_claimed--;
+         slock_unlock(running_lock);
       }
       else
       {
+         slock_unlock(running_lock);
+
          /* Add task to finished queue */
          slock_lock(finished_lock);
          task_queue_put(&tasks_finished, task);
          slock_unlock(finished_lock);
+
+         slock_lock(running_lock);
+         tasks_claimed--;
+         slock_unlock(running_lock);
       }
    }
 }
 
 static void retro_task_threaded_init(void)
 {
+   unsigned i;
+
    running_lock  = slock_new();
    finished_lock = slock_new();
    worker_cond   = scond_new();
 
    slock_lock(running_lock);
    worker_continue = true;
+   tasks_claimed   = 0;
    slock_unlock(running_lock);
 
-   worker_thread = sthread_create(threaded_worker, NULL);
+   worker_threads_count = 0;
+
+   for (i = 0; i < worker_count; i++)
+   {
+      sthread_t *thread = sthread_create(threaded_worker, (void*)(uintptr_t)i);
+
+      if (!thread)
+         break;
+
+      worker_threads[worker_threads_count++] = thread;
+   }
 }
 
 static void retro_task_threaded_deinit(void)
 {
+   unsigned i;
+
    slock_lock(running_lock);
    worker_continue = false;
-   scond_signal(worker_cond);
+   scond_broadcast(worker_cond);
    slock_unlock(running_lock);
 
-   sthread_join(worker_thread);
+   for (i = 0; i < worker_threads_count; i++)
+   {
+      sthread_join(worker_threads[i]);
+      worker_threads[i] = NULL;
+   }
 
    scond_free(worker_cond);
    slock_free(running_lock);
    slock_free(finished_lock);
 
-   worker_thread = NULL;
+   worker_threads_count = 0;
    worker_cond   = NULL;
    running_lock  = NULL;
    finished_lock = NULL;
@@ -517,6 +599,17 @@ bool task_queue_ctl(enum task_queue_ctl_state state, void *data)
       case TASK_QUEUE_CTL_SET_THREADED:
          task_threaded_enable = true;
          break;
+      case TASK_QUEUE_CTL_SET_WORKER_COUNT:
+         {
+            unsigned *count = (unsigned*)data;
+
+            worker_count = *count;
+            if (worker_count < 1)
+               worker_count = 1;
+            if (worker_count > TASK_QUEUE_MAX_WORKERS)
+               worker_count = TASK_QUEUE_MAX_WORKERS;
+         }
+         break;
       case TASK_QUEUE_CTL_UNSET_THREADED:
          task_threaded_enable = false;
          break;
@@ -0,0 +1,182 @@
+/* Benchmarks the find_change()/find_same() implementations
+ * by running the rewind delta compressor over a pair of
+ * savestates.
+ *
+ * Usage: mismatch_bench [old.state new.state]
+ *
+ * Without arguments a synthetic 4 MB state pair with small
+ * scattered changes is used. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <algorithms/mismatch.h>
+#include <features/features_cpu.h>
+
+#define SYNTHETIC_SIZE (4 * 1024 * 1024)
+#define ITERATIONS     50
+
+/* Same layout as state_manager_raw_alloc(). */
+static uint16_t *alloc_state(size_t len, uint16_t uniq)
+{
+   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 32, 1);
+
+   if (ret)
+      ret[len16/sizeof(uint16_t) + 3] = uniq;
+   return ret;
+}
+
+static size_t read_state(const char *path, uint16_t **out, uint16_t uniq)
+{
+   long len;
+   FILE *file = fopen(path, "rb");
+
+   if (!file)
+      return 0;
+
+   fseek(file, 0, SEEK_END);
+   len = ftell(file);
+   fseek(file, 0, SEEK_SET);
+
+   *out = alloc_state(len, uniq);
+   if (!*out || fread(*out, 1, len, file) != (size_t)len)
+      len = 0;
+
+   fclose(file);
+   return len;
+}
+
+/* Mirrors state_manager_raw_compress(). */
+static size_t compress(const uint16_t *old16, const uint16_t *new16,
+      size_t len, uint16_t *compressed16)
+{
+   uint16_t *start = compressed16;
+   size_t   num16s = (len + sizeof(uint16_t) - 1) / sizeof(uint16_t);
+
+   while (num16s)
+   {
+      size_t i, changed;
+      size_t skip = find_change(old16, new16);
+
+      if (skip >= num16s)
+         break;
+
+      old16  += skip;
+      new16  += skip;
+      num16s -= skip;
+
+      if (skip > 0xffff)
+      {
+         *compressed16++ = 0;
+         *compressed16++ = skip;
+         *compressed16++ = skip >> 16;
+         continue;
+      }
+
+      changed = find_same(old16, new16);
+      if (changed > 0xffff)
+         changed = 0xffff;
+
+      *compressed16++ = changed;
+      *compressed16++ = skip;
+
+      for (i = 0; i < changed; i++)
+         compressed16[i] = old16[i];
+
+      old16        += changed;
+      new16        += changed;
+      num16s       -= changed;
+      compressed16 += changed;
+   }
+
+   compressed16[0] = 0;
+   compressed16[1] = 0;
+   compressed16[2] = 0;
+
+   return (compressed16 + 3 - start) * sizeof(uint16_t);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   size_t len, ref_size       = 0;
+   uint16_t *old_state        = NULL;
+   uint16_t *new_state        = NULL;
+   uint16_t *patch            = NULL;
+   uint16_t *ref_patch        = NULL;
+   uint64_t cpu               = cpu_features_get();
+   static const struct
+   {
+      const char *name;
+      uint64_t mask;
+   } impls[] = {
+      { "C",    0 },
+      { "SSE2", RETRO_SIMD_SSE2 },
+      { "AVX2", RETRO_SIMD_AVX2 },
+      { "NEON", RETRO_SIMD_NEON },
+   };
+
+   if (argc == 3)
+   {
+      len = read_state(argv[1], &old_state, 0);
+      if (!len || read_state(argv[2], &new_state, 1) != len)
+      {
+         fprintf(stderr, "States must exist and be the same size.\n");
+         return 1;
+      }
+   }
+   else
+   {
+      len       = SYNTHETIC_SIZE;
+      old_state = alloc_state(len, 0);
+      new_state = alloc_state(len, 1);
+
+      srand(0);
+      for (i = 0; i < len / 2; i++)
+         old_state[i] = new_state[i] = rand();
+      for (i = 0; i < len / 2; i += 1 + rand() % 512)
+         new_state[i] ^= 1 + rand() % 0xfffe;
+   }
+
+   /* Big enough for the worst case. */
+   patch     = (uint16_t*)malloc(len * 2 + 64);
+   ref_patch = (uint16_t*)malloc(len * 2 + 64);
+
+   for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++)
+   {
+      size_t size;
+      retro_time_t start, usec;
+
+      if (impls[i].mask && !(cpu & impls[i].mask))
+         continue;
+      if (mismatch_init_simd(impls[i].mask) != impls[i].mask)
+         continue;
+
+      size  = compress(old_state, new_state, len, patch);
+      start = cpu_features_get_time_usec();
+      for (j = 0; j < ITERATIONS; j++)
+         compress(old_state, new_state, len, patch);
+      usec  = cpu_features_get_time_usec() - start;
+
+      if (!ref_size)
+      {
+         ref_size = size;
+         memcpy(ref_patch, patch, size);
+      }
+
+      printf("%-5s %8.1f MB/s, %u -> %u bytes%s\n", impls[i].name,
+            (double)len * ITERATIONS / (usec ? usec : 1),
+            (unsigned)len, (unsigned)size,
+            (size == ref_size && !memcmp(patch, ref_patch, size))
+            ? "" : " (MISMATCH)");
+   }
+
+   free(old_state);
+   free(new_state);
+   free(patch);
+   free(ref_patch);
+   return 0;
+}
@@ -0,0 +1,116 @@
+/* Benchmarks the runtime-selected CRC32 implementations and
+ * checks them against a plain bytewise reference, for every
+ * length and alignment up to a few hundred bytes as well as
+ * for one large buffer fed in uneven pieces.
+ *
+ * Usage: crc32_bench [megabytes]
+ *
+ * The default buffer is 64 MB, about a CD image's data track. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+
+#define ITERATIONS 4
+
+static uint32_t crc32_reference(uint32_t crc, const uint8_t *buf, size_t len)
+{
+   unsigned i;
+
+   crc = ~crc;
+   while (len--)
+   {
+      crc ^= *buf++;
+      for (i = 0; i < 8; i++)
+         crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+   }
+   return ~crc;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   size_t size;
+   uint32_t ref;
+   int failed                 = 0;
+   uint8_t *buf               = NULL;
+   uint64_t cpu               = cpu_features_get();
+   static const struct
+   {
+      const char *name;
+      uint64_t mask;
+   } impls[] = {
+      { "C",      0 },
+      { "PCLMUL", RETRO_SIMD_PCLMUL | RETRO_SIMD_SSE4 },
+      { "CRC32",  RETRO_SIMD_CRC32 },
+   };
+
+   size = (argc == 2 ? strtoul(argv[1], NULL, 0) : 64) << 20;
+   if (!size)
+   {
+      fprintf(stderr, "Invalid buffer size.\n");
+      return 1;
+   }
+
+   buf = (uint8_t*)malloc(size);
+   if (!buf)
+      return 1;
+
+   srand(0);
+   for (i = 0; i < size; i++)
+      buf[i] = rand();
+
+   ref = crc32_reference(0, buf, size);
+
+   for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++)
+   {
+      retro_time_t start, usec;
+      size_t len, pos;
+      uint32_t crc  = 0;
+      bool exact    = true;
+      uint64_t flag = impls[i].mask & ~RETRO_SIMD_SSE4;
+
+      if (impls[i].mask && (cpu & impls[i].mask) != impls[i].mask)
+         continue;
+      if (encoding_crc32_init_simd(impls[i].mask) != flag)
+         continue;
+
+      for (len = 0; len < 300; len++)
+         for (j = 0; j < 16; j++)
+            if (encoding_crc32(len, buf + j, len)
+                  != crc32_reference(len, buf + j, len))
+               exact = false;
+
+      /* Chained calls must give the same result as one call. */
+      for (pos = 0, len = 1; pos < size; pos += len, len = len * 3 + 1)
+      {
+         if (len > size - pos)
+            len = size - pos;
+         crc = encoding_crc32(crc, buf + pos, len);
+      }
+      if (crc != ref)
+         exact = false;
+
+      start = cpu_features_get_time_usec();
+      for (j = 0; j < ITERATIONS; j++)
+         crc = encoding_crc32(0, buf, size);
+      usec  = cpu_features_get_time_usec() - start;
+
+      if (crc != ref)
+         exact = false;
+
+      printf("%-7s %8.1f MB/s%s\n", impls[i].name,
+            (double)size * ITERATIONS / (usec ? usec : 1),
+            exact ? "" : " (MISMATCH)");
+
+      if (!exact)
+         failed = 1;
+   }
+
+   free(buf);
+   return failed;
+}
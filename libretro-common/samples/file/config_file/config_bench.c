@@ -0,0 +1,111 @@
+/* Writes a config file with a few thousand keys, then times
+ * loading it and reading every key back the way
+ * config_load_file() does with retroarch.cfg.
+ *
+ * Usage: config_bench [keys]
+ *
+ * The default of 2000 keys is a little more than a full
+ * retroarch.cfg with every input bind written out. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <file/config_file.h>
+#include <features/features_cpu.h>
+
+#define ITERATIONS 20
+#define BENCH_PATH "config_bench.cfg"
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   char key[64];
+   char expected[64];
+   FILE *file            = NULL;
+   unsigned keys         = 2000;
+   unsigned found        = 0;
+   int failed            = 0;
+   retro_time_t load     = 0;
+   retro_time_t lookup   = 0;
+
+   if (argc == 2)
+      keys = strtoul(argv[1], NULL, 0);
+
+   if (!keys)
+   {
+      fprintf(stderr, "Invalid key count.\n");
+      return 1;
+   }
+
+   file = fopen(BENCH_PATH, "w");
+   if (!file)
+      return 1;
+
+   fprintf(file, "# Generated by config_bench\n");
+   for (i = 0; i < keys; i++)
+   {
+      if (i & 1)
+         fprintf(file, "bench_setting_%u = \"value %u\"\n", i, i);
+      else
+         fprintf(file, "bench_setting_%u = %u # comment\n", i, i);
+   }
+   fclose(file);
+
+   for (j = 0; j < ITERATIONS; j++)
+   {
+      retro_time_t start  = cpu_features_get_time_usec();
+      config_file_t *conf = config_file_new(BENCH_PATH);
+
+      if (!conf)
+      {
+         fprintf(stderr, "Failed to load %s.\n", BENCH_PATH);
+         return 1;
+      }
+
+      load  += cpu_features_get_time_usec() - start;
+      start  = cpu_features_get_time_usec();
+
+      for (i = 0; i < keys; i++)
+      {
+         char value[64];
+
+         snprintf(key, sizeof(key), "bench_setting_%u", i);
+         if (!config_get_array(conf, key, value, sizeof(value)))
+            continue;
+
+         found++;
+
+         if (i & 1)
+            snprintf(expected, sizeof(expected), "value %u", i);
+         else
+            snprintf(expected, sizeof(expected), "%u", i);
+
+         if (strcmp(value, expected))
+            failed = 1;
+      }
+
+      /* Keys which are not there cost a lookup too. */
+      for (i = 0; i < keys; i++)
+      {
+         snprintf(key, sizeof(key), "bench_missing_%u", i);
+         if (config_entry_exists(conf, key))
+            failed = 1;
+      }
+
+      lookup += cpu_features_get_time_usec() - start;
+      config_file_free(conf);
+   }
+
+   if (found != keys * ITERATIONS)
+      failed = 1;
+
+   printf("%u keys, %d iterations\n", keys, ITERATIONS);
+   printf("   load   %8.1f usec\n", (double)load / ITERATIONS);
+   printf("   lookup %8.1f usec (%u hits, %u misses)\n",
+         (double)lookup / ITERATIONS, keys, keys);
+   printf("%s\n", failed ? "MISMATCH" : "OK");
+
+   remove(BENCH_PATH);
+   return failed;
+}
@@ -0,0 +1,134 @@
+/* Benchmarks the runtime-selected pixel conversion kernels
+ * and checks every SIMD implementation against the plain C
+ * one, bit for bit.
+ *
+ * Usage: pixconv_bench [width height]
+ *
+ * The default frame is 1918x1080, so the row tails that the
+ * vector loops leave to the C code are exercised too. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <gfx/scaler/pixconv.h>
+#include <features/features_cpu.h>
+
+#define ITERATIONS 50
+
+typedef void (*conv_func_t)(void *output, const void *input,
+      int width, int height, int out_stride, int in_stride);
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j, k;
+   int width                  = 1918;
+   int height                 = 1080;
+   int failed                 = 0;
+   uint8_t *input             = NULL;
+   uint8_t *output            = NULL;
+   uint8_t *ref               = NULL;
+   size_t size;
+   uint64_t cpu               = cpu_features_get();
+   static const struct
+   {
+      const char *name;
+      uint64_t mask;
+   } impls[] = {
+      { "C",    0 },
+      { "SSE2", RETRO_SIMD_SSE2 },
+      { "AVX2", RETRO_SIMD_AVX2 },
+      { "NEON", RETRO_SIMD_NEON },
+   };
+   static const struct
+   {
+      const char *name;
+      conv_func_t func;
+      int in_bpp;
+      int out_bpp;
+   } kernels[] = {
+      { "rgb565_0rgb1555",   conv_rgb565_0rgb1555,   2, 2 },
+      { "0rgb1555_argb8888", conv_0rgb1555_argb8888, 2, 4 },
+      { "rgb565_argb8888",   conv_rgb565_argb8888,   2, 4 },
+      { "argb8888_abgr8888", conv_argb8888_abgr8888, 4, 4 },
+      { "yuyv_argb8888",     conv_yuyv_argb8888,     2, 4 },
+   };
+
+   if (argc == 3)
+   {
+      width  = atoi(argv[1]) & ~1;
+      height = atoi(argv[2]);
+   }
+
+   if (width <= 0 || height <= 0)
+   {
+      fprintf(stderr, "Invalid frame size.\n");
+      return 1;
+   }
+
+   /* Largest format is 4 bytes per pixel; pad each row so
+    * the strides differ from the width. */
+   size   = (size_t)(width + 16) * 4 * height;
+   input  = (uint8_t*)malloc(size);
+   output = (uint8_t*)malloc(size);
+   ref    = (uint8_t*)malloc(size);
+
+   if (!input || !output || !ref)
+      return 1;
+
+   srand(0);
+   for (i = 0; i < size; i++)
+      input[i] = rand();
+
+   for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+   {
+      int in_stride  = (width + 16) * kernels[k].in_bpp;
+      int out_stride = (width + 16) * kernels[k].out_bpp;
+
+      printf("%s\n", kernels[k].name);
+
+      for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++)
+      {
+         retro_time_t start, usec;
+         bool exact = true;
+
+         if (impls[i].mask && !(cpu & impls[i].mask))
+            continue;
+         if (conv_init_simd(impls[i].mask) != impls[i].mask)
+            continue;
+
+         memset(output, 0, size);
+         kernels[k].func(output, input, width, height,
+               out_stride, in_stride);
+
+         if (!impls[i].mask)
+            memcpy(ref, output, size);
+         else
+         {
+            for (j = 0; j < (unsigned)height; j++)
+               if (memcmp(output + j * out_stride, ref + j * out_stride,
+                        width * kernels[k].out_bpp))
+                  exact = false;
+         }
+
+         start = cpu_features_get_time_usec();
+         for (j = 0; j < ITERATIONS; j++)
+            kernels[k].func(output, input, width, height,
+                  out_stride, in_stride);
+         usec  = cpu_features_get_time_usec() - start;
+
+         printf("   %-5s %8.1f Mpix/s%s\n", impls[i].name,
+               (double)width * height * ITERATIONS / (usec ? usec : 1),
+               exact ? "" : " (MISMATCH)");
+
+         if (!exact)
+            failed = 1;
+      }
+   }
+
+   free(input);
+   free(output);
+   free(ref);
+   return failed;
+}
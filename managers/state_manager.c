@@ -21,6 +21,21 @@
 
 #include <retro_inline.h>
 #include <algorithms/mismatch.h>
+#include <features/features_cpu.h>
+
+#ifdef HAVE_ZLIB
+#include <file/archive_file.h>
+#endif
+
+#if __SSE2__
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
 
 #include "state_manager.h"
 #include "../configuration.h"
@@ -31,6 +46,7 @@
 #include "../performance_counters.h"
 #include "../verbosity.h"
 #include "../audio/audio_driver.h"
+#include "../gfx/video_driver.h"
 
 /* This makes Valgrind throw errors if a core overflows its savestate size. */
 /* Keep it off unless you're chasing a core bug, it slows things down. */
@@ -44,6 +60,24 @@
 #define UINT32_MAX 0xffffffffu
 #endif
 
+/* Number of serialized snapshots which can be in flight
+ * between the main thread and the rewind worker. */
+#define REWIND_THREAD_SLOTS 2
+
+/* Upper bound of keyframes kept alongside the delta buffer. */
+#define REWIND_MAX_KEYFRAMES 16
+
+/* Full copy of a pushed state, plus the head position right
+ * after it was pushed. Restoring one puts the state manager back
+ * into the exact state it was in after that push. */
+struct state_manager_keyframe
+{
+   uint8_t *data;
+   size_t head;
+   /* Sequence number of the entry, 0 if unused. */
+   size_t seq;
+};
+
 struct state_manager
 {
    uint8_t *data;
@@ -64,7 +98,29 @@ struct state_manager
     * (yes, the math is a bit ugly). */
    size_t maxcompsize;
 
+   /* Second compression stage (zlib level), 0 if disabled.
+    * Patches are first built in packblock, then deflated into
+    * the buffer. Popping inflates them back into packblock. */
+   int pack_level;
+   uint8_t *packblock;
+   size_t packsize;
+   /* Set up once and reset for every patch, zlib's
+    * state is too large to allocate that often. */
+   void *pack_stream;
+   void *unpack_stream;
+
    unsigned entries;
+   /* Number of entries dropped off the tail so far.
+    * entries + evicted is the sequence number of the
+    * newest entry. */
+   size_t evicted;
+
+   struct state_manager_keyframe keyframes[REWIND_MAX_KEYFRAMES];
+   unsigned num_keyframes;
+   unsigned next_keyframe;
+   /* Take a keyframe every N entries, 0 disables keyframes. */
+   unsigned keyframe_interval;
+
    bool thisblock_valid;
 #if STRICT_BUF_SIZE
    size_t debugsize;
@@ -75,6 +131,8 @@ struct state_manager
 /* Format per frame (pseudocode): */
 #if 0
 size nextstart;
+size packedsize; /* only if pack_level is set, 0 if stored as-is */
+/* if packedsize != 0, the following is zlib-compressed */
 repeat {
    uint16 numchanged; /* everything is counted in units of uint16 */
    if (numchanged)
@@ -97,11 +155,31 @@ struct state_manager_rewind_state
    /* Rewind support. */
    state_manager_t *state;
    size_t size;
+#ifdef HAVE_THREADS
+   /* Threaded capture. The main thread serializes into a free
+    * slot and queues it, the worker feeds queued slots through
+    * state_manager_push_do(). 'state' belongs to the worker while
+    * anything is queued, the main thread calls
+    * state_manager_thread_flush() before touching it. */
+   sthread_t *thread;
+   /* Guards the slot queue. */
+   slock_t *queue_lock;
+   scond_t *queue_cond;
+   uint8_t *slots[REWIND_THREAD_SLOTS];
+   unsigned queue_head;
+   unsigned queue_count;
+   bool thread_alive;
+#endif
 };
 
 static struct state_manager_rewind_state rewind_state;
 static bool frame_is_reversed;
 
+static struct retro_perf_counter gen_deltas  = {0};
+#ifdef HAVE_ZLIB
+static struct retro_perf_counter rewind_pack = {0};
+#endif
+
 /* Returns the maximum compressed size of a savestate. 
  * It is very likely to compress to far less. */
 static size_t state_manager_raw_maxsize(size_t uncomp)
@@ -123,7 +201,7 @@ static size_t state_manager_raw_maxsize(size_t uncomp)
 static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
 {
    size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
+   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 32, 1);
 
    /* Force in a different byte at the end, so we don't need to check 
     * bounds in the innermost loop (it's expensive).
@@ -132,9 +210,10 @@ static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
     * the other scan.
     *
     * There is also some padding at the end. This is so we don't 
-    * read outside the buffer end if we're reading in large blocks;
+    * read outside the buffer end if we're reading in large blocks
+    * (up to 32 bytes with AVX2);
     *
-    * It doesn't make any difference to us, but sacrificing 16 bytes to get 
+    * It doesn't make any difference to us, but sacrificing 32 bytes to get 
     * Valgrind happy is worth it. */
    ret[len16/sizeof(uint16_t) + 3] = uniq;
 
@@ -240,6 +319,28 @@ static void state_manager_raw_decompress(const void *patch,
           *
           * Our average size in here seems to be 8 or something.
           * Therefore, we do something with lower overhead. */
+#if __SSE2__
+         if (numchanged >= 8)
+         {
+            /* Copy in 16-byte steps, the last step overlaps the
+             * previous one so nothing past the run is touched. */
+            for (i = 0; i + 8 < numchanged; i += 8)
+               _mm_storeu_si128((__m128i*)(out16 + i),
+                     _mm_loadu_si128((const __m128i*)(patch16 + i)));
+            _mm_storeu_si128((__m128i*)(out16 + numchanged - 8),
+                  _mm_loadu_si128((const __m128i*)(patch16 + numchanged - 8)));
+         }
+         else
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+         if (numchanged >= 8)
+         {
+            for (i = 0; i + 8 < numchanged; i += 8)
+               vst1q_u16(out16 + i, vld1q_u16(patch16 + i));
+            vst1q_u16(out16 + numchanged - 8,
+                  vld1q_u16(patch16 + numchanged - 8));
+         }
+         else
+#endif
          for (i = 0; i < numchanged; i++)
             out16[i] = patch16[i];
 
@@ -296,10 +397,32 @@ static INLINE size_t read_size_t(const void *ptr)
 
 static void state_manager_free(state_manager_t *state)
 {
+   unsigned i;
+
    if (!state)
       return;
 
+   for (i = 0; i < state->num_keyframes; i++)
+      free(state->keyframes[i].data);
+
+#ifdef HAVE_ZLIB
+   if (state->pack_stream)
+   {
+      file_archive_get_zlib_file_backend()->stream_compress_free(
+            state->pack_stream);
+      free(state->pack_stream);
+   }
+
+   if (state->unpack_stream)
+   {
+      file_archive_get_zlib_file_backend()->stream_free(
+            state->unpack_stream);
+      free(state->unpack_stream);
+   }
+#endif
+
    free(state->data);
+   free(state->packblock);
    free(state->thisblock);
    free(state->nextblock);
 #if STRICT_BUF_SIZE
@@ -308,13 +431,38 @@ static void state_manager_free(state_manager_t *state)
    free(state);
 }
 
-static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
+static state_manager_t *state_manager_new(size_t state_size,
+      size_t buffer_size, unsigned keyframe_interval, int pack_level)
 {
    state_manager_t *state = (state_manager_t*)calloc(1, sizeof(*state));
 
    if (!state)
       return NULL;
 
+   if (keyframe_interval)
+   {
+      unsigned i;
+      /* Keyframes are paid for out of the rewind buffer, and may
+       * take at most a quarter of it. */
+      size_t num_keyframes = (buffer_size / 4) / (state_size ? state_size : 1);
+
+      if (num_keyframes > REWIND_MAX_KEYFRAMES)
+         num_keyframes = REWIND_MAX_KEYFRAMES;
+
+      for (i = 0; i < num_keyframes; i++)
+      {
+         state->keyframes[i].data = (uint8_t*)malloc(state_size);
+         if (!state->keyframes[i].data)
+            goto error;
+         state->num_keyframes++;
+      }
+
+      buffer_size -= num_keyframes * state_size;
+
+      if (state->num_keyframes)
+         state->keyframe_interval = keyframe_interval;
+   }
+
    state->blocksize   = (state_size + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
    /* the compressed data is surrounded by pointers to the other side */
    state->maxcompsize = state_manager_raw_maxsize(state_size) + sizeof(size_t) * 2;
@@ -323,6 +471,40 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
    if (!state->data)
       goto error;
 
+#ifdef HAVE_ZLIB
+   if (pack_level > 0)
+   {
+      const struct file_archive_file_backend *backend =
+         file_archive_get_zlib_file_backend();
+
+      state->packsize    = state_manager_raw_maxsize(state_size);
+      state->packblock   = (uint8_t*)malloc(state->packsize);
+
+      if (!state->packblock)
+         goto error;
+
+      state->pack_level   = pack_level > 9 ? 9 : pack_level;
+
+      state->pack_stream  = backend->stream_new();
+      if (!state->pack_stream)
+         goto error;
+      backend->stream_compress_init(state->pack_stream, state->pack_level);
+
+      state->unpack_stream = backend->stream_new();
+      if (!state->unpack_stream)
+         goto error;
+      if (!backend->stream_decompress_init(state->unpack_stream))
+      {
+         free(state->unpack_stream);
+         state->unpack_stream = NULL;
+         goto error;
+      }
+
+      /* Room for the packed size. */
+      state->maxcompsize += sizeof(size_t);
+   }
+#endif
+
    state->thisblock   = (uint8_t*)state_manager_raw_alloc(state_size, 0);
    state->nextblock   = (uint8_t*)state_manager_raw_alloc(state_size, 1);
 
@@ -347,6 +529,72 @@ error:
    return NULL;
 }
 
+#ifdef HAVE_ZLIB
+/*
+ * Deflates the 'len' bytes patch in 'state->packblock' into 'out',
+ * prefixed by its packed size. Falls back to storing the patch as-is
+ * if it doesn't get any smaller.
+ * Returns the number of bytes written to 'out'.
+ */
+static size_t state_manager_pack(state_manager_t *state,
+      size_t len, uint8_t *out)
+{
+   const struct file_archive_file_backend *backend =
+      file_archive_get_zlib_file_backend();
+   void *stream  = state->pack_stream;
+   size_t packed = 0;
+
+   performance_counter_start(&rewind_pack);
+
+   if (backend->stream_compress_reset(stream))
+   {
+      backend->stream_set(stream, (uint32_t)len, (uint32_t)len,
+            state->packblock, out + sizeof(size_t));
+
+      if (backend->stream_compress_data_to_file(stream) == 1)
+         packed = (size_t)backend->stream_get_total_out(stream);
+   }
+
+   performance_counter_stop(&rewind_pack);
+
+   if (packed && packed < len)
+   {
+      write_size_t(out, packed);
+      return sizeof(size_t) + packed;
+   }
+
+   write_size_t(out, 0);
+   memcpy(out + sizeof(size_t), state->packblock, len);
+   return sizeof(size_t) + len;
+}
+
+/*
+ * Returns the raw patch of a record written by state_manager_pack(),
+ * inflating it into 'state->packblock' if needed.
+ */
+static const uint8_t *state_manager_unpack(state_manager_t *state,
+      const uint8_t *in)
+{
+   const struct file_archive_file_backend *backend =
+      file_archive_get_zlib_file_backend();
+   size_t packed = read_size_t(in);
+   void *stream  = state->unpack_stream;
+   bool ok       = false;
+
+   if (!packed)
+      return in + sizeof(size_t);
+
+   if (backend->stream_decompress_reset(stream))
+   {
+      backend->stream_set(stream, (uint32_t)packed, (uint32_t)state->packsize,
+            in + sizeof(size_t), state->packblock);
+      ok = backend->stream_decompress_data_to_file_iterate(stream) == 1;
+   }
+
+   return ok ? state->packblock : NULL;
+}
+#endif
+
 static bool state_manager_pop(state_manager_t *state, const void **data)
 {
    size_t start;
@@ -372,6 +620,21 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
    compressed = state->data + start + sizeof(size_t);
    out = state->thisblock;
 
+#ifdef HAVE_ZLIB
+   if (state->pack_level)
+   {
+      compressed = state_manager_unpack(state, compressed);
+
+      /* Can only happen if the buffer got corrupted. */
+      if (!compressed)
+      {
+         state->head    = state->tail;
+         state->entries = 0;
+         return false;
+      }
+   }
+#endif
+
    state_manager_raw_decompress(compressed,
          state->maxcompsize, out, state->blocksize);
 
@@ -402,15 +665,37 @@ static void state_manager_push_where(state_manager_t *state, void **data)
 #endif
 }
 
+static void state_manager_push_keyframe(state_manager_t *state)
+{
+   unsigned i;
+   struct state_manager_keyframe *keyframe = NULL;
+   size_t seq = state->entries + state->evicted;
+
+   /* Anything at or past the new entry was rewound over, and the
+    * buffer behind its head has been overwritten since. */
+   for (i = 0; i < state->num_keyframes; i++)
+      if (state->keyframes[i].seq >= seq)
+         state->keyframes[i].seq = 0;
+
+   if (seq % state->keyframe_interval)
+      return;
+
+   keyframe            = &state->keyframes[state->next_keyframe];
+   state->next_keyframe = (state->next_keyframe + 1) % state->num_keyframes;
+
+   memcpy(keyframe->data, state->thisblock, state->blocksize);
+   keyframe->head      = state->head - state->data;
+   keyframe->seq       = seq;
+}
+
 static void state_manager_push_do(state_manager_t *state)
 {
+   uint8_t *swap = NULL;
+
 #if STRICT_BUF_SIZE
    memcpy(state->nextblock, state->debugblock, state->debugsize);
 #endif
 
-   static struct retro_perf_counter gen_deltas = {0};
-   uint8_t *swap = NULL;
-
    if (state->thisblock_valid)
    {
       const uint8_t *oldb, *newb;
@@ -430,16 +715,24 @@ recheckcapacity:;
       {
          state->tail = state->data + read_size_t(state->tail);
          state->entries--;
+         state->evicted++;
          goto recheckcapacity;
       }
 
-      performance_counter_init(&gen_deltas, "gen_deltas");
       performance_counter_start(&gen_deltas);
 
       oldb        = state->thisblock;
       newb        = state->nextblock;
       compressed  = state->head + sizeof(size_t);
 
+#ifdef HAVE_ZLIB
+      if (state->pack_level)
+         compressed += state_manager_pack(state,
+               state_manager_raw_compress(oldb, newb,
+                  state->blocksize, state->packblock),
+               compressed);
+      else
+#endif
       compressed += state_manager_raw_compress(oldb, newb,
             state->blocksize, compressed);
 
@@ -447,7 +740,11 @@ recheckcapacity:;
       {
          compressed = state->data;
          if (state->tail == state->data + sizeof(size_t))
+         {
             state->tail = state->data + read_size_t(state->tail);
+            state->entries--;
+            state->evicted++;
+         }
       }
       write_size_t(compressed, state->head-state->data);
       compressed += sizeof(size_t);
@@ -464,9 +761,71 @@ recheckcapacity:;
    state->nextblock = swap;
 
    state->entries++;
+
+   if (state->keyframe_interval)
+      state_manager_push_keyframe(state);
 }
 
-#if 0
+/*
+ * Equivalent to calling state_manager_pop() 'count' times, but
+ * restarts from the nearest usable keyframe if that needs fewer
+ * delta applications than walking back from the current head.
+ */
+static bool state_manager_seek(state_manager_t *state,
+      unsigned count, const void **data)
+{
+   unsigned i;
+   size_t pops;
+   size_t seq    = state->entries + state->evicted;
+   size_t target = 0;
+   struct state_manager_keyframe *best = NULL;
+
+   *data = NULL;
+
+   if (!count || !state->entries)
+      return false;
+
+   /* Clamp to the oldest entry still in the buffer. */
+   if (count > state->entries)
+      count = state->entries;
+
+   target = seq - count + 1;
+   pops   = count;
+
+   for (i = 0; i < state->num_keyframes; i++)
+   {
+      struct state_manager_keyframe *keyframe = &state->keyframes[i];
+
+      if (!keyframe->seq || keyframe->seq > seq || keyframe->seq < target
+            || keyframe->seq <= state->evicted)
+         continue;
+
+      if (keyframe->seq - target + 1 < pops)
+      {
+         best = keyframe;
+         pops = keyframe->seq - target + 1;
+      }
+   }
+
+   if (best)
+   {
+      memcpy(state->thisblock, best->data, state->blocksize);
+      state->head            = state->data + best->head;
+      state->entries         = best->seq - state->evicted;
+      state->thisblock_valid = true;
+   }
+
+   while (pops--)
+   {
+      if (!state_manager_pop(state, data))
+         return false;
+   }
+
+   return true;
+}
+
+/* Number of entries actually in the history and the number of
+ * bytes they take up, after all compression stages. */
 static void state_manager_capacity(state_manager_t *state,
       unsigned *entries, size_t *bytes, bool *full)
 {
@@ -478,10 +837,158 @@ static void state_manager_capacity(state_manager_t *state,
    if (entries)
       *entries = state->entries;
    if (bytes)
-      *bytes = state->capacity-remaining;
+      *bytes = state->capacity - remaining;
    if (full)
       *full = remaining <= state->maxcompsize * 2;
 }
+
+#ifdef HAVE_THREADS
+static void state_manager_thread_loop(void *data)
+{
+   struct state_manager_rewind_state *rewind =
+      (struct state_manager_rewind_state*)data;
+
+   for (;;)
+   {
+      void *dst = NULL;
+      const uint8_t *src = NULL;
+
+      slock_lock(rewind->queue_lock);
+      while (rewind->thread_alive && !rewind->queue_count)
+         scond_wait(rewind->queue_cond, rewind->queue_lock);
+
+      if (!rewind->queue_count)
+      {
+         slock_unlock(rewind->queue_lock);
+         break;
+      }
+
+      src = rewind->slots[rewind->queue_head];
+      slock_unlock(rewind->queue_lock);
+
+      state_manager_push_where(rewind->state, &dst);
+      memcpy(dst, src, rewind->size);
+      state_manager_push_do(rewind->state);
+
+      slock_lock(rewind->queue_lock);
+      rewind->queue_head = (rewind->queue_head + 1) % REWIND_THREAD_SLOTS;
+      rewind->queue_count--;
+      scond_broadcast(rewind->queue_cond);
+      slock_unlock(rewind->queue_lock);
+   }
+}
+
+/* Blocks until the worker has compressed every queued snapshot. */
+static void state_manager_thread_flush(void)
+{
+   if (!rewind_state.thread)
+      return;
+
+   slock_lock(rewind_state.queue_lock);
+   while (rewind_state.queue_count)
+      scond_wait(rewind_state.queue_cond, rewind_state.queue_lock);
+   slock_unlock(rewind_state.queue_lock);
+}
+
+static void state_manager_thread_deinit(void)
+{
+   unsigned i;
+
+   if (rewind_state.thread)
+   {
+      slock_lock(rewind_state.queue_lock);
+      rewind_state.thread_alive = false;
+      scond_broadcast(rewind_state.queue_cond);
+      slock_unlock(rewind_state.queue_lock);
+
+      sthread_join(rewind_state.thread);
+   }
+
+   if (rewind_state.queue_cond)
+      scond_free(rewind_state.queue_cond);
+   if (rewind_state.queue_lock)
+      slock_free(rewind_state.queue_lock);
+
+   for (i = 0; i < REWIND_THREAD_SLOTS; i++)
+   {
+      free(rewind_state.slots[i]);
+      rewind_state.slots[i] = NULL;
+   }
+
+   rewind_state.thread       = NULL;
+   rewind_state.queue_cond   = NULL;
+   rewind_state.queue_lock   = NULL;
+   rewind_state.queue_head   = 0;
+   rewind_state.queue_count  = 0;
+   rewind_state.thread_alive = false;
+}
+
+static bool state_manager_thread_init(void)
+{
+   unsigned i;
+
+   for (i = 0; i < REWIND_THREAD_SLOTS; i++)
+   {
+      rewind_state.slots[i] = (uint8_t*)malloc(rewind_state.size);
+      if (!rewind_state.slots[i])
+         goto error;
+   }
+
+   rewind_state.queue_lock   = slock_new();
+   rewind_state.queue_cond   = scond_new();
+
+   if (!rewind_state.queue_lock || !rewind_state.queue_cond)
+      goto error;
+
+   rewind_state.thread_alive = true;
+   rewind_state.thread       = sthread_create(
+         state_manager_thread_loop, &rewind_state);
+
+   if (!rewind_state.thread)
+      goto error;
+
+   return true;
+
+error:
+   state_manager_thread_deinit();
+   return false;
+}
+
+/* Serializes the core into a free slot and hands it to the worker.
+ * Only blocks if the worker is still busy with all previous slots. */
+static void state_manager_thread_push(void)
+{
+   retro_ctx_serialize_info_t serial_info;
+   static struct retro_perf_counter rewind_queue_wait  = {0};
+   static struct retro_perf_counter rewind_queue_depth = {0};
+   unsigned slot;
+
+   performance_counter_init(&rewind_queue_wait,  "rewind_queue_wait");
+   performance_counter_init(&rewind_queue_depth, "rewind_queue_depth");
+
+   performance_counter_start(&rewind_queue_wait);
+
+   slock_lock(rewind_state.queue_lock);
+   performance_counter_sample(&rewind_queue_depth, rewind_state.queue_count);
+   while (rewind_state.queue_count == REWIND_THREAD_SLOTS)
+      scond_wait(rewind_state.queue_cond, rewind_state.queue_lock);
+   slot = (rewind_state.queue_head + rewind_state.queue_count)
+      % REWIND_THREAD_SLOTS;
+   slock_unlock(rewind_state.queue_lock);
+
+   performance_counter_stop(&rewind_queue_wait);
+
+   /* The slot is not queued yet, so the worker won't touch it. */
+   serial_info.data = rewind_state.slots[slot];
+   serial_info.size = rewind_state.size;
+
+   core_serialize(&serial_info);
+
+   slock_lock(rewind_state.queue_lock);
+   rewind_state.queue_count++;
+   scond_broadcast(rewind_state.queue_cond);
+   slock_unlock(rewind_state.queue_lock);
+}
 #endif
 
 void state_manager_event_init(void)
@@ -504,6 +1011,8 @@ void state_manager_event_init(void)
 
    rewind_state.size = info.size;
 
+   mismatch_init_simd(cpu_features_get());
+
    if (!rewind_state.size)
    {
       RARCH_ERR("%s.\n",
@@ -516,10 +1025,21 @@ void state_manager_event_init(void)
          (unsigned)(settings->rewind_buffer_size / 1000000));
 
    rewind_state.state = state_manager_new(rewind_state.size,
-         settings->rewind_buffer_size);
+         settings->rewind_buffer_size,
+         settings->rewind_keyframe_interval,
+         settings->rewind_compression_level);
 
    if (!rewind_state.state)
+   {
       RARCH_WARN("%s.\n", msg_hash_to_str(MSG_REWIND_INIT_FAILED));
+      return;
+   }
+
+   /* Register from the main thread, the worker only starts/stops them. */
+   performance_counter_init(&gen_deltas, "gen_deltas");
+#ifdef HAVE_ZLIB
+   performance_counter_init(&rewind_pack, "rewind_pack");
+#endif
 
    state_manager_push_where(rewind_state.state, &state);
 
@@ -529,6 +1049,16 @@ void state_manager_event_init(void)
    core_serialize(&serial_info);
 
    state_manager_push_do(rewind_state.state);
+
+#ifdef HAVE_THREADS
+   if (settings->rewind_threaded)
+   {
+      if (state_manager_thread_init())
+         RARCH_LOG("Rewind: Compressing states on a worker thread.\n");
+      else
+         RARCH_WARN("Rewind: Failed to start worker thread, compressing synchronously.\n");
+   }
+#endif
 }
 
 
@@ -544,12 +1074,93 @@ static void state_manager_set_frame_is_reversed(bool value)
 
 void state_manager_event_deinit(void)
 {
+#ifdef HAVE_THREADS
+   state_manager_thread_deinit();
+#endif
+
+   if (rewind_state.state)
+   {
+      unsigned entries;
+      size_t bytes;
+      bool full;
+      struct retro_system_av_info *av_info =
+         video_viewport_get_system_av_info();
+      settings_t *settings = config_get_ptr();
+      unsigned granularity = settings->rewind_granularity ?
+         settings->rewind_granularity : 1;
+
+      state_manager_capacity(rewind_state.state, &entries, &bytes, &full);
+
+      RARCH_LOG("Rewind: %u states in %u KB%s (%.1f seconds).\n",
+            entries, (unsigned)(bytes / 1024), full ? ", full" : "",
+            (av_info && av_info->timing.fps > 0.0)
+            ? entries * granularity / av_info->timing.fps : 0.0);
+   }
+
    if (rewind_state.state)
       state_manager_free(rewind_state.state);
    rewind_state.state = NULL;
    rewind_state.size  = 0;
 }
 
+/**
+ * state_manager_seek_back:
+ * @frames              : number of frames to go back.
+ *
+ * Jumps back @frames emulated frames in the rewind history
+ * in one go, restarting from a keyframe where possible.
+ *
+ * Returns: true if a state was loaded, otherwise false.
+ **/
+bool state_manager_seek_back(unsigned frames)
+{
+   retro_ctx_serialize_info_t serial_info;
+   unsigned i, count;
+   const void *buf      = NULL;
+   settings_t *settings = config_get_ptr();
+   unsigned granularity = settings->rewind_granularity ?
+      settings->rewind_granularity : 1;
+
+   if (!rewind_state.state || !frames)
+      return false;
+
+   if (bsv_movie_ctl(BSV_MOVIE_CTL_IS_INITED, NULL))
+      granularity = 1;
+
+   count = (frames + granularity - 1) / granularity;
+
+#ifdef HAVE_THREADS
+   state_manager_thread_flush();
+#endif
+
+   if (!state_manager_seek(rewind_state.state, count, &buf))
+   {
+      runloop_msg_queue_push(
+            msg_hash_to_str(MSG_REWIND_REACHED_END),
+            0, 30, true);
+      return false;
+   }
+
+   /* Same as a single step back in state_manager_check_rewind(),
+    * the audio of the last frame is played back reversed. */
+   state_manager_set_frame_is_reversed(true);
+
+   audio_driver_setup_rewind();
+
+   runloop_msg_queue_push(msg_hash_to_str(MSG_REWINDING), 0, 30, true);
+
+   serial_info.data_const = buf;
+   serial_info.size       = rewind_state.size;
+
+   core_unserialize(&serial_info);
+
+   if (bsv_movie_ctl(BSV_MOVIE_CTL_IS_INITED, NULL))
+      for (i = 0; i < count; i++)
+         bsv_movie_ctl(BSV_MOVIE_CTL_FRAME_REWIND, NULL);
+
+   return true;
+}
+
 /**
  * check_rewind:
  * @pressed              : was rewind key pressed or held?
@@ -580,6 +1191,11 @@ void state_manager_check_rewind(bool pressed)
    {
       const void *buf    = NULL;
 
+#ifdef HAVE_THREADS
+      /* Pending snapshots are newer than anything in the buffer. */
+      state_manager_thread_flush();
+#endif
+
       if (state_manager_pop(rewind_state.state, &buf))
       {
          retro_ctx_serialize_info_t serial_info;
@@ -619,19 +1235,35 @@ void state_manager_check_rewind(bool pressed)
          static struct retro_perf_counter rewind_serialize = {0};
          void *state = NULL;
 
-         state_manager_push_where(rewind_state.state, &state);
+#ifdef HAVE_THREADS
+         if (rewind_state.thread)
+         {
+            /* Serialization and queueing only, compression
+             * happens on the worker. */
+            performance_counter_init(&rewind_serialize, "rewind_serialize");
+            performance_counter_start(&rewind_serialize);
 
-         performance_counter_init(&rewind_serialize, "rewind_serialize");
-         performance_counter_start(&rewind_serialize);
+            state_manager_thread_push();
 
-         serial_info.data = state;
-         serial_info.size = rewind_state.size;
+            performance_counter_stop(&rewind_serialize);
+         }
+         else
+#endif
+         {
+            state_manager_push_where(rewind_state.state, &state);
 
-         core_serialize(&serial_info);
+            performance_counter_init(&rewind_serialize, "rewind_serialize");
+            performance_counter_start(&rewind_serialize);
 
-         performance_counter_stop(&rewind_serialize);
+            serial_info.data = state;
+            serial_info.size = rewind_state.size;
 
-         state_manager_push_do(rewind_state.state);
+            core_serialize(&serial_info);
+
+            performance_counter_stop(&rewind_serialize);
+
+            state_manager_push_do(rewind_state.state);
+         }
       }
    }
 
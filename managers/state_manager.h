@@ -34,6 +34,17 @@ void state_manager_event_deinit(void);
 
 void state_manager_event_init(void);
 
+/**
+ * state_manager_seek_back:
+ * @frames              : number of frames to go back.
+ *
+ * Jumps back @frames emulated frames in the rewind history
+ * in one go, restarting from a keyframe where possible.
+ *
+ * Returns: true if a state was loaded, otherwise false.
+ **/
+bool state_manager_seek_back(unsigned frames);
+
 /**
  * check_rewind:
  * @pressed              : was rewind key pressed or held?
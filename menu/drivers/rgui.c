@@ -53,17 +53,48 @@
 #define RGUI_TERM_WIDTH(width)          (((width - RGUI_TERM_START_X(width) - RGUI_TERM_START_X(width)) / (FONT_WIDTH_STRIDE)))
 #define RGUI_TERM_HEIGHT(width, height) (((height - RGUI_TERM_START_Y(height) - RGUI_TERM_START_X(width)) / (FONT_HEIGHT_STRIDE)) - 1)
 
+#define RGUI_MAX_FB_WIDTH  400
+#define RGUI_MAX_FB_HEIGHT 240
+
+/* A line of text on screen. The lines of the last frame are kept
+ * around, so that only the rows which changed get drawn again. */
+typedef struct
+{
+   int x;
+   int y;
+   uint16_t color;
+   char text[256];
+} rgui_text_t;
+
 typedef struct
 {
    bool force_redraw;
+   bool redraw_all;
    char msgbox[4096];
    unsigned last_width;
    unsigned last_height;
    float scroll_y;
+
+   rgui_text_t *texts;
+   rgui_text_t *last_texts;
+   size_t num_texts;
+   size_t num_last_texts;
+   size_t texts_size;
+
+   /* Rows covered by message boxes and the cursor, which
+    * are drawn every frame over whatever is below them. */
+   unsigned overlay_begin;
+   unsigned overlay_end;
+
+   bool dirty_rows[RGUI_MAX_FB_HEIGHT];
 } rgui_t;
 
 static uint16_t *rgui_framebuf_data      = NULL;
 
+/* Rows changed since the framebuffer was last uploaded. */
+static unsigned rgui_upload_begin        = 0;
+static unsigned rgui_upload_end          = 0;
+
 #if defined(GEKKO)|| defined(PSP)
 #define HOVER_COLOR(settings)    ((3 << 0) | (10 << 4) | (3 << 8) | (7 << 12))
 #define NORMAL_COLOR(settings)   0x7FFF
@@ -278,6 +309,213 @@ static void rgui_render_background(void)
          rgui_green_filler);
 }
 
+static void rgui_render_background_rows(unsigned y, unsigned end)
+{
+   size_t pitch_in_pixels, fb_pitch;
+   unsigned fb_width, fb_height;
+   const uint16_t *src  = NULL;
+
+   fb_width        = menu_display_get_width();
+   fb_height       = menu_display_get_height();
+   fb_pitch        = menu_display_get_framebuffer_pitch();
+
+   pitch_in_pixels = fb_pitch >> 1;
+   src             = rgui_framebuf_data + pitch_in_pixels * fb_height;
+
+   for (; y < end; y++)
+   {
+      /* Same as rgui_render_background(), just for one row. */
+      memcpy(rgui_framebuf_data + pitch_in_pixels * y,
+            src + pitch_in_pixels * (y & 3), fb_pitch);
+
+      if (y < 5 || y >= fb_height - 5)
+         continue;
+
+      if (y < 10 || y >= fb_height - 10)
+         rgui_fill_rect(fb_pitch, 5, y, fb_width - 10, 1, rgui_green_filler);
+      else
+      {
+         rgui_fill_rect(fb_pitch, 5, y, 5, 1, rgui_green_filler);
+         rgui_fill_rect(fb_pitch, fb_width - 10, y, 5, 1, rgui_green_filler);
+      }
+   }
+}
+
+static void rgui_mark_upload(unsigned y, unsigned end)
+{
+   if (y >= end)
+      return;
+
+   if (rgui_upload_begin >= rgui_upload_end)
+   {
+      rgui_upload_begin = y;
+      rgui_upload_end   = end;
+      return;
+   }
+
+   rgui_upload_begin = MIN(rgui_upload_begin, y);
+   rgui_upload_end   = MAX(rgui_upload_end, end);
+}
+
+/* Remembers rows drawn over by an overlay, they have
+ * to be restored before the next frame. */
+static void rgui_mark_overlay(rgui_t *rgui, int y, int height)
+{
+   int fb_height = menu_display_get_height();
+   int begin     = MAX(y, 0);
+   int end       = MIN(y + height, fb_height);
+
+   if (begin >= end)
+      return;
+
+   if (rgui->overlay_begin >= rgui->overlay_end)
+   {
+      rgui->overlay_begin = begin;
+      rgui->overlay_end   = end;
+   }
+   else
+   {
+      rgui->overlay_begin = MIN(rgui->overlay_begin, (unsigned)begin);
+      rgui->overlay_end   = MAX(rgui->overlay_end, (unsigned)end);
+   }
+
+   rgui_mark_upload(begin, end);
+}
+
+static void rgui_mark_rows(rgui_t *rgui, int y, int height)
+{
+   int fb_height = MIN(menu_display_get_height(), RGUI_MAX_FB_HEIGHT);
+   int begin     = MAX(y, 0);
+   int end       = MIN(y + height, fb_height);
+
+   for (; begin < end; begin++)
+      rgui->dirty_rows[begin] = true;
+}
+
+static bool rgui_rows_dirty(rgui_t *rgui, int y, int height)
+{
+   int fb_height = MIN(menu_display_get_height(), RGUI_MAX_FB_HEIGHT);
+   int begin     = MAX(y, 0);
+   int end       = MIN(y + height, fb_height);
+
+   for (; begin < end; begin++)
+      if (rgui->dirty_rows[begin])
+         return true;
+   return false;
+}
+
+static void rgui_add_text(rgui_t *rgui, int x, int y,
+      const char *message, uint16_t color)
+{
+   rgui_text_t *text = NULL;
+
+   if (rgui->num_texts == rgui->texts_size)
+   {
+      size_t size             = rgui->texts_size ? rgui->texts_size * 2 : 32;
+      rgui_text_t *texts      = (rgui_text_t*)
+         realloc(rgui->texts, size * sizeof(*texts));
+      rgui_text_t *last_texts = NULL;
+
+      if (!texts)
+         return;
+      rgui->texts = texts;
+
+      last_texts = (rgui_text_t*)
+         realloc(rgui->last_texts, size * sizeof(*last_texts));
+      if (!last_texts)
+         return;
+      rgui->last_texts = last_texts;
+      rgui->texts_size = size;
+   }
+
+   text        = &rgui->texts[rgui->num_texts++];
+   text->x     = x;
+   text->y     = y;
+   text->color = color;
+   strlcpy(text->text, message, sizeof(text->text));
+}
+
+static bool rgui_text_equal(const rgui_text_t *a, const rgui_text_t *b)
+{
+   return a->x == b->x && a->y == b->y && a->color == b->color
+      && string_is_equal(a->text, b->text);
+}
+
+/* Draws the text added since the last frame. Only the rows where
+ * some text changed, or where an overlay was drawn last frame, are
+ * cleared and drawn again. Text is drawn without a background, so
+ * drawing unchanged text again on top of itself is harmless. */
+static void rgui_render_texts(rgui_t *rgui)
+{
+   size_t i, count;
+   unsigned y, end, first, last;
+   rgui_text_t *tmp   = NULL;
+   unsigned fb_height = MIN(menu_display_get_height(), RGUI_MAX_FB_HEIGHT);
+
+   memset(rgui->dirty_rows, 0, sizeof(rgui->dirty_rows));
+
+   if (rgui->redraw_all)
+   {
+      rgui_render_background();
+      rgui_mark_rows(rgui, 0, fb_height);
+      rgui->redraw_all = false;
+   }
+   else
+   {
+      rgui_mark_rows(rgui, rgui->overlay_begin,
+            rgui->overlay_end - rgui->overlay_begin);
+
+      count = MAX(rgui->num_texts, rgui->num_last_texts);
+
+      for (i = 0; i < count; i++)
+      {
+         const rgui_text_t *text = (i < rgui->num_texts)
+            ? &rgui->texts[i] : NULL;
+         const rgui_text_t *prev = (i < rgui->num_last_texts)
+            ? &rgui->last_texts[i] : NULL;
+
+         if (text && prev && rgui_text_equal(text, prev))
+            continue;
+
+         if (text)
+            rgui_mark_rows(rgui, text->y, FONT_HEIGHT);
+         if (prev)
+            rgui_mark_rows(rgui, prev->y, FONT_HEIGHT);
+      }
+
+      for (y = 0; y < fb_height; y = end)
+      {
+         for (end = y; end < fb_height && rgui->dirty_rows[end]; end++);
+
+         if (end == y)
+            end++;
+         else
+            rgui_render_background_rows(y, end);
+      }
+   }
+
+   rgui->overlay_begin = rgui->overlay_end = 0;
+
+   for (i = 0; i < rgui->num_texts; i++)
+   {
+      const rgui_text_t *text = &rgui->texts[i];
+
+      if (rgui_rows_dirty(rgui, text->y, FONT_HEIGHT))
+         blit_line(text->x, text->y, text->text, text->color);
+   }
+
+   for (first = 0; first < fb_height && !rgui->dirty_rows[first]; first++);
+   for (last = fb_height; last > first && !rgui->dirty_rows[last - 1]; last--);
+
+   rgui_mark_upload(first, last);
+
+   tmp                  = rgui->last_texts;
+   rgui->last_texts     = rgui->texts;
+   rgui->texts          = tmp;
+   rgui->num_last_texts = rgui->num_texts;
+   rgui->num_texts      = 0;
+}
+
 static void rgui_set_message(void *data, const char *message)
 {
    rgui_t           *rgui = (rgui_t*)data;
@@ -289,7 +527,7 @@ static void rgui_set_message(void *data, const char *message)
    rgui->force_redraw = true;
 }
 
-static void rgui_render_messagebox(const char *message)
+static void rgui_render_messagebox(rgui_t *rgui, const char *message)
 {
    size_t i, fb_pitch;
    int x, y;
@@ -341,6 +579,8 @@ static void rgui_render_messagebox(const char *message)
    x      = (fb_width  - width) / 2;
    y      = (fb_height - height) / 2;
 
+   rgui_mark_overlay(rgui, y, height);
+
    rgui_fill_rect(fb_pitch, x + 5, y + 5, width - 10,
          height - 10, rgui_gray_filler);
    rgui_fill_rect(fb_pitch, x, y, width - 5, 5, rgui_green_filler);
@@ -366,7 +606,7 @@ end:
    string_list_free(list);
 }
 
-static void rgui_blit_cursor(void)
+static void rgui_blit_cursor(rgui_t *rgui)
 {
    size_t   fb_pitch;
    unsigned fb_width, fb_height;
@@ -379,6 +619,8 @@ static void rgui_blit_cursor(void)
 
    rgui_color_rect(fb_pitch, fb_width, fb_height, x, y - 5, 1, 11, 0xFFFF);
    rgui_color_rect(fb_pitch, fb_width, fb_height, x - 5, y, 11, 1, 0xFFFF);
+
+   rgui_mark_overlay(rgui, y - 5, 11);
 }
 
 static void rgui_render(void *data)
@@ -430,9 +672,9 @@ static void rgui_render(void *data)
       rgui_fill_rect(fb_pitch, 0, fb_height, fb_width, 4, rgui_gray_filler);
       rgui->last_width  = fb_width;
       rgui->last_height = fb_height;
+      rgui->redraw_all  = true;
    }
 
-   menu_display_set_framebuffer_dirty_flag();
    menu_animation_ctl(MENU_ANIMATION_CTL_CLEAR_ACTIVE, NULL);
 
    rgui->force_redraw        = false;
@@ -493,8 +735,6 @@ static void rgui_render(void *data)
    end = ((old_start + RGUI_TERM_HEIGHT(fb_width, fb_height)) <= (menu_entries_get_end())) ?
       old_start + RGUI_TERM_HEIGHT(fb_width, fb_height) : menu_entries_get_end();
 
-   rgui_render_background();
-
 #if 0
    RARCH_LOG("Dir is: %s\n", label);
 #endif
@@ -513,7 +753,7 @@ static void rgui_render(void *data)
    normal_color = NORMAL_COLOR(settings);
 
    if (menu_entries_ctl(MENU_ENTRIES_CTL_SHOW_BACK, NULL))
-      blit_line(
+      rgui_add_text(rgui,
             RGUI_TERM_START_X(fb_width),
             RGUI_TERM_START_X(fb_width),
             msg_hash_to_str(MENU_ENUM_LABEL_VALUE_BACK),
@@ -521,14 +761,14 @@ static void rgui_render(void *data)
 
    strlcpy(title_buf, string_to_upper(title_buf), sizeof(title_buf));
 
-   blit_line(
+   rgui_add_text(rgui,
          RGUI_TERM_START_X(fb_width) + (RGUI_TERM_WIDTH(fb_width)
             - utf8len(title_buf)) * FONT_WIDTH_STRIDE / 2,
          RGUI_TERM_START_X(fb_width),
          title_buf, TITLE_COLOR(settings));
 
    if (menu_entries_get_core_title(title_msg, sizeof(title_msg)) == 0)
-      blit_line(
+      rgui_add_text(rgui,
             RGUI_TERM_START_X(fb_width),
             (RGUI_TERM_HEIGHT(fb_width, fb_height) * FONT_HEIGHT_STRIDE) +
             RGUI_TERM_START_Y(fb_height) + 2, title_msg, hover_color);
@@ -546,7 +786,7 @@ static void rgui_render(void *data)
 
       menu_display_timedate(&datetime);
 
-      blit_line(
+      rgui_add_text(rgui,
             RGUI_TERM_WIDTH(fb_width) * FONT_WIDTH_STRIDE - RGUI_TERM_START_X(fb_width),
             (RGUI_TERM_HEIGHT(fb_width, fb_height) * FONT_HEIGHT_STRIDE) +
             RGUI_TERM_START_Y(fb_height) + 2, timedate, hover_color);
@@ -606,22 +846,24 @@ static void rgui_render(void *data)
             entry_spacing,
             type_str_buf);
 
-      blit_line(x, y, message,
+      rgui_add_text(rgui, x, y, message,
             entry_selected ? hover_color : normal_color);
    }
 
+   rgui_render_texts(rgui);
+
    if (menu_input_dialog_get_display_kb())
    {
       const char *str   = menu_input_dialog_get_buffer();
       const char *label = menu_input_dialog_get_label_buffer();
 
       snprintf(msg, sizeof(msg), "%s\n%s", label, str);
-      rgui_render_messagebox(msg);
+      rgui_render_messagebox(rgui, msg);
    }
 
    if (!string_is_empty(rgui->msgbox))
    {
-      rgui_render_messagebox(rgui->msgbox);
+      rgui_render_messagebox(rgui, rgui->msgbox);
       rgui->msgbox[0] = '\0';
       rgui->force_redraw = true;
    }
@@ -630,7 +872,10 @@ static void rgui_render(void *data)
          && (settings->video.fullscreen 
             || !video_driver_has_windowed())
          )
-      rgui_blit_cursor();
+      rgui_blit_cursor(rgui);
+
+   if (rgui_upload_begin < rgui_upload_end)
+      menu_display_set_framebuffer_dirty_flag();
 }
 
 static void rgui_framebuffer_free(void)
@@ -660,7 +905,7 @@ static void *rgui_init(void **userdata)
 
    /* 4 extra lines to cache  the checked background */
    rgui_framebuf_data = (uint16_t*)
-      calloc(400 * (240 + 4), sizeof(uint16_t));
+      calloc(RGUI_MAX_FB_WIDTH * (RGUI_MAX_FB_HEIGHT + 4), sizeof(uint16_t));
 
    if (!rgui_framebuf_data)
       goto error;
@@ -688,6 +933,7 @@ static void *rgui_init(void **userdata)
 
    rgui->last_width  = fb_width;
    rgui->last_height = fb_height;
+   rgui->redraw_all  = true;
 
    return menu;
 
@@ -703,6 +949,15 @@ static void rgui_free(void *data)
 {
    const uint8_t *font_fb;
    bool fb_font_inited   = false;
+   rgui_t *rgui          = (rgui_t*)data;
+
+   if (rgui)
+   {
+      free(rgui->texts);
+      free(rgui->last_texts);
+      rgui->texts      = NULL;
+      rgui->last_texts = NULL;
+   }
 
    fb_font_inited = menu_display_get_font_data_init();
    font_fb = menu_display_get_font_framebuffer();
@@ -726,8 +981,16 @@ static void rgui_set_texture(void)
 
    menu_display_unset_framebuffer_dirty_flag();
 
-   video_driver_set_texture_frame(rgui_framebuf_data,
-         false, fb_width, fb_height, 1.0f);
+   /* Nothing changed here if someone else asked for an upload,
+    * the driver then still uploads everything if it has to. */
+   if (rgui_upload_begin >= rgui_upload_end)
+      rgui_upload_begin = rgui_upload_end = 0;
+
+   video_driver_set_texture_frame_rows(rgui_framebuf_data,
+         false, fb_width, fb_height, rgui_upload_begin,
+         rgui_upload_end - rgui_upload_begin, 1.0f);
+
+   rgui_upload_begin = rgui_upload_end = 0;
 }
 
 static void rgui_navigation_clear(void *data, bool pending_push)
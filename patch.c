@@ -553,40 +553,90 @@ error:
    return false;
 }
 
-static bool try_bps_patch(uint8_t **buf, ssize_t *size)
+static const char *bps_patch_path(void)
 {
    global_t *global = global_get_ptr();
    bool allow_bps   = !rarch_ctl(RARCH_CTL_IS_UPS_PREF, NULL) && !rarch_ctl(RARCH_CTL_IS_IPS_PREF, NULL);
 
    if (!allow_bps || string_is_empty(global->name.bps))
-      return false;
-
-   return apply_patch_content(buf, size, "BPS", global->name.bps,
-         bps_apply_patch);
+      return NULL;
+   return global->name.bps;
 }
 
-static bool try_ups_patch(uint8_t **buf, ssize_t *size)
+static const char *ups_patch_path(void)
 {
    global_t *global = global_get_ptr();
    bool allow_ups   = !rarch_ctl(RARCH_CTL_IS_BPS_PREF, NULL) && !rarch_ctl(RARCH_CTL_IS_IPS_PREF, NULL);
 
    if (!allow_ups || string_is_empty(global->name.ups))
-      return false;
-
-   return apply_patch_content(buf, size, "UPS", global->name.ups,
-         ups_apply_patch);
+      return NULL;
+   return global->name.ups;
 }
 
-static bool try_ips_patch(uint8_t **buf, ssize_t *size)
+static const char *ips_patch_path(void)
 {
    global_t *global = global_get_ptr();
    bool allow_ips   = !rarch_ctl(RARCH_CTL_IS_UPS_PREF, NULL) && !rarch_ctl(RARCH_CTL_IS_BPS_PREF, NULL);
 
    if (!allow_ips || string_is_empty(global->name.ips))
+      return NULL;
+   return global->name.ips;
+}
+
+static bool try_bps_patch(uint8_t **buf, ssize_t *size)
+{
+   const char *path = bps_patch_path();
+
+   if (!path)
       return false;
 
-   return apply_patch_content(buf, size, "IPS", global->name.ips,
-         ips_apply_patch);
+   return apply_patch_content(buf, size, "BPS", path, bps_apply_patch);
+}
+
+static bool try_ups_patch(uint8_t **buf, ssize_t *size)
+{
+   const char *path = ups_patch_path();
+
+   if (!path)
+      return false;
+
+   return apply_patch_content(buf, size, "UPS", path, ups_apply_patch);
+}
+
+static bool try_ips_patch(uint8_t **buf, ssize_t *size)
+{
+   const char *path = ips_patch_path();
+
+   if (!path)
+      return false;
+
+   return apply_patch_content(buf, size, "IPS", path, ips_apply_patch);
+}
+
+static bool patch_content_several_defined(void)
+{
+   return (unsigned)rarch_ctl(RARCH_CTL_IS_IPS_PREF, NULL)
+      + (unsigned)rarch_ctl(RARCH_CTL_IS_BPS_PREF, NULL)
+      + (unsigned)rarch_ctl(RARCH_CTL_IS_UPS_PREF, NULL) > 1;
+}
+
+bool patch_content_available(void)
+{
+   const char *ips = NULL;
+   const char *bps = NULL;
+   const char *ups = NULL;
+
+   /* patch_content() has a warning to show. */
+   if (patch_content_several_defined())
+      return true;
+
+   ips = ips_patch_path();
+   bps = bps_patch_path();
+   ups = ups_patch_path();
+
+   return (ips && path_is_valid(ips))
+      ||  (bps && path_is_valid(bps))
+      ||  (ups && path_is_valid(ups));
 }
 
 /**
@@ -599,9 +649,7 @@ static bool try_ips_patch(uint8_t **buf, ssize_t *size)
  **/
 void patch_content(uint8_t **buf, ssize_t *size)
 {
-   if (    (unsigned)rarch_ctl(RARCH_CTL_IS_IPS_PREF, NULL) 
-         + (unsigned)rarch_ctl(RARCH_CTL_IS_BPS_PREF, NULL) 
-         + (unsigned)rarch_ctl(RARCH_CTL_IS_UPS_PREF, NULL) > 1)
+   if (patch_content_several_defined())
    {
       RARCH_WARN("%s\n",
             msg_hash_to_str(MSG_SEVERAL_PATCHES_ARE_EXPLICITLY_DEFINED));
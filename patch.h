@@ -21,6 +21,7 @@
 #include <stddef.h>
 
 #include <retro_common_api.h>
+#include <boolean.h>
 
 RETRO_BEGIN_DECLS
 
@@ -38,6 +39,18 @@ RETRO_BEGIN_DECLS
  **/
 void patch_content(uint8_t **buf, ssize_t *size);
 
+/**
+ * patch_content_available:
+ *
+ * Checks whether patch_content() would find a patch to apply,
+ * without reading it.
+ *
+ * Returns: true if a patch file would be tried, or if several
+ * patches are explicitly defined and patch_content() would
+ * warn about it.
+ **/
+bool patch_content_available(void);
+
 RETRO_END_DECLS
 
 #endif
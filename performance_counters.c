@@ -147,3 +147,13 @@ void performance_counter_stop(struct retro_perf_counter *perf)
 
    perf->total += cpu_features_get_perf_counter() - perf->start;
 }
+
+void performance_counter_sample(struct retro_perf_counter *perf,
+      retro_perf_tick_t value)
+{
+   if (!runloop_ctl(RUNLOOP_CTL_IS_PERFCNT_ENABLE, NULL) || !perf)
+      return;
+
+   perf->call_cnt++;
+   perf->total += value;
+}
@@ -62,6 +62,18 @@ void performance_counter_start(struct retro_perf_counter *perf);
  **/
 void performance_counter_stop(struct retro_perf_counter *perf);
 
+/**
+ * performance_counter_sample:
+ * @perf               : pointer to performance counter
+ * @value              : value to accumulate
+ *
+ * Accumulates an arbitrary value (queue depth, hit count, ...)
+ * instead of elapsed ticks. The logged average is then the
+ * average of all sampled values.
+ **/
+void performance_counter_sample(struct retro_perf_counter *perf,
+      retro_perf_tick_t value);
+
 RETRO_END_DECLS
 
 #endif
@@ -25,6 +25,7 @@
 #include <streams/file_stream.h>
 #include <retro_miscellaneous.h>
 #include <file/file_path.h>
+#include <rhash.h>
 
 #include "playlist.h"
 #include "verbosity.h"
@@ -33,10 +34,137 @@
 #define PLAYLIST_ENTRIES 6
 #endif
 
+#define PLAYLIST_INDEX_MIN_SIZE 256
+
 typedef int (playlist_sort_fun_t)(
       const struct playlist_entry *a,
       const struct playlist_entry *b);
 
+/* Paths are owned by the entries; those are moved around
+ * by push and delete, the strings themselves are not. */
+struct playlist_index_slot
+{
+   const char *path;
+   uint32_t hash;
+};
+
+static void playlist_free_entry(struct playlist_entry *entry);
+
+static bool playlist_index_grow(playlist_t *playlist)
+{
+   size_t i;
+   size_t old_size                       = playlist->index_size;
+   struct playlist_index_slot *old_index = playlist->index;
+   size_t new_size                       = old_size
+      ? old_size * 2 : PLAYLIST_INDEX_MIN_SIZE;
+   size_t mask                           = new_size - 1;
+   struct playlist_index_slot *new_index = (struct playlist_index_slot*)
+      calloc(new_size, sizeof(*new_index));
+
+   if (!new_index)
+      return false;
+
+   for (i = 0; i < old_size; i++)
+   {
+      size_t j;
+
+      if (!old_index[i].path)
+         continue;
+
+      j = old_index[i].hash & mask;
+      while (new_index[j].path)
+         j = (j + 1) & mask;
+      new_index[j] = old_index[i];
+   }
+
+   free(old_index);
+   playlist->index      = new_index;
+   playlist->index_size = new_size;
+   return true;
+}
+
+static void playlist_index_add(playlist_t *playlist, const char *path)
+{
+   size_t i, mask;
+   uint32_t hash;
+
+   if (!path)
+      return;
+
+   if ((playlist->index_count + 1) * 2 > playlist->index_size)
+      if (!playlist_index_grow(playlist))
+         return;
+
+   hash = djb2_calculate(path);
+   mask = playlist->index_size - 1;
+
+   for (i = hash & mask; playlist->index[i].path; i = (i + 1) & mask);
+
+   playlist->index[i].path = path;
+   playlist->index[i].hash = hash;
+   playlist->index_count++;
+}
+
+static bool playlist_index_find(const playlist_t *playlist,
+      const char *path)
+{
+   size_t i, mask;
+   uint32_t hash;
+
+   if (!path || !playlist->index)
+      return false;
+
+   hash = djb2_calculate(path);
+   mask = playlist->index_size - 1;
+
+   for (i = hash & mask; playlist->index[i].path; i = (i + 1) & mask)
+      if (playlist->index[i].hash == hash
+            && string_is_equal(playlist->index[i].path, path))
+         return true;
+
+   return false;
+}
+
+/* Removes the slot of this exact string; the same path may be
+ * in the playlist several times with different cores. */
+static void playlist_index_remove(playlist_t *playlist, const char *path)
+{
+   size_t i, j, mask;
+
+   if (!path || !playlist->index)
+      return;
+
+   mask = playlist->index_size - 1;
+
+   for (i = djb2_calculate(path) & mask; playlist->index[i].path != path;
+         i = (i + 1) & mask)
+      if (!playlist->index[i].path)
+         return;
+
+   /* Shift the rest of the cluster back over the hole. */
+   for (j = (i + 1) & mask; playlist->index[j].path; j = (j + 1) & mask)
+   {
+      size_t home = playlist->index[j].hash & mask;
+
+      if ((i <= j) ? (i < home && home <= j) : (i < home || home <= j))
+         continue;
+
+      playlist->index[i] = playlist->index[j];
+      i                  = j;
+   }
+
+   playlist->index[i].path = NULL;
+   playlist->index_count--;
+}
+
+static void playlist_index_clear(playlist_t *playlist)
+{
+   if (playlist->index)
+      memset(playlist->index, 0,
+            playlist->index_size * sizeof(*playlist->index));
+   playlist->index_count = 0;
+}
+
 /**
  * playlist_get_index:
  * @playlist            : Playlist handle.
@@ -81,13 +209,19 @@ void playlist_get_index(playlist_t *playlist,
 void playlist_delete_index(playlist_t *playlist,
       size_t idx)
 {
-   if (!playlist)
+   if (!playlist || idx >= playlist->size)
       return;
 
+   playlist_index_remove(playlist, playlist->entries[idx].path);
+   playlist_free_entry(&playlist->entries[idx]);
+
    memmove(playlist->entries + idx, playlist->entries + idx + 1,
-         (playlist->size - idx) * sizeof(struct playlist_entry));
+         (playlist->size - idx - 1) * sizeof(struct playlist_entry));
 
    playlist->size = playlist->size - 1;
+   memset(&playlist->entries[playlist->size], 0,
+         sizeof(struct playlist_entry));
+   playlist->modified = true;
 
    playlist_write_file(playlist);
 }
@@ -128,15 +262,10 @@ bool playlist_entry_exists(playlist_t *playlist,
       const char *path,
       const char *crc32)
 {
-   size_t i;
    if (!playlist)
       return false;
 
-   for (i = 0; i < playlist->size; i++)
-      if (string_is_equal(playlist->entries[i].path, path))
-         return true;
-
-   return false;
+   return playlist_index_find(playlist, path);
 }
 
 /**
@@ -191,8 +320,10 @@ void playlist_update(playlist_t *playlist, size_t idx,
 
    if (path && (path != entry->path))
    {
+      playlist_index_remove(playlist, entry->path);
       free(entry->path);
       entry->path = strdup(path);
+      playlist_index_add(playlist, entry->path);
    }
 
    if (label && (label != entry->label))
@@ -224,6 +355,34 @@ void playlist_update(playlist_t *playlist, size_t idx,
       free(entry->crc32);
       entry->crc32 = strdup(crc32);
    }
+
+   playlist->modified = true;
+}
+
+static void playlist_entry_init(struct playlist_entry *entry,
+      const char *path, const char *label,
+      const char *core_path, const char *core_name,
+      const char *crc32,
+      const char *db_name)
+{
+   entry->path      = NULL;
+   entry->label     = NULL;
+   entry->core_path = NULL;
+   entry->core_name = NULL;
+   entry->db_name   = NULL;
+   entry->crc32     = NULL;
+   if (!string_is_empty(path))
+      entry->path      = strdup(path);
+   if (!string_is_empty(label))
+      entry->label     = strdup(label);
+   if (!string_is_empty(core_path))
+      entry->core_path = strdup(core_path);
+   if (!string_is_empty(core_name))
+      entry->core_name = strdup(core_name);
+   if (!string_is_empty(db_name))
+      entry->db_name   = strdup(db_name);
+   if (!string_is_empty(crc32))
+      entry->crc32     = strdup(crc32);
 }
 
 /**
@@ -269,33 +428,38 @@ bool playlist_push(playlist_t *playlist,
    if (!playlist)
       return false;
 
-   for (i = 0; i < playlist->size; i++)
+   /* Only walk the entries when the path is known to be there. */
+   if (!path || playlist_index_find(playlist, path))
    {
-      struct playlist_entry tmp;
-      bool equal_path = (!path && !playlist->entries[i].path) ||
-         (path && playlist->entries[i].path &&
-          string_is_equal(path,playlist->entries[i].path));
-
-      /* Core name can have changed while still being the same core.
-       * Differentiate based on the core path only. */
-      if (!equal_path)
-         continue;
-
-      if (!string_is_equal(playlist->entries[i].core_path, core_path))
-         continue;
-
-      /* If top entry, we don't want to push a new entry since
-       * the top and the entry to be pushed are the same. */
-      if (i == 0)
-         return false;
-
-      /* Seen it before, bump to top. */
-      tmp = playlist->entries[i];
-      memmove(playlist->entries + 1, playlist->entries,
-            i * sizeof(struct playlist_entry));
-      playlist->entries[0] = tmp;
+      for (i = 0; i < playlist->size; i++)
+      {
+         struct playlist_entry tmp;
+         bool equal_path = (!path && !playlist->entries[i].path) ||
+            (path && playlist->entries[i].path &&
+             string_is_equal(path,playlist->entries[i].path));
+
+         /* Core name can have changed while still being the same core.
+          * Differentiate based on the core path only. */
+         if (!equal_path)
+            continue;
+
+         if (!string_is_equal(playlist->entries[i].core_path, core_path))
+            continue;
+
+         /* If top entry, we don't want to push a new entry since
+          * the top and the entry to be pushed are the same. */
+         if (i == 0)
+            return false;
+
+         /* Seen it before, bump to top. */
+         tmp = playlist->entries[i];
+         memmove(playlist->entries + 1, playlist->entries,
+               i * sizeof(struct playlist_entry));
+         playlist->entries[0] = tmp;
+         playlist->modified   = true;
 
-      return true;
+         return true;
+      }
    }
 
    if (playlist->size == playlist->cap)
@@ -303,31 +467,48 @@ bool playlist_push(playlist_t *playlist,
       struct playlist_entry *entry = &playlist->entries[playlist->cap - 1];
 
       if (entry)
+      {
+         playlist_index_remove(playlist, entry->path);
          playlist_free_entry(entry);
+      }
       playlist->size--;
    }
 
    memmove(playlist->entries + 1, playlist->entries,
-         (playlist->cap - 1) * sizeof(struct playlist_entry));
-
-   playlist->entries[0].path      = NULL;
-   playlist->entries[0].label     = NULL;
-   playlist->entries[0].core_path = NULL;
-   playlist->entries[0].core_name = NULL;
-   playlist->entries[0].db_name   = NULL;
-   playlist->entries[0].crc32     = NULL;
-   if (!string_is_empty(path))
-      playlist->entries[0].path   = strdup(path);
-   if (!string_is_empty(label))
-      playlist->entries[0].label  = strdup(label);
-   if (!string_is_empty(core_path))
-      playlist->entries[0].core_path = strdup(core_path);
-   if (!string_is_empty(core_name))
-      playlist->entries[0].core_name = strdup(core_name);
-   if (!string_is_empty(db_name))
-      playlist->entries[0].db_name   = strdup(db_name);
-   if (!string_is_empty(crc32))
-      playlist->entries[0].crc32     = strdup(crc32);
+         playlist->size * sizeof(struct playlist_entry));
+
+   playlist_entry_init(&playlist->entries[0], path, label,
+         core_path, core_name, crc32, db_name);
+   playlist_index_add(playlist, playlist->entries[0].path);
+
+   playlist->size++;
+   playlist->modified = true;
+
+   return true;
+}
+
+bool playlist_append(playlist_t *playlist,
+      const char *path, const char *label,
+      const char *core_path, const char *core_name,
+      const char *crc32,
+      const char *db_name)
+{
+   struct playlist_entry *entry = NULL;
+
+   if (!playlist || playlist->size == playlist->cap)
+      return false;
+
+   if (string_is_empty(core_path) || string_is_empty(core_name))
+   {
+      RARCH_ERR("cannot push NULL or empty core name into the playlist.\n");
+      return false;
+   }
+
+   entry = &playlist->entries[playlist->size];
+
+   playlist_entry_init(entry, path, label,
+         core_path, core_name, crc32, db_name);
+   playlist_index_add(playlist, entry->path);
 
    playlist->size++;
 
@@ -342,7 +523,12 @@ void playlist_write_file(playlist_t *playlist)
    if (!playlist)
       return;
 
-   file = fopen(playlist->conf_path, "w");
+   if (!playlist->modified && playlist->flushed == playlist->size)
+      return;
+
+   /* Nothing before the flushed entries changed,
+    * so only the new ones need to go to the file. */
+   file = fopen(playlist->conf_path, playlist->modified ? "w" : "a");
 
    RARCH_LOG("Trying to write to playlist file: %s\n", playlist->conf_path);
 
@@ -352,7 +538,8 @@ void playlist_write_file(playlist_t *playlist)
       return;
    }
 
-   for (i = 0; i < playlist->size; i++)
+   for (i = playlist->modified ? 0 : playlist->flushed;
+         i < playlist->size; i++)
       fprintf(file, "%s\n%s\n%s\n%s\n%s\n%s\n",
             playlist->entries[i].path    ? playlist->entries[i].path    : "",
             playlist->entries[i].label   ? playlist->entries[i].label   : "",
@@ -363,6 +550,9 @@ void playlist_write_file(playlist_t *playlist)
             );
 
    fclose(file);
+
+   playlist->flushed  = playlist->size;
+   playlist->modified = false;
 }
 
 /**
@@ -394,6 +584,9 @@ void playlist_free(playlist_t *playlist)
    free(playlist->entries);
    playlist->entries = NULL;
 
+   free(playlist->index);
+   playlist->index   = NULL;
+
    free(playlist);
 }
 
@@ -416,7 +609,9 @@ void playlist_clear(playlist_t *playlist)
       if (entry)
          playlist_free_entry(entry);
    }
-   playlist->size = 0;
+   playlist->size     = 0;
+   playlist->modified = true;
+   playlist_index_clear(playlist);
 }
 
 /**
@@ -461,11 +656,22 @@ static bool playlist_read_file(
          *buf[i]     = '\0';
 
          if (!filestream_gets(file, buf[i], sizeof(buf[i])))
+         {
+            /* A partial entry would swallow appended lines. */
+            if (i)
+               playlist->modified = true;
             goto end;
+         }
 
          last = strrchr(buf[i], '\n');
          if (last)
             *last = '\0';
+         else
+         {
+            /* Unterminated or overlong line; appending
+             * to this file would not read back the same. */
+            playlist->modified = true;
+         }
       }
 
       entry = &playlist->entries[playlist->size];
@@ -483,10 +689,15 @@ static bool playlist_read_file(
          entry->crc32     = strdup(buf[4]);
       if (*buf[5])
          entry->db_name   = strdup(buf[5]);
+      playlist_index_add(playlist, entry->path);
       playlist->size++;
    }
 
+   /* There might be more entries in the file than we kept. */
+   playlist->modified = true;
+
 end:
+   playlist->flushed = playlist->size;
    filestream_close(file);
    return true;
 }
@@ -549,4 +760,5 @@ void playlist_qsort(playlist_t *playlist)
    qsort(playlist->entries, playlist->size,
          sizeof(struct playlist_entry),
          (int (*)(const void *, const void *))playlist_qsort_func);
+   playlist->modified = true;
 }
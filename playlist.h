@@ -37,12 +37,24 @@ struct playlist_entry
    char *crc32;
 };
 
+struct playlist_index_slot;
+
 struct content_playlist
 {
    struct playlist_entry *entries;
    size_t size;
    size_t cap;
 
+   /* The first 'flushed' entries are on disk in this order.
+    * Unless 'modified' is set, writing only appends the rest. */
+   size_t flushed;
+   bool modified;
+
+   /* Open addressing index over entry paths. */
+   struct playlist_index_slot *index;
+   size_t index_size;
+   size_t index_count;
+
    char *conf_path;
 };
 
@@ -124,6 +136,27 @@ bool playlist_push(playlist_t *playlist,
       const char *db_name,
       const char *crc32);
 
+/**
+ * playlist_append:
+ * @playlist            : Playlist handle.
+ * @path                : Path of new playlist entry.
+ * @label               : Label of new playlist entry.
+ * @core_path           : Core path of new playlist entry.
+ * @core_name           : Core name of new playlist entry.
+ * @crc32               : CRC32 of new playlist entry.
+ * @db_name             : Database name of new playlist entry.
+ *
+ * Adds entry to the bottom of playlist, without looking for
+ * an existing one; use playlist_entry_exists() first. Entries
+ * already on disk are left in place, so the next
+ * playlist_write_file() only appends to the file.
+ **/
+bool playlist_append(playlist_t *playlist,
+      const char *path, const char *label,
+      const char *core_path, const char *core_name,
+      const char *crc32,
+      const char *db_name);
+
 void playlist_update(playlist_t *playlist, size_t idx,
       const char *path, const char *label,
       const char *core_path, const char *core_name,
@@ -141,6 +174,13 @@ bool playlist_entry_exists(playlist_t *playlist,
       const char *path,
       const char *crc32);
 
+/**
+ * playlist_write_file:
+ * @playlist               : Playlist handle.
+ *
+ * Writes playlist to its file. Rewrites the whole file
+ * unless entries were only appended since the last write.
+ **/
 void playlist_write_file(playlist_t *playlist);
 
 void playlist_qsort(playlist_t *playlist);
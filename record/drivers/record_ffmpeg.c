@@ -182,6 +182,7 @@ struct ff_config_param
    char format[64];
    enum PixelFormat out_pix_fmt;
    unsigned threads;
+   unsigned scale_threads;
    unsigned frame_drop_ratio;
    unsigned sample_rate;
    unsigned scale_factor;
@@ -341,7 +342,8 @@ static bool ffmpeg_init_audio(ffmpeg_t *handle)
       rarch_resampler_realloc(&audio->resampler_data,
             &audio->resampler,
             settings->audio.resampler,
-            audio->ratio);
+            audio->ratio,
+            (enum resampler_quality)settings->audio.resampler_quality);
    }
    else
    {
@@ -416,6 +418,8 @@ static bool ffmpeg_init_video(ffmpeg_t *handle)
 
    video->encoder = codec;
 
+   video->scaler.threads = params->scale_threads;
+
    /* Don't use swscaler unless format is not something "in-house" scaler
     * supports.
     *
@@ -538,6 +542,7 @@ static bool ffmpeg_init_config(struct ff_config_param *params,
    params->out_pix_fmt = PIX_FMT_NONE;
    params->scale_factor = 1;
    params->threads = 1;
+   params->scale_threads = 1;
    params->frame_drop_ratio = 1;
    params->audio_enable = true;
 
@@ -559,6 +564,7 @@ static bool ffmpeg_init_config(struct ff_config_param *params,
          sizeof(params->format));
 
    config_get_uint(params->conf, "threads", &params->threads);
+   config_get_uint(params->conf, "scale_threads", &params->scale_threads);
 
    if (!config_get_uint(params->conf, "frame_drop_ratio",
             &params->frame_drop_ratio) || !params->frame_drop_ratio)
@@ -39,11 +39,13 @@
 #include <compat/getopt.h>
 #include <compat/posix_string.h>
 #include <file/file_path.h>
+#include <file/archive_file.h>
 #include <retro_stat.h>
 #include <retro_assert.h>
 #include <retro_miscellaneous.h>
 #include <rthreads/rthreads.h>
 #include <features/features_cpu.h>
+#include <encodings/crc32.h>
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -1042,7 +1044,9 @@ bool retroarch_main_init(int argc, char *argv[])
    }
 
    retroarch_validate_cpu_features();
+   encoding_crc32_init_simd(cpu_features_get());
    config_load();
+   file_archive_set_index_dir(config_get_ptr()->directory.cache);
 
    runloop_ctl(RUNLOOP_CTL_TASK_INIT, NULL);
 
@@ -0,0 +1,337 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2016 - Daniel De Matteis
+ * 
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef HAVE_NETWORKING
+#include "network/netplay/netplay.h"
+#endif
+
+#include "runahead.h"
+#include "configuration.h"
+#include "core.h"
+#include "dynamic.h"
+#include "movie.h"
+#include "paths.h"
+#include "runloop.h"
+#include "verbosity.h"
+#include "audio/audio_driver.h"
+#include "gfx/video_driver.h"
+#include "input/input_driver.h"
+#include "managers/state_manager.h"
+
+static void *runahead_state                 = NULL;
+static size_t runahead_state_size           = 0;
+static bool runahead_warned                 = false;
+static bool runahead_disabled               = false;
+
+static struct retro_core_t runahead_secondary;
+static void *runahead_secondary_content     = NULL;
+static bool runahead_secondary_loaded       = false;
+static bool runahead_secondary_failed       = false;
+
+static void runahead_warn(const char *msg)
+{
+   if (runahead_warned)
+      return;
+
+   RARCH_WARN("Run-ahead: %s\n", msg);
+   runahead_warned = true;
+}
+
+static void runahead_audio_sample_null(int16_t left, int16_t right)
+{
+}
+
+static size_t runahead_audio_sample_batch_null(
+      const int16_t *data, size_t frames)
+{
+   return frames;
+}
+
+static void runahead_input_poll_null(void)
+{
+}
+
+/* The secondary instance runs alongside the first one, so
+ * it must not change any frontend state. Queries are passed
+ * on, settings the first instance has already made are
+ * acknowledged and dropped, anything else is refused. */
+static bool runahead_secondary_environment_cb(unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_OVERSCAN:
+      case RETRO_ENVIRONMENT_GET_CAN_DUPE:
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+      case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+      case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+      case RETRO_ENVIRONMENT_GET_CORE_ASSETS_DIRECTORY:
+      case RETRO_ENVIRONMENT_GET_LIBRETRO_PATH:
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+      case RETRO_ENVIRONMENT_GET_INPUT_DEVICE_CAPABILITIES:
+      case RETRO_ENVIRONMENT_GET_LANGUAGE:
+      case RETRO_ENVIRONMENT_GET_USERNAME:
+      case RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER:
+         return rarch_environment_cb(cmd, data);
+
+      case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+      case RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS:
+      case RETRO_ENVIRONMENT_SET_VARIABLES:
+      case RETRO_ENVIRONMENT_SET_SUPPORT_NO_GAME:
+      case RETRO_ENVIRONMENT_SET_PERFORMANCE_LEVEL:
+      case RETRO_ENVIRONMENT_SET_CONTROLLER_INFO:
+      case RETRO_ENVIRONMENT_SET_SUBSYSTEM_INFO:
+      case RETRO_ENVIRONMENT_SET_MEMORY_MAPS:
+      case RETRO_ENVIRONMENT_SET_GEOMETRY:
+      case RETRO_ENVIRONMENT_SET_SERIALIZATION_QUIRKS:
+      case RETRO_ENVIRONMENT_SET_ROTATION:
+         return true;
+
+      default:
+         break;
+   }
+
+   return false;
+}
+
+static void runahead_secondary_deinit(void)
+{
+   if (runahead_secondary_loaded)
+   {
+      runahead_secondary.retro_unload_game();
+      runahead_secondary.retro_deinit();
+   }
+
+   uninit_libretro_sym_secondary(&runahead_secondary);
+
+   free(runahead_secondary_content);
+   runahead_secondary_content = NULL;
+   runahead_secondary_loaded  = false;
+}
+
+/**
+ * runahead_secondary_init:
+ *
+ * Loads a second instance of the core with the same content.
+ * Its audio is never output, and it shares input with the
+ * first instance, which does the polling.
+ **/
+static bool runahead_secondary_init(void)
+{
+   unsigned i;
+   bool loaded                          = false;
+   struct retro_game_info info          = {0};
+   rarch_system_info_t *system          = NULL;
+   struct retro_hw_render_callback *hwr = video_driver_get_hw_context();
+   settings_t *settings                 = config_get_ptr();
+   const char *content                  = path_get(RARCH_PATH_CONTENT);
+
+   runloop_ctl(RUNLOOP_CTL_SYSTEM_INFO_GET, &system);
+
+   /* Two instances can't share one hardware context. */
+   if (!system || (hwr && hwr->context_type != RETRO_HW_CONTEXT_NONE))
+      return false;
+
+   if (!init_libretro_sym_secondary(&runahead_secondary))
+      return false;
+
+   runahead_secondary.retro_set_environment(
+         runahead_secondary_environment_cb);
+   runahead_secondary.retro_init();
+
+   runahead_secondary.retro_set_video_refresh(video_driver_frame);
+   runahead_secondary.retro_set_audio_sample(runahead_audio_sample_null);
+   runahead_secondary.retro_set_audio_sample_batch(
+         runahead_audio_sample_batch_null);
+   runahead_secondary.retro_set_input_poll(runahead_input_poll_null);
+   runahead_secondary.retro_set_input_state(input_state);
+
+   if (string_is_empty(content))
+      loaded = runahead_secondary.retro_load_game(NULL);
+   else
+   {
+      info.path = content;
+
+      if (!system->info.need_fullpath)
+      {
+         ssize_t len = 0;
+
+         if (!filestream_read_file(content,
+                  &runahead_secondary_content, &len))
+            goto error;
+
+         info.data = runahead_secondary_content;
+         info.size = len;
+      }
+
+      loaded = runahead_secondary.retro_load_game(&info);
+   }
+
+   if (!loaded)
+      goto error;
+
+   for (i = 0; i < settings->input.max_users; i++)
+      runahead_secondary.retro_set_controller_port_device(i,
+            settings->input.libretro_device[i]);
+
+   return true;
+
+error:
+   runahead_secondary.retro_deinit();
+   runahead_secondary_deinit();
+   return false;
+}
+
+static bool runahead_is_possible(void)
+{
+   if (runahead_disabled)
+      return false;
+   if (bsv_movie_ctl(BSV_MOVIE_CTL_IS_INITED, NULL))
+      return false;
+   if (state_manager_frame_is_reversed())
+      return false;
+#ifdef HAVE_NETWORKING
+   if (netplay_driver_ctl(RARCH_NETPLAY_CTL_IS_DATA_INITED, NULL))
+      return false;
+#endif
+   if (core_serialization_quirks() & RETRO_SERIALIZATION_QUIRK_INCOMPLETE)
+   {
+      runahead_warn("core savestates are incomplete, disabled.");
+      return false;
+   }
+
+   return true;
+}
+
+void runahead_run(unsigned frames, bool secondary)
+{
+   unsigned i;
+   retro_ctx_size_info_t size_info;
+   retro_ctx_serialize_info_t serial_info;
+
+   if (!secondary && runahead_secondary_loaded)
+      runahead_secondary_deinit();
+
+   if (frames == 0 || !runahead_is_possible())
+   {
+      core_run();
+      return;
+   }
+
+   core_serialize_size(&size_info);
+
+   if (size_info.size == 0)
+   {
+      runahead_warn("core does not support savestates, disabled.");
+      core_run();
+      return;
+   }
+
+   if (size_info.size > runahead_state_size)
+   {
+      void *state = realloc(runahead_state, size_info.size);
+
+      if (!state)
+      {
+         core_run();
+         return;
+      }
+
+      runahead_state      = state;
+      runahead_state_size = size_info.size;
+   }
+
+   if (secondary && !runahead_secondary_loaded && !runahead_secondary_failed)
+   {
+      runahead_secondary_loaded = runahead_secondary_init();
+      runahead_secondary_failed = !runahead_secondary_loaded;
+
+      if (runahead_secondary_failed)
+         RARCH_WARN("Run-ahead: could not load a second instance "
+               "of the core, using a single instance.\n");
+   }
+
+   serial_info.data       = runahead_state;
+   serial_info.data_const = runahead_state;
+   serial_info.size       = size_info.size;
+
+   /* The real frame is heard, but not seen. */
+   video_driver_set_frame_suppressed(true);
+   core_run();
+
+   if (!core_serialize(&serial_info))
+   {
+      /* Show the frame that was just hidden, and
+       * stop trying until the content changes. */
+      video_driver_set_frame_suppressed(false);
+      video_driver_cached_frame_render();
+      runahead_disabled = true;
+      runahead_warn("could not save state, disabled.");
+      return;
+   }
+
+   /* The frames ahead are neither heard nor seen, except
+    * for the video of the last one. */
+   audio_driver_set_suppressed(true);
+
+   if (runahead_secondary_loaded && 
+         runahead_secondary.retro_unserialize(
+            serial_info.data_const, serial_info.size))
+   {
+      for (i = 0; i < frames; i++)
+      {
+         if (i == frames - 1)
+            video_driver_set_frame_suppressed(false);
+         runahead_secondary.retro_run();
+      }
+   }
+   else
+   {
+      for (i = 0; i < frames; i++)
+      {
+         if (i == frames - 1)
+            video_driver_set_frame_suppressed(false);
+         core_run();
+      }
+
+      core_unserialize(&serial_info);
+   }
+
+   video_driver_set_frame_suppressed(false);
+   audio_driver_set_suppressed(false);
+}
+
+void runahead_deinit(void)
+{
+   runahead_secondary_deinit();
+
+   free(runahead_state);
+   runahead_state            = NULL;
+   runahead_state_size       = 0;
+   runahead_warned           = false;
+   runahead_disabled         = false;
+   runahead_secondary_failed = false;
+}
@@ -0,0 +1,47 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2016 - Daniel De Matteis
+ * 
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RARCH_RUNAHEAD_H
+#define __RARCH_RUNAHEAD_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/**
+ * runahead_run:
+ * @frames               : Number of frames to run ahead.
+ * @secondary            : Run the hidden frames on a second
+ *                         instance of the core.
+ *
+ * Runs the core for one frame, then @frames further frames
+ * with the current input, shows the last of them and rolls
+ * back. Falls back to core_run() when the core can't do it.
+ **/
+void runahead_run(unsigned frames, bool secondary);
+
+/**
+ * runahead_deinit:
+ *
+ * Frees run-ahead state, and unloads the secondary
+ * instance of the core if any.
+ **/
+void runahead_deinit(void);
+
+RETRO_END_DECLS
+
+#endif
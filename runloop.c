@@ -69,6 +69,8 @@
 #include "managers/cheat_manager.h"
 #include "managers/state_manager.h"
 #include "list_special.h"
+#include "performance_counters.h"
+#include "runahead.h"
 #include "audio/audio_driver.h"
 #include "camera/camera_driver.h"
 #include "record/record_driver.h"
@@ -552,10 +554,13 @@ bool runloop_ctl(enum runloop_ctl_state state, void *data)
 #ifdef HAVE_THREADS
             settings_t *settings = config_get_ptr();
             bool threaded_enable = settings->threaded_data_runloop_enable;
+            unsigned workers     = settings->threaded_data_runloop_workers;
 #else
             bool threaded_enable = false;
+            unsigned workers     = 1;
 #endif
             task_queue_ctl(TASK_QUEUE_CTL_DEINIT, NULL);
+            task_queue_ctl(TASK_QUEUE_CTL_SET_WORKER_COUNT, &workers);
             task_queue_ctl(TASK_QUEUE_CTL_INIT, &threaded_enable);
          }
          break;
@@ -1113,6 +1118,139 @@ static enum runloop_state runloop_check_state(
 }
 
 
+#define FRAME_PACING_WINDOW 32
+
+/* Minimum safety margin left between the end of a frame's work
+ * and the next VBlank, in microseconds. */
+#define FRAME_PACING_MIN_MARGIN 1000
+
+static struct
+{
+   retro_time_t work[FRAME_PACING_WINDOW];
+   retro_time_t delay;
+   retro_time_t margin;
+   retro_time_t wake;
+   retro_time_t last_present_end;
+   unsigned index;
+   unsigned count;
+   unsigned frames_since_miss;
+} runloop_frame_pacing;
+
+/**
+ * runloop_sleep_until:
+ * @deadline          : time to wake up at.
+ *
+ * Sleeps for the bulk of the wait and spins for the last
+ * millisecond, since the OS timer tends to overshoot.
+ **/
+static void runloop_sleep_until(retro_time_t deadline)
+{
+   retro_time_t remaining = deadline - cpu_features_get_time_usec();
+
+   if (remaining > 2000)
+      retro_sleep((unsigned)((remaining - 1000) / 1000));
+
+   while (cpu_features_get_time_usec() < deadline);
+}
+
+/**
+ * runloop_frame_pacing_wait:
+ *
+ * Automatic frame delay. Waits as long as it is safe to
+ * after the last VBlank before the core runs and polls input.
+ **/
+static void runloop_frame_pacing_wait(void)
+{
+   static struct retro_perf_counter frame_delay_auto = {0};
+   retro_time_t present_end = 0;
+
+   video_driver_get_present_time(NULL, &present_end);
+
+   if (present_end && runloop_frame_pacing.delay > 0)
+      runloop_sleep_until(present_end + runloop_frame_pacing.delay);
+
+   runloop_frame_pacing.wake = cpu_features_get_time_usec();
+
+   performance_counter_init(&frame_delay_auto, "frame_delay_auto");
+   performance_counter_sample(&frame_delay_auto,
+         (retro_perf_tick_t)runloop_frame_pacing.delay);
+}
+
+/**
+ * runloop_frame_pacing_update:
+ *
+ * Records how long the frame took from waking up until it
+ * was presented, and picks the delay for the next frame.
+ **/
+static void runloop_frame_pacing_update(settings_t *settings)
+{
+   static struct retro_perf_counter frame_deadline_miss = {0};
+   unsigned i;
+   retro_time_t present_begin = 0;
+   retro_time_t present_end   = 0;
+   retro_time_t period, work  = 0;
+
+   if (settings->video.refresh_rate <= 0.0f)
+      return;
+
+   video_driver_get_present_time(&present_begin, &present_end);
+
+   /* The core did not present a frame this time. */
+   if (present_end == runloop_frame_pacing.last_present_end
+         || present_begin < runloop_frame_pacing.wake)
+      return;
+
+   period = (retro_time_t)roundf(1000000.0f / settings->video.refresh_rate);
+
+   if (runloop_frame_pacing.margin < FRAME_PACING_MIN_MARGIN)
+      runloop_frame_pacing.margin = FRAME_PACING_MIN_MARGIN;
+
+   performance_counter_init(&frame_deadline_miss, "frame_deadline_miss");
+
+   /* Took longer than a refresh period and a half to get from
+    * one VBlank to the next, so we missed one. Back off.
+    * Much longer gaps come from pausing or the menu. */
+   if (runloop_frame_pacing.last_present_end &&
+         present_end - runloop_frame_pacing.last_present_end
+         > period + period / 2 &&
+         present_end - runloop_frame_pacing.last_present_end
+         < period * 4)
+   {
+      performance_counter_sample(&frame_deadline_miss, 1);
+
+      runloop_frame_pacing.margin += 500;
+      if (runloop_frame_pacing.margin > period / 2)
+         runloop_frame_pacing.margin = period / 2;
+      runloop_frame_pacing.frames_since_miss = 0;
+   }
+   else if (++runloop_frame_pacing.frames_since_miss >= FRAME_PACING_WINDOW)
+   {
+      /* Been fine for a while, win back some latency. */
+      runloop_frame_pacing.margin -= 100;
+      if (runloop_frame_pacing.margin < FRAME_PACING_MIN_MARGIN)
+         runloop_frame_pacing.margin = FRAME_PACING_MIN_MARGIN;
+      runloop_frame_pacing.frames_since_miss = 0;
+   }
+
+   runloop_frame_pacing.last_present_end = present_end;
+
+   runloop_frame_pacing.work[runloop_frame_pacing.index] =
+      present_begin - runloop_frame_pacing.wake;
+   runloop_frame_pacing.index = (runloop_frame_pacing.index + 1)
+      % FRAME_PACING_WINDOW;
+   if (runloop_frame_pacing.count < FRAME_PACING_WINDOW)
+      runloop_frame_pacing.count++;
+
+   /* Plan for the slowest frame in the window. */
+   for (i = 0; i < runloop_frame_pacing.count; i++)
+      if (runloop_frame_pacing.work[i] > work)
+         work = runloop_frame_pacing.work[i];
+
+   runloop_frame_pacing.delay = period - work - runloop_frame_pacing.margin;
+   if (runloop_frame_pacing.delay < 0)
+      runloop_frame_pacing.delay = 0;
+}
+
 /**
  * runloop_iterate:
  *
@@ -1232,11 +1370,22 @@ int runloop_iterate(unsigned *sleep_ms)
             settings->input.analog_dpad_mode[i]);
    }
 
-   if ((settings->video.frame_delay > 0) &&
+   if (settings->video.frame_delay_auto &&
+         !input_driver_is_nonblock_state())
+      runloop_frame_pacing_wait();
+   else if ((settings->video.frame_delay > 0) &&
          !input_driver_is_nonblock_state())
       retro_sleep(settings->video.frame_delay);
 
-   core_run();
+   if (settings->run_ahead_frames > 0)
+      runahead_run(settings->run_ahead_frames,
+            settings->run_ahead_secondary_instance);
+   else
+      core_run();
+
+   if (settings->video.frame_delay_auto &&
+         !input_driver_is_nonblock_state())
+      runloop_frame_pacing_update(settings);
 
 #ifdef HAVE_CHEEVOS
    cheevos_test();
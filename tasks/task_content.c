@@ -55,6 +55,12 @@
 #include <streams/file_stream.h>
 #include <retro_stat.h>
 #include <retro_assert.h>
+#include <memmap.h>
+#include <queues/task_queue.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
 
 #include <lists/string_list.h>
 #include <string/stdstring.h>
@@ -95,6 +101,19 @@
 
 #define MAX_ARGS 32
 
+/* Amount of content checksummed per run of the CRC task. */
+#define CONTENT_CRC_CHUNK_SIZE (4 * 1024 * 1024)
+
+#if defined(HAVE_MMAP) && defined(HAVE_MMAN) && (defined(MAP_ANONYMOUS) || defined(MAP_ANON))
+#define HAVE_CONTENT_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
 typedef struct content_stream
 {
    uint32_t a;
@@ -108,6 +127,35 @@ static bool _content_is_inited                                = false;
 static bool core_does_not_need_content                        = false;
 static uint32_t content_crc                                   = 0;
 
+#ifdef HAVE_CONTENT_MMAP
+/* A read-only mapping of the first content file, kept until
+ * the CRC task, or content_get_crc(), has checksummed it.
+ * The core may write to its own copy, so this is separate. */
+static struct
+{
+   uint8_t *data;
+   size_t size;
+   size_t pos;
+} content_crc_pending;
+
+#ifdef HAVE_THREADS
+static slock_t *content_crc_lock                              = NULL;
+#endif
+
+/* Shared between the CRC task and the main thread. If content is
+ * deinitialized while the task is still queued, the task is
+ * orphaned and takes over freeing the lock it was created with. */
+typedef struct content_crc_task_state
+{
+#ifdef HAVE_THREADS
+   slock_t *lock;
+#endif
+   bool orphaned;
+} content_crc_task_state_t;
+
+static content_crc_task_state_t *content_crc_task             = NULL;
+#endif
+
 /**
  * content_file_read:
  * @path             : path to file.
@@ -132,6 +180,258 @@ static int content_file_read(const char *path, void **buf, ssize_t *length)
    return filestream_read_file(path, buf, length);
 }
 
+#ifdef HAVE_CONTENT_MMAP
+static size_t content_file_map_size(size_t size)
+{
+   size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+   /* One more page, so the content is NUL terminated
+    * just like a buffer from filestream_read_file(). */
+   return (size + page - 1) / page * page + page;
+}
+
+/**
+ * content_file_map:
+ * @path             : path to file.
+ * @buf              : set to a private, copy-on-write mapping
+ *                     of the file. Release with content_file_free().
+ * @length           : size of the file.
+ *
+ * Maps a plain file instead of reading it, so only the parts
+ * the core touches are paged in and nothing is copied.
+ *
+ * Returns: true if the file was mapped.
+ */
+static bool content_file_map(const char *path, void **buf, ssize_t *length)
+{
+   struct stat st;
+   size_t map_size;
+   uint8_t *map = NULL;
+   int fd       = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+      goto error;
+
+   map_size = content_file_map_size((size_t)st.st_size);
+   map      = (uint8_t*)mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (map == MAP_FAILED)
+      goto error;
+
+   if (mmap(map, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+   {
+      munmap(map, map_size);
+      goto error;
+   }
+
+   close(fd);
+
+   *buf    = map;
+   *length = st.st_size;
+   return true;
+
+error:
+   close(fd);
+   return false;
+}
+#endif
+
+static void content_file_free(void *buf, size_t length, bool mapped)
+{
+#ifdef HAVE_CONTENT_MMAP
+   if (mapped)
+   {
+      munmap(buf, content_file_map_size(length));
+      return;
+   }
+#endif
+   free(buf);
+}
+
+#ifdef HAVE_CONTENT_MMAP
+/* Checksums up to @len more bytes of the pending content and
+ * unmaps it once done. Caller holds content_crc_lock.
+ * Returns true when no content is pending anymore. */
+static bool content_crc_step(size_t len)
+{
+   if (!content_crc_pending.data)
+      return true;
+
+   if (len > content_crc_pending.size - content_crc_pending.pos)
+      len = content_crc_pending.size - content_crc_pending.pos;
+
+   content_crc = encoding_crc32(content_crc,
+         content_crc_pending.data + content_crc_pending.pos, len);
+   content_crc_pending.pos += len;
+
+   if (content_crc_pending.pos < content_crc_pending.size)
+      return false;
+
+   RARCH_LOG("CRC32: 0x%x .\n", (unsigned)content_crc);
+
+   munmap(content_crc_pending.data, content_crc_pending.size);
+   content_crc_pending.data = NULL;
+   return true;
+}
+
+static void content_crc_lock_acquire(void)
+{
+#ifdef HAVE_THREADS
+   if (content_crc_lock)
+      slock_lock(content_crc_lock);
+#endif
+}
+
+static void content_crc_lock_release(void)
+{
+#ifdef HAVE_THREADS
+   if (content_crc_lock)
+      slock_unlock(content_crc_lock);
+#endif
+}
+
+static void content_crc_cancel(void)
+{
+   content_crc_lock_acquire();
+   if (content_crc_pending.data)
+      munmap(content_crc_pending.data, content_crc_pending.size);
+   content_crc_pending.data = NULL;
+   content_crc_lock_release();
+}
+
+static void task_content_crc_handler(retro_task_t *task)
+{
+   bool done;
+   bool orphaned;
+   content_crc_task_state_t *state = (content_crc_task_state_t*)task->state;
+
+#ifdef HAVE_THREADS
+   slock_lock(state->lock);
+#endif
+   orphaned = state->orphaned;
+   done     = orphaned || content_crc_step(CONTENT_CRC_CHUNK_SIZE);
+   if (done && !orphaned && content_crc_task == state)
+      content_crc_task = NULL;
+#ifdef HAVE_THREADS
+   slock_unlock(state->lock);
+#endif
+
+   if (!done)
+      return;
+
+#ifdef HAVE_THREADS
+   if (orphaned)
+      slock_free(state->lock);
+#endif
+   free(state);
+   task->finished = true;
+}
+
+/* Called on content deinit, after content_crc_cancel(). */
+static void content_crc_deinit(void)
+{
+   bool orphaned = false;
+
+   content_crc_lock_acquire();
+   if (content_crc_task)
+   {
+      content_crc_task->orphaned = true;
+      content_crc_task           = NULL;
+      orphaned                   = true;
+   }
+   content_crc_lock_release();
+
+#ifdef HAVE_THREADS
+   if (!orphaned && content_crc_lock)
+      slock_free(content_crc_lock);
+   content_crc_lock = NULL;
+#endif
+}
+
+/**
+ * task_push_content_crc:
+ * @path             : path to the first content file.
+ *
+ * Maps the file read-only and checksums it in the background,
+ * so loading does not wait for the whole file to be paged in.
+ *
+ * Returns: true if the checksum was queued.
+ */
+static bool task_push_content_crc(const char *path)
+{
+   struct stat st;
+   retro_task_t *task              = NULL;
+   content_crc_task_state_t *state = NULL;
+   uint8_t *map                    = NULL;
+   int fd                          = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if (fstat(fd, &st) != 0 || st.st_size <= 0)
+   {
+      close(fd);
+      return false;
+   }
+
+   map = (uint8_t*)mmap(NULL, (size_t)st.st_size,
+         PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+
+   if (map == MAP_FAILED)
+      return false;
+
+#ifdef HAVE_THREADS
+   if (!content_crc_lock)
+      content_crc_lock = slock_new();
+#endif
+
+   content_crc_cancel();
+
+   task  = (retro_task_t*)calloc(1, sizeof(*task));
+   state = (content_crc_task_state_t*)calloc(1, sizeof(*state));
+#ifdef HAVE_THREADS
+   if (state)
+      state->lock = content_crc_lock;
+   if (!content_crc_lock)
+   {
+      free(state);
+      state = NULL;
+   }
+#endif
+
+   /* A task for earlier content may still be queued,
+    * in which case it goes on with this content. */
+   content_crc_lock_acquire();
+   content_crc                 = 0;
+   content_crc_pending.data    = map;
+   content_crc_pending.size    = (size_t)st.st_size;
+   content_crc_pending.pos     = 0;
+
+   if (!content_crc_task && task && state)
+   {
+      content_crc_task = state;
+      task->handler    = task_content_crc_handler;
+      task->state      = state;
+      task_queue_ctl(TASK_QUEUE_CTL_PUSH, task);
+      task             = NULL;
+      state            = NULL;
+   }
+   /* Without a task, do it right away. */
+   else if (!content_crc_task)
+      content_crc_step(content_crc_pending.size);
+   content_crc_lock_release();
+
+   free(task);
+   free(state);
+   return true;
+}
+#endif
+
 bool content_push_to_history_playlist(
       void *data,
       const char *path,
@@ -307,20 +607,37 @@ error:
  * @buf          : size   of the content file.
  * @length       : size of the content file that has been read from.
  *
+ * @mapped       : set if the buffer is a file mapping.
+ *
  * Read the content file. If read into memory, also performs soft patching
  * (see patch_content function) in case soft patching has not been
- * blocked by the enduser.
+ * blocked by the enduser. Plain files which are not going to be
+ * patched are mapped instead of read.
  *
  * Returns: true if successful, false on error.
  **/
 static bool load_content_into_memory(unsigned i, const char *path, void **buf,
-      ssize_t *length)
+      ssize_t *length, bool *mapped)
 {
-   uint32_t *content_crc_ptr = NULL;
    uint8_t *ret_buf          = NULL;
+   /* First content file is significant, attempt to do patching. */
+   bool patch                = (i == 0)
+      && !rarch_ctl(RARCH_CTL_IS_PATCH_BLOCKED, NULL);
 
    RARCH_LOG("%s: %s.\n",
          msg_hash_to_str(MSG_LOADING_CONTENT_FILE), path);
+
+   *mapped = false;
+
+#ifdef HAVE_CONTENT_MMAP
+   if (!(patch && patch_content_available())
+#ifdef HAVE_COMPRESSION
+         && !path_contains_compressed_file(path)
+#endif
+         && content_file_map(path, (void**)&ret_buf, length))
+      *mapped = true;
+   else
+#endif
    if (!content_file_read(path, (void**) &ret_buf, length))
       return false;
 
@@ -329,11 +646,24 @@ static bool load_content_into_memory(unsigned i, const char *path, void **buf,
 
    if (i == 0)
    {
-      /* First content file is significant, attempt to do patching,
-       * CRC checking, etc. */
+      uint32_t *content_crc_ptr = NULL;
+
+#ifdef HAVE_CONTENT_MMAP
+      /* Only mapped if there was no patch to apply. */
+      if (patch && *mapped)
+         RARCH_LOG("%s\n",
+               msg_hash_to_str(MSG_DID_NOT_FIND_A_VALID_CONTENT_PATCH));
+
+      /* Nothing was read, so checksum in the background. */
+      if (*mapped && task_push_content_crc(path))
+      {
+         *buf = ret_buf;
+         return true;
+      }
+#endif
 
       /* Attempt to apply a patch. */
-      if (!rarch_ctl(RARCH_CTL_IS_PATCH_BLOCKED, NULL))
+      if (patch && !*mapped)
          patch_content(&ret_buf, length);
 
       content_get_crc(&content_crc_ptr);
@@ -493,6 +823,7 @@ static bool init_content_file_extract(
 static bool load_content(
       struct string_list *temporary_content,
       struct retro_game_info *info,
+      bool *mapped,
       const struct string_list *content,
       const struct retro_subsystem_info *special
       )
@@ -529,7 +860,8 @@ static bool load_content(
 
          ssize_t len = 0;
 
-         if (!load_content_into_memory(i, path, (void**)&info[i].data, &len))
+         if (!load_content_into_memory(i, path,
+                  (void**)&info[i].data, &len, &mapped[i]))
          {
             RARCH_ERR("%s \"%s\".\n",
                   msg_hash_to_str(MSG_COULD_NOT_READ_CONTENT_FILE),
@@ -715,6 +1047,7 @@ static bool init_content_file_set_attribs(
 static bool content_file_init(struct string_list *temporary_content)
 {
    struct retro_game_info               *info = NULL;
+   bool                               *mapped = NULL;
    struct string_list *content                = NULL;
    bool ret                                   = false;
    const struct retro_subsystem_info *special = init_content_file_subsystem(&ret);
@@ -733,18 +1066,22 @@ static bool content_file_init(struct string_list *temporary_content)
 
    info                   = (struct retro_game_info*)
       calloc(content->size, sizeof(*info));
+   mapped                 = (bool*)calloc(content->size, sizeof(*mapped));
 
-   if (info)
+   if (info && mapped)
    {
       unsigned i;
-      ret = load_content(temporary_content, info, content, special);
+      ret = load_content(temporary_content, info, mapped, content, special);
 
       for (i = 0; i < content->size; i++)
-         free((void*)info[i].data);
-
-      free(info);
+         if (info[i].data)
+            content_file_free((void*)info[i].data,
+                  info[i].size, mapped[i]);
    }
 
+   free(info);
+   free(mapped);
+
 error:
    if (content)
       string_list_free(content);
@@ -770,6 +1107,14 @@ bool content_get_crc(uint32_t **content_crc_ptr)
 {
    if (!content_crc_ptr)
       return false;
+
+#ifdef HAVE_CONTENT_MMAP
+   /* Finish the checksum if the task has not gotten to it yet. */
+   content_crc_lock_acquire();
+   content_crc_step((size_t)-1);
+   content_crc_lock_release();
+#endif
+
    *content_crc_ptr = &content_crc;
    return true;
 }
@@ -799,6 +1144,11 @@ void content_deinit(void)
       string_list_free(temporary_content);
    }
 
+#ifdef HAVE_CONTENT_MMAP
+   content_crc_cancel();
+   content_crc_deinit();
+#endif
+
    temporary_content          = NULL;
    content_crc                = 0;
    _content_is_inited         = false;
@@ -230,6 +230,58 @@ static int database_info_list_iterate_new(database_state_handle_t *db_state,
    return 0;
 }
 
+/* Playlists stay loaded for the whole scan, so a match
+ * neither parses the file again nor writes it. New entries
+ * are appended to the files once the scan ends. */
+static playlist_t *task_database_get_playlist(
+      database_state_handle_t *db_state, const char *path)
+{
+   int idx;
+   union string_list_elem_attr attr;
+
+   if (!db_state->playlists)
+      db_state->playlists = string_list_new();
+   if (!db_state->playlists)
+      return NULL;
+
+   idx = string_list_find_elem(db_state->playlists, path);
+   if (idx > 0)
+      return (playlist_t*)db_state->playlists->elems[idx - 1].attr.p;
+
+   attr.p = playlist_init(path, COLLECTION_SIZE);
+   if (!attr.p)
+      return NULL;
+
+   if (!string_list_append(db_state->playlists, path, attr))
+   {
+      playlist_free((playlist_t*)attr.p);
+      return NULL;
+   }
+
+   return (playlist_t*)attr.p;
+}
+
+static void task_database_free_playlists(
+      database_state_handle_t *db_state)
+{
+   size_t i;
+
+   if (!db_state->playlists)
+      return;
+
+   for (i = 0; i < db_state->playlists->size; i++)
+   {
+      playlist_t *playlist = (playlist_t*)
+         db_state->playlists->elems[i].attr.p;
+
+      playlist_write_file(playlist);
+      playlist_free(playlist);
+   }
+
+   string_list_free(db_state->playlists);
+   db_state->playlists = NULL;
+}
+
 static int database_info_list_iterate_found_match(
       database_state_handle_t *db_state,
       database_info_handle_t *db,
@@ -263,8 +315,7 @@ static int database_info_list_iterate_found_match(
    fill_pathname_join(db_playlist_path, settings->directory.playlist,
          db_playlist_base_str, sizeof(db_playlist_path));
 
-   playlist = playlist_init(db_playlist_path, COLLECTION_SIZE);
-
+   playlist = task_database_get_playlist(db_state, db_playlist_path);
 
    snprintf(db_crc, sizeof(db_crc), "%08X|crc", db_info_entry->crc32);
 
@@ -287,17 +338,12 @@ static int database_info_list_iterate_found_match(
    RARCH_LOG("entry path str: %s\n", entry_path_str);
 #endif
 
-   if(!playlist_entry_exists(playlist, entry_path_str, db_crc))
-   {
-      playlist_push(playlist, entry_path_str,
+   if (playlist && !playlist_entry_exists(playlist, entry_path_str, db_crc))
+      playlist_append(playlist, entry_path_str,
             db_info_entry->name,
             file_path_str(FILE_PATH_DETECT),
             file_path_str(FILE_PATH_DETECT),
             db_crc, db_playlist_base_str);
-   }
-
-   playlist_write_file(playlist);
-   playlist_free(playlist);
 
    database_info_list_free(db_state->info);
    free(db_state->info);
@@ -324,12 +370,90 @@ static int database_info_list_iterate_next(
    return 1;
 }
 
+static bool task_database_index_supports_content(
+      database_state_handle_t *db_state, unsigned db_index,
+      const char *name)
+{
+   if (core_info_database_supports_content_path(
+            db_state->list->elems[db_index].data, name))
+      return true;
+   return core_info_unsupported_content_path(name);
+}
+
+/* Resolves a CRC lookup through the global index. Matches come in
+ * entry order, so the first entry matching either CRC is the one the
+ * linear scan below reaches first. If both CRCs match the same entry,
+ * the archive CRC wins, as it does there. */
+static int task_database_iterate_crc_index(
+      database_state_handle_t *db_state,
+      database_info_handle_t *db,
+      const char *name,
+      const char *archive_entry)
+{
+   const database_index_entry_t *entry = NULL;
+   const database_index_entry_t *match = NULL;
+   const char *match_archive           = NULL;
+   unsigned match_db                   = 0;
+
+   for (entry = database_index_find_crc(db_state->index,
+            db_state->archive_crc, NULL); entry;
+         entry = database_index_find_crc(db_state->index,
+            db_state->archive_crc, entry))
+   {
+      if (task_database_index_supports_content(db_state,
+               database_index_entry_get_db(entry), name))
+      {
+         match         = entry;
+         break;
+      }
+   }
+
+   /* Entries are one array, later ones sit at higher addresses. */
+   for (entry = database_index_find_crc(db_state->index,
+            db_state->crc, NULL); entry && (!match || entry < match);
+         entry = database_index_find_crc(db_state->index,
+            db_state->crc, entry))
+   {
+      if (task_database_index_supports_content(db_state,
+               database_index_entry_get_db(entry), name))
+      {
+         match         = entry;
+         match_archive = archive_entry;
+         break;
+      }
+   }
+
+   if (!match)
+      return database_info_list_iterate_end_no_match(db_state);
+
+   match_db = database_index_entry_get_db(match);
+
+   if (db_state->info)
+   {
+      database_info_list_free(db_state->info);
+      free(db_state->info);
+   }
+
+   db_state->list_index  = match_db;
+   db_state->entry_index = 0;
+   db_state->info        = database_index_entry_to_list(
+         db_state->index, match);
+
+   if (!db_state->info)
+      return database_info_list_iterate_end_no_match(db_state);
+
+   return database_info_list_iterate_found_match(db_state, db, match_archive);
+}
+
 static int task_database_iterate_crc_lookup(
       database_state_handle_t *db_state,
       database_info_handle_t *db,
       const char *name,
       const char *archive_entry)
 {
+   if (db_state->index && db_state->list)
+      return task_database_iterate_crc_index(
+            db_state, db, name, archive_entry);
 
    if (!db_state->list ||
          (unsigned)db_state->list_index == (unsigned)db_state->list->size)
@@ -429,9 +553,10 @@ static int task_database_iterate_playlist_lutro(
          file_path_str(FILE_PATH_LUTRO_PLAYLIST),
          sizeof(db_playlist_path));
 
-   playlist = playlist_init(db_playlist_path, COLLECTION_SIZE);
+   playlist = task_database_get_playlist(db_state, db_playlist_path);
 
-   if(!playlist_entry_exists(playlist, path, file_path_str(FILE_PATH_DETECT)))
+   if (playlist && !playlist_entry_exists(playlist, path,
+            file_path_str(FILE_PATH_DETECT)))
    {
       char game_title[PATH_MAX_LENGTH];
 
@@ -440,7 +565,7 @@ static int task_database_iterate_playlist_lutro(
       fill_short_pathname_representation_noext(game_title,
             path, sizeof(game_title));
 
-      playlist_push(playlist, path,
+      playlist_append(playlist, path,
             game_title,
             file_path_str(FILE_PATH_DETECT),
             file_path_str(FILE_PATH_DETECT),
@@ -448,17 +573,48 @@ static int task_database_iterate_playlist_lutro(
             file_path_str(FILE_PATH_LUTRO_PLAYLIST));
    }
 
-   playlist_write_file(playlist);
-   playlist_free(playlist);
-
    return 0;
 }
 
 
+static int task_database_iterate_serial_index(
+      database_state_handle_t *db_state,
+      database_info_handle_t *db)
+{
+   unsigned match_db                   = 0;
+   /* The first match is the earliest entry, as in the linear scan. */
+   const database_index_entry_t *match = database_index_find_serial(
+         db_state->index, db_state->serial, NULL);
+
+   if (!match)
+      return database_info_list_iterate_end_no_match(db_state);
+
+   match_db = database_index_entry_get_db(match);
+
+   if (db_state->info)
+   {
+      database_info_list_free(db_state->info);
+      free(db_state->info);
+   }
+
+   db_state->list_index  = match_db;
+   db_state->entry_index = 0;
+   db_state->info        = database_index_entry_to_list(
+         db_state->index, match);
+
+   if (!db_state->info)
+      return database_info_list_iterate_end_no_match(db_state);
+
+   return database_info_list_iterate_found_match(db_state, db, NULL);
+}
+
 static int task_database_iterate_serial_lookup(
       database_state_handle_t *db_state,
       database_info_handle_t *db, const char *name)
 {
+   if (db_state->index && db_state->list)
+      return task_database_iterate_serial_index(db_state, db);
+
    if (!db_state->list ||
          (unsigned)db_state->list_index == (unsigned)db_state->list->size)
       return database_info_list_iterate_end_no_match(db_state);
@@ -588,6 +744,23 @@ static void task_database_handler(retro_task_t *task)
             dbstate->list        = dir_list_new_special(
                   settings->path.content_database,
                   DIR_LIST_DATABASES, NULL);
+
+            if (dbstate->list && !dbstate->index)
+            {
+               char index_path[PATH_MAX_LENGTH];
+
+               index_path[0] = '\0';
+
+               fill_pathname_join(index_path,
+                     string_is_empty(settings->directory.cache) ?
+                     settings->path.content_database :
+                     settings->directory.cache,
+                     file_path_str(FILE_PATH_DATABASE_INDEX),
+                     sizeof(index_path));
+
+               dbstate->index = database_index_new(dbstate->list,
+                     index_path);
+            }
          }
          dbinfo->status = DATABASE_STATUS_ITERATE_START;
          break;
@@ -634,6 +807,9 @@ task_finished:
    {
       if (dbstate->list)
          dir_list_free(dbstate->list);
+      if (dbstate->index)
+         database_index_free(dbstate->index);
+      task_database_free_playlists(dbstate);
    }
 
    if (db)
@@ -285,6 +285,7 @@ void *task_push_http_transfer(const char *url, bool mute, const char *type,
       goto error;
 
    t->handler              = task_http_transfer_handler;
+   t->affinity             = TASK_AFFINITY_IO;
    t->state                = http;
    t->mute                 = mute;
    t->callback             = cb;
@@ -365,6 +365,7 @@ bool task_push_image_load(const char *fullpath,
 
    t->state     = nbio;
    t->handler   = task_file_load_handler;
+   t->affinity  = TASK_AFFINITY_IO;
    t->cleanup   = task_image_load_free;
    t->callback  = cb;
    t->user_data = user_data;
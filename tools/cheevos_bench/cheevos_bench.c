@@ -0,0 +1,797 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays a memory trace through the achievement conditions and
+ * prints what testing them costs per frame, once with the compiled
+ * evaluator and once with a plain interpreter which looks up every
+ * operand in memory, like cheevos.c used to. Both must trigger the
+ * same achievements on the same frames.
+ *
+ * Usage: cheevos_bench [trace]
+ *
+ * Traces are recorded by building RetroArch with CHEEVOS_TRACE
+ * defined in cheevos.c. Without one, a made up set of achievements
+ * over a 64 KiB bank is used. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <features/features_cpu.h>
+
+#include "cheevos_eval.h"
+
+#define BENCH_RUNS        3
+#define BENCH_MAX_BANKS   64
+
+#define SYNTH_CHEEVOS     150
+#define SYNTH_HOT_BYTES   400
+#define SYNTH_FRAMES      3600
+#define SYNTH_BANK_SIZE   0x10000
+
+typedef struct
+{
+   cheevos_cond_t *conds;
+   unsigned count;
+} bench_condset_t;
+
+typedef struct
+{
+   bench_condset_t *condsets;
+   unsigned count;
+} bench_cheevo_t;
+
+typedef struct
+{
+   bench_cheevo_t *cheevos;
+   unsigned count;
+
+   uint8_t *frames;
+   size_t frame_size;
+   unsigned frame_count;
+
+   uint8_t *banks[BENCH_MAX_BANKS];
+   size_t bank_sizes[BENCH_MAX_BANKS];
+} bench_game_t;
+
+/* State of the interpreter, which cheevos_cond_t doesn't hold. */
+typedef struct
+{
+   const cheevos_cond_t *cond;
+   unsigned curr_hits;
+   unsigned source_previous;
+   unsigned target_previous;
+} bench_ref_cond_t;
+
+static bench_game_t game;
+
+static uint8_t *bench_get_memory(const cheevos_var_t *var)
+{
+   if (var->bank_id < 0 || var->bank_id >= BENCH_MAX_BANKS
+         || !game.banks[var->bank_id])
+      return NULL;
+
+   return game.banks[var->bank_id] + var->value;
+}
+
+/* Kept out of line so every operand pays for a call, as it did. */
+static uint8_t *(*volatile bench_lookup)(const cheevos_var_t *) =
+   bench_get_memory;
+
+/*****************************************************************************
+The interpreter.
+*****************************************************************************/
+
+static unsigned bench_ref_var(const cheevos_var_t *var, unsigned *previous)
+{
+   const uint8_t *memory;
+   unsigned live_val = 0;
+
+   if (var->type == CHEEVOS_VAR_TYPE_VALUE_COMP)
+      return var->value;
+
+   if (     var->type != CHEEVOS_VAR_TYPE_ADDRESS
+         && var->type != CHEEVOS_VAR_TYPE_DELTA_MEM)
+      return 0;
+
+   memory = bench_lookup(var);
+
+   if (memory)
+   {
+      live_val = memory[0];
+
+      switch (var->size)
+      {
+         case CHEEVOS_VAR_SIZE_NIBBLE_LOWER:
+            live_val &= 0x0f;
+            break;
+         case CHEEVOS_VAR_SIZE_NIBBLE_UPPER:
+            live_val = (live_val >> 4) & 0x0f;
+            break;
+         case CHEEVOS_VAR_SIZE_EIGHT_BITS:
+            break;
+         case CHEEVOS_VAR_SIZE_SIXTEEN_BITS:
+            live_val |= memory[1] << 8;
+            break;
+         case CHEEVOS_VAR_SIZE_THIRTYTWO_BITS:
+            live_val |= memory[1] << 8;
+            live_val |= memory[2] << 16;
+            live_val |= (unsigned)memory[3] << 24;
+            break;
+         default:
+            live_val = (live_val >> (var->size - CHEEVOS_VAR_SIZE_BIT_0)) & 1;
+            break;
+      }
+   }
+
+   if (var->type == CHEEVOS_VAR_TYPE_DELTA_MEM)
+   {
+      unsigned prev = *previous;
+      *previous     = live_val;
+      return prev;
+   }
+
+   return live_val;
+}
+
+static int bench_ref_test_cond(bench_ref_cond_t *ref)
+{
+   unsigned sval = bench_ref_var(&ref->cond->source, &ref->source_previous);
+   unsigned tval = bench_ref_var(&ref->cond->target, &ref->target_previous);
+
+   switch (ref->cond->op)
+   {
+      case CHEEVOS_COND_OP_EQUALS:
+         return sval == tval;
+      case CHEEVOS_COND_OP_LESS_THAN:
+         return sval < tval;
+      case CHEEVOS_COND_OP_LESS_THAN_OR_EQUAL:
+         return sval <= tval;
+      case CHEEVOS_COND_OP_GREATER_THAN:
+         return sval > tval;
+      case CHEEVOS_COND_OP_GREATER_THAN_OR_EQUAL:
+         return sval >= tval;
+      case CHEEVOS_COND_OP_NOT_EQUAL_TO:
+         return sval != tval;
+      default:
+         break;
+   }
+
+   return 1;
+}
+
+static int bench_ref_test_set(bench_ref_cond_t *conds, unsigned count,
+      int *dirty, int *reset)
+{
+   unsigned i;
+   int set_valid = 1;
+
+   for (i = 0; i < count; i++)
+   {
+      if (conds[i].cond->type != CHEEVOS_COND_TYPE_PAUSE_IF)
+         continue;
+
+      conds[i].curr_hits = 0;
+
+      if (bench_ref_test_cond(conds + i))
+      {
+         conds[i].curr_hits = 1;
+         *dirty = 1;
+         return 0;
+      }
+   }
+
+   for (i = 0; i < count; i++)
+   {
+      int valid;
+      bench_ref_cond_t *ref = conds + i;
+
+      if (ref->cond->type != CHEEVOS_COND_TYPE_STANDARD)
+         continue;
+
+      if (ref->cond->req_hits != 0 && ref->curr_hits >= ref->cond->req_hits)
+         continue;
+
+      valid = bench_ref_test_cond(ref);
+
+      if (valid)
+      {
+         ref->curr_hits++;
+         *dirty = 1;
+
+         if (ref->cond->req_hits != 0 && ref->curr_hits < ref->cond->req_hits)
+            valid = 0;
+      }
+
+      set_valid &= valid;
+   }
+
+   for (i = 0; i < count; i++)
+   {
+      if (     conds[i].cond->type == CHEEVOS_COND_TYPE_RESET_IF
+            && bench_ref_test_cond(conds + i))
+      {
+         *reset = 1;
+         return 0;
+      }
+   }
+
+   return set_valid;
+}
+
+static bool bench_ref_test(bench_ref_cond_t **sets,
+      const bench_cheevo_t *cheevo, bool *dirty_out)
+{
+   unsigned i, j;
+   int dirty = 0, reset = 0, valid = 0;
+   int alt   = cheevo->count == 1;
+
+   for (i = 0; i < cheevo->count; i++)
+   {
+      int res = bench_ref_test_set(sets[i], cheevo->condsets[i].count,
+            &dirty, &reset);
+
+      if (i == 0)
+         valid = res;
+      else
+         alt  |= res;
+   }
+
+   if (reset)
+   {
+      for (i = 0; i < cheevo->count; i++)
+      {
+         for (j = 0; j < cheevo->condsets[i].count; j++)
+         {
+            dirty |= sets[i][j].curr_hits != 0;
+            sets[i][j].curr_hits = 0;
+         }
+      }
+   }
+
+   *dirty_out = dirty != 0;
+   return valid && alt;
+}
+
+/*****************************************************************************
+Loading traces.
+*****************************************************************************/
+
+static bool bench_read(FILE *file, uint32_t *value)
+{
+   return fread(value, sizeof(*value), 1, file) == 1;
+}
+
+static bool bench_read_var(FILE *file, cheevos_var_t *var)
+{
+   uint32_t size, type, bank_id, value;
+
+   if (     !bench_read(file, &size) || !bench_read(file, &type)
+         || !bench_read(file, &bank_id) || !bench_read(file, &value))
+      return false;
+
+   var->size    = size;
+   var->type    = type;
+   var->bank_id = (int32_t)bank_id;
+   var->value   = value;
+   return true;
+}
+
+static size_t bench_var_frame_size(const cheevos_var_t *var)
+{
+   unsigned width = cheevos_eval_var_width(var);
+
+   /* Make room in the bank for the bytes it reads. */
+   if (width && var->bank_id >= 0 && var->bank_id < BENCH_MAX_BANKS
+         && var->value + width > game.bank_sizes[var->bank_id])
+      game.bank_sizes[var->bank_id] = var->value + width;
+
+   return width;
+}
+
+static bool bench_alloc_banks(void)
+{
+   unsigned i;
+
+   for (i = 0; i < BENCH_MAX_BANKS; i++)
+   {
+      if (!game.bank_sizes[i])
+         continue;
+
+      game.banks[i] = (uint8_t*)calloc(game.bank_sizes[i], 1);
+
+      if (!game.banks[i])
+         return false;
+   }
+
+   return true;
+}
+
+static bool bench_load(const char *path)
+{
+   uint32_t magic, version, count;
+   unsigned i, j, k;
+   long start, end;
+   FILE *file = fopen(path, "rb");
+
+   if (!file)
+      return false;
+
+   if (     !bench_read(file, &magic) || magic != CHEEVOS_TRACE_MAGIC
+         || !bench_read(file, &version) || version != CHEEVOS_TRACE_VERSION
+         || !bench_read(file, &count))
+      goto error;
+
+   game.count   = count;
+   game.cheevos = (bench_cheevo_t*)calloc(count, sizeof(*game.cheevos));
+
+   if (!game.cheevos)
+      goto error;
+
+   for (i = 0; i < game.count; i++)
+   {
+      bench_cheevo_t *cheevo = game.cheevos + i;
+
+      if (!bench_read(file, &count))
+         goto error;
+
+      cheevo->count    = count;
+      cheevo->condsets = (bench_condset_t*)calloc(count + 1,
+            sizeof(*cheevo->condsets));
+
+      if (!cheevo->condsets)
+         goto error;
+
+      for (j = 0; j < cheevo->count; j++)
+      {
+         bench_condset_t *set = cheevo->condsets + j;
+
+         if (!bench_read(file, &count))
+            goto error;
+
+         set->count = count;
+         set->conds = (cheevos_cond_t*)calloc(count + 1, sizeof(*set->conds));
+
+         if (!set->conds)
+            goto error;
+
+         for (k = 0; k < set->count; k++)
+         {
+            uint32_t type, req_hits, op;
+            cheevos_cond_t *cond = set->conds + k;
+
+            if (     !bench_read(file, &type) || !bench_read(file, &req_hits)
+                  || !bench_read(file, &op)
+                  || !bench_read_var(file, &cond->source)
+                  || !bench_read_var(file, &cond->target))
+               goto error;
+
+            cond->type      = type;
+            cond->req_hits  = req_hits;
+            cond->op        = op;
+            game.frame_size += bench_var_frame_size(&cond->source);
+            game.frame_size += bench_var_frame_size(&cond->target);
+         }
+      }
+   }
+
+   start = ftell(file);
+   fseek(file, 0, SEEK_END);
+   end   = ftell(file);
+   fseek(file, start, SEEK_SET);
+
+   if (!game.frame_size)
+      goto error;
+
+   game.frame_count = (unsigned)((end - start) / game.frame_size);
+   game.frames      = (uint8_t*)malloc(game.frame_count * game.frame_size + 1);
+
+   if (!game.frames || fread(game.frames, game.frame_size,
+            game.frame_count, file) != game.frame_count)
+      goto error;
+
+   fclose(file);
+   return bench_alloc_banks();
+
+error:
+   fclose(file);
+   return false;
+}
+
+/*****************************************************************************
+Made up achievements.
+*****************************************************************************/
+
+static uint32_t bench_seed = 0x12345678;
+
+static uint32_t bench_rand(void)
+{
+   bench_seed = bench_seed * 1664525 + 1013904223;
+   return bench_seed >> 8;
+}
+
+static void bench_synth_var(cheevos_var_t *var, const unsigned *hot)
+{
+   static const unsigned sizes[] =
+   {
+      CHEEVOS_VAR_SIZE_EIGHT_BITS, CHEEVOS_VAR_SIZE_EIGHT_BITS,
+      CHEEVOS_VAR_SIZE_EIGHT_BITS, CHEEVOS_VAR_SIZE_SIXTEEN_BITS,
+      CHEEVOS_VAR_SIZE_SIXTEEN_BITS, CHEEVOS_VAR_SIZE_THIRTYTWO_BITS,
+      CHEEVOS_VAR_SIZE_BIT_0, CHEEVOS_VAR_SIZE_BIT_3,
+      CHEEVOS_VAR_SIZE_NIBBLE_LOWER, CHEEVOS_VAR_SIZE_NIBBLE_UPPER,
+   };
+
+   var->size    = sizes[bench_rand() % (sizeof(sizes) / sizeof(sizes[0]))];
+   var->type    = bench_rand() % 4 ? CHEEVOS_VAR_TYPE_ADDRESS
+      : CHEEVOS_VAR_TYPE_DELTA_MEM;
+   var->bank_id = 0;
+   var->value   = hot[bench_rand() % SYNTH_HOT_BYTES];
+}
+
+static void bench_synth_set(bench_condset_t *set, unsigned count,
+      const unsigned *hot)
+{
+   unsigned i;
+
+   set->count = count;
+   set->conds = (cheevos_cond_t*)calloc(count, sizeof(*set->conds));
+
+   for (i = 0; i < count; i++)
+   {
+      cheevos_cond_t *cond = set->conds + i;
+      unsigned kind        = bench_rand() % 16;
+
+      cond->type     = kind == 0 ? CHEEVOS_COND_TYPE_PAUSE_IF
+         : kind == 1 ? CHEEVOS_COND_TYPE_RESET_IF
+         : CHEEVOS_COND_TYPE_STANDARD;
+      cond->req_hits = bench_rand() % 8 == 0 ? 1 + bench_rand() % 60 : 0;
+      cond->op       = bench_rand() % CHEEVOS_COND_OP_LAST;
+
+      bench_synth_var(&cond->source, hot);
+
+      if (bench_rand() % 3)
+      {
+         cond->target.type  = CHEEVOS_VAR_TYPE_VALUE_COMP;
+         cond->target.value = bench_rand() % 8;
+      }
+      else
+         bench_synth_var(&cond->target, hot);
+   }
+}
+
+static void bench_synth_frame_var(const cheevos_var_t *var, uint8_t **out)
+{
+   unsigned width = cheevos_eval_var_width(var);
+
+   memcpy(*out, game.banks[0] + var->value, width);
+   *out += width;
+}
+
+static bool bench_synth(void)
+{
+   unsigned i, j, k, frame;
+   unsigned hot[SYNTH_HOT_BYTES];
+
+   /* Games keep their state in a small part of the memory. */
+   for (i = 0; i < SYNTH_HOT_BYTES; i++)
+      hot[i] = 0x100 + (bench_rand() % 0x2000) * 4;
+
+   game.count   = SYNTH_CHEEVOS;
+   game.cheevos = (bench_cheevo_t*)calloc(game.count, sizeof(*game.cheevos));
+
+   if (!game.cheevos)
+      return false;
+
+   for (i = 0; i < game.count; i++)
+   {
+      bench_cheevo_t *cheevo = game.cheevos + i;
+
+      cheevo->count    = bench_rand() % 4 == 0 ? 3 : 1;
+      cheevo->condsets = (bench_condset_t*)calloc(cheevo->count,
+            sizeof(*cheevo->condsets));
+
+      for (j = 0; j < cheevo->count; j++)
+      {
+         bench_synth_set(cheevo->condsets + j,
+               j ? 2 + bench_rand() % 3 : 6 + bench_rand() % 8, hot);
+
+         for (k = 0; k < cheevo->condsets[j].count; k++)
+         {
+            game.frame_size += bench_var_frame_size(
+                  &cheevo->condsets[j].conds[k].source);
+            game.frame_size += bench_var_frame_size(
+                  &cheevo->condsets[j].conds[k].target);
+         }
+      }
+   }
+
+   game.bank_sizes[0] = SYNTH_BANK_SIZE;
+   game.frame_count   = SYNTH_FRAMES;
+   game.frames        = (uint8_t*)malloc(game.frame_count * game.frame_size);
+
+   if (!game.frames || !bench_alloc_banks())
+      return false;
+
+   /* A handful of bytes change every frame, mostly by small steps. */
+   for (frame = 0; frame < game.frame_count; frame++)
+   {
+      uint8_t *out = game.frames + frame * game.frame_size;
+
+      for (i = 0; i < 16; i++)
+      {
+         uint8_t *byte = game.banks[0] + hot[bench_rand() % SYNTH_HOT_BYTES];
+         *byte = bench_rand() % 4 ? *byte + 1 : bench_rand() % 8;
+      }
+
+      for (i = 0; i < game.count; i++)
+      {
+         const bench_cheevo_t *cheevo = game.cheevos + i;
+
+         for (j = 0; j < cheevo->count; j++)
+         {
+            for (k = 0; k < cheevo->condsets[j].count; k++)
+            {
+               bench_synth_frame_var(&cheevo->condsets[j].conds[k].source, &out);
+               bench_synth_frame_var(&cheevo->condsets[j].conds[k].target, &out);
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+/*****************************************************************************
+Replaying.
+*****************************************************************************/
+
+static void bench_scatter_var(const cheevos_var_t *var, const uint8_t **in)
+{
+   unsigned width  = cheevos_eval_var_width(var);
+   uint8_t *memory = width ? bench_get_memory(var) : NULL;
+
+   if (memory)
+      memcpy(memory, *in, width);
+   *in += width;
+}
+
+/* Puts the bytes of a frame back where the conditions read them. */
+static void bench_scatter(unsigned frame)
+{
+   unsigned i, j, k;
+   const uint8_t *in = game.frames + (size_t)frame * game.frame_size;
+
+   for (i = 0; i < game.count; i++)
+   {
+      const bench_cheevo_t *cheevo = game.cheevos + i;
+
+      for (j = 0; j < cheevo->count; j++)
+      {
+         for (k = 0; k < cheevo->condsets[j].count; k++)
+         {
+            bench_scatter_var(&cheevo->condsets[j].conds[k].source, &in);
+            bench_scatter_var(&cheevo->condsets[j].conds[k].target, &in);
+         }
+      }
+   }
+}
+
+static cheevos_eval_t *bench_compile(void)
+{
+   unsigned i, j;
+   cheevos_eval_t *eval = cheevos_eval_new(bench_get_memory);
+
+   if (!eval)
+      return NULL;
+
+   for (i = 0; i < game.count; i++)
+   {
+      cheevos_eval_add_cheevo(eval);
+
+      for (j = 0; j < game.cheevos[i].count; j++)
+         if (!cheevos_eval_add_condset(eval, game.cheevos[i].condsets[j].conds,
+                  game.cheevos[i].condsets[j].count))
+            goto error;
+   }
+
+   if (cheevos_eval_compile(eval))
+      return eval;
+
+error:
+   cheevos_eval_free(eval);
+   return NULL;
+}
+
+static bench_ref_cond_t ***bench_ref_new(void)
+{
+   unsigned i, j, k;
+   bench_ref_cond_t ***refs = (bench_ref_cond_t***)calloc(game.count,
+         sizeof(*refs));
+
+   for (i = 0; i < game.count; i++)
+   {
+      const bench_cheevo_t *cheevo = game.cheevos + i;
+
+      refs[i] = (bench_ref_cond_t**)calloc(cheevo->count + 1, sizeof(**refs));
+
+      for (j = 0; j < cheevo->count; j++)
+      {
+         refs[i][j] = (bench_ref_cond_t*)calloc(
+               cheevo->condsets[j].count + 1, sizeof(***refs));
+
+         for (k = 0; k < cheevo->condsets[j].count; k++)
+            refs[i][j][k].cond = cheevo->condsets[j].conds + k;
+      }
+   }
+
+   return refs;
+}
+
+static void bench_ref_free(bench_ref_cond_t ***refs)
+{
+   unsigned i, j;
+
+   for (i = 0; i < game.count; i++)
+   {
+      for (j = 0; j < game.cheevos[i].count; j++)
+         free(refs[i][j]);
+      free(refs[i]);
+   }
+
+   free(refs);
+}
+
+/* Runs the whole trace, returns the time taken in microseconds.
+ * mode 0 only replays the memory, 1 interprets and 2 evaluates
+ * the compiled conditions. Triggers are recorded as frame + 1. */
+static retro_time_t bench_replay(int mode, unsigned *triggers,
+      unsigned *dirty_frames)
+{
+   unsigned frame, i;
+   retro_time_t start;
+   bench_ref_cond_t ***refs = mode == 1 ? bench_ref_new() : NULL;
+   cheevos_eval_t *eval     = mode == 2 ? bench_compile() : NULL;
+   bool *active             = (bool*)malloc(game.count * sizeof(bool));
+
+   for (i = 0; i < game.count; i++)
+   {
+      active[i]   = true;
+      triggers[i] = 0;
+   }
+
+   *dirty_frames = 0;
+
+   for (i = 0; i < BENCH_MAX_BANKS; i++)
+      if (game.banks[i])
+         memset(game.banks[i], 0, game.bank_sizes[i]);
+
+   start = cpu_features_get_time_usec();
+
+   for (frame = 0; frame < game.frame_count; frame++)
+   {
+      bench_scatter(frame);
+
+      if (eval)
+         cheevos_eval_snapshot(eval);
+
+      if (!mode)
+         continue;
+
+      for (i = 0; i < game.count; i++)
+      {
+         bool dirty = false;
+         bool valid;
+
+         if (!active[i])
+            continue;
+
+         if (eval)
+            valid = cheevos_eval_test(eval, i, &dirty);
+         else
+            valid = bench_ref_test(refs[i], game.cheevos + i, &dirty);
+
+         *dirty_frames += dirty;
+
+         if (valid)
+         {
+            active[i]   = false;
+            triggers[i] = frame + 1;
+         }
+      }
+   }
+
+   start = cpu_features_get_time_usec() - start;
+
+   if (refs)
+      bench_ref_free(refs);
+   cheevos_eval_free(eval);
+   free(active);
+
+   return start;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j, run;
+   unsigned conds = 0, unlocked = 0;
+   unsigned ref_dirty, eval_dirty;
+   unsigned *ref_triggers, *eval_triggers;
+   retro_time_t best[3];
+   bool same = true;
+
+   if (argc >= 2)
+   {
+      if (!bench_load(argv[1]))
+      {
+         fprintf(stderr, "Failed to load trace %s.\n", argv[1]);
+         return 1;
+      }
+   }
+   else if (!bench_synth())
+   {
+      fprintf(stderr, "Out of memory.\n");
+      return 1;
+   }
+
+   for (i = 0; i < game.count; i++)
+      for (j = 0; j < game.cheevos[i].count; j++)
+         conds += game.cheevos[i].condsets[j].count;
+
+   ref_triggers  = (unsigned*)calloc(game.count + 1, sizeof(unsigned));
+   eval_triggers = (unsigned*)calloc(game.count + 1, sizeof(unsigned));
+
+   if (!ref_triggers || !eval_triggers)
+      return 1;
+
+   for (i = 0; i < 3; i++)
+   {
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+         unsigned *triggers = i == 2 ? eval_triggers : ref_triggers;
+         unsigned *dirty    = i == 2 ? &eval_dirty : &ref_dirty;
+         retro_time_t usec  = bench_replay((int)i, triggers, dirty);
+
+         if (!run || usec < best[i])
+            best[i] = usec;
+      }
+   }
+
+   for (i = 0; i < game.count; i++)
+   {
+      unlocked += ref_triggers[i] != 0;
+
+      if (ref_triggers[i] != eval_triggers[i])
+      {
+         printf("achievement %u: triggered on frame %u, compiled on %u\n",
+               i, ref_triggers[i], eval_triggers[i]);
+         same = false;
+      }
+   }
+
+   if (ref_dirty != eval_dirty)
+      same = false;
+
+   printf("%u achievements, %u conditions, %u frames, %u unlocked\n",
+         game.count, conds, game.frame_count, unlocked);
+   printf("   interpreted %8.1f ns/frame\n",
+         1000.0 * (best[1] - best[0]) / game.frame_count);
+   printf("   compiled    %8.1f ns/frame\n",
+         1000.0 * (best[2] - best[0]) / game.frame_count);
+   printf("%s\n", same ? "OK" : "MISMATCH");
+
+   free(ref_triggers);
+   free(eval_triggers);
+   return same ? 0 : 1;
+}